@@ -120,6 +120,11 @@ namespace cyanvne::audio
         return false;
     }
 
+    bool SoloudAudioEngine::isValidVoiceHandle(VoiceHandle handle) const
+    {
+        return handle != 0 && soloud_->isValidVoiceHandle(handle);
+    }
+
     void SoloudAudioEngine::fadeVolume(VoiceHandle handle, float target_volume, float time_seconds)
     {
         if (handle != 0 && soloud_->isValidVoiceHandle(handle))
@@ -46,6 +46,7 @@ namespace cyanvne::audio
         void setVolume(VoiceHandle handle, float volume);
         void setPaused(VoiceHandle handle, bool is_paused);
         bool getPaused(VoiceHandle handle) const;
+        bool isValidVoiceHandle(VoiceHandle handle) const;
         void fadeVolume(VoiceHandle handle, float target_volume, float time_seconds);
         void scheduleStop(VoiceHandle handle, float time_seconds);
         float getPlaybackTime(VoiceHandle handle) const;
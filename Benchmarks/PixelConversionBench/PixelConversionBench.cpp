@@ -0,0 +1,244 @@
+// Compares the pixel conversion kernels with the SDL_ConvertSurface path TextureResource used to take.
+// Every SIMD level the CPU supports is first checked byte for byte against the scalar kernels, a mismatch exits with 1.
+// Usage: CyanVNE_bench_pixel_conversion [width] [height] [iterations]
+
+#include "Platform/Algorithm/PixelConversion/PixelConversion.h"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace pixelconversion = cyanvne::platform::algorithm::pixelconversion;
+
+namespace
+{
+    double median_milliseconds(int iterations, const std::function<void()>& body)
+    {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+
+        body(); // warm up caches and lazy initialisation
+        for (int i = 0; i < iterations; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    SDL_Surface* make_random_surface(int width, int height, SDL_PixelFormat format)
+    {
+        SDL_Surface* surface = SDL_CreateSurface(width, height, format);
+        if (!surface)
+        {
+            return nullptr;
+        }
+
+        std::mt19937 rng(42);
+        auto* pixels = static_cast<uint8_t*>(surface->pixels);
+        for (size_t i = 0; i < static_cast<size_t>(surface->pitch) * height; ++i)
+        {
+            pixels[i] = static_cast<uint8_t>(rng());
+        }
+        return surface;
+    }
+
+    // What the EXTENDED loader did before: convert, then copy the converted surface for bgfx
+    void sdl_convert_and_copy(SDL_Surface* source, std::vector<uint8_t>& staging)
+    {
+        SDL_Surface* converted = SDL_ConvertSurface(source, SDL_PIXELFORMAT_RGBA32);
+        if (!converted)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> copy(static_cast<size_t>(converted->w) * converted->h * 4);
+        std::memcpy(copy.data(), converted->pixels, copy.size());
+        staging.swap(copy);
+        SDL_DestroySurface(converted);
+    }
+
+    template <typename Kernel>
+    void kernel_into_staging(SDL_Surface* source, std::vector<uint8_t>& staging, Kernel kernel)
+    {
+        const size_t width = static_cast<size_t>(source->w);
+        std::vector<uint8_t> pixels(width * source->h * 4);
+        const auto* src = static_cast<const uint8_t*>(source->pixels);
+        for (int y = 0; y < source->h; ++y)
+        {
+            kernel(src + static_cast<size_t>(y) * source->pitch, pixels.data() + y * width * 4, width);
+        }
+        staging.swap(pixels);
+    }
+
+    // Runs one conversion at level and at Scalar on the same random input, returns false on the first differing byte
+    bool matches_scalar(pixelconversion::KernelLevel level, const char* name, size_t src_bpp, size_t dst_bpp,
+                        const std::function<void(const uint8_t*, uint8_t*, size_t)>& convert)
+    {
+        std::mt19937 rng(7);
+
+        // Odd counts exercise every tail length, the offsets misalign the buffers
+        std::vector<size_t> counts;
+        for (size_t count = 0; count <= 80; ++count)
+        {
+            counts.push_back(count);
+        }
+        for (size_t count : { 127u, 129u, 255u, 257u, 1023u, 1025u, 4099u })
+        {
+            counts.push_back(count);
+        }
+
+        for (size_t count : counts)
+        {
+            for (size_t offset = 0; offset < 4; ++offset)
+            {
+                std::vector<uint8_t> src(offset + count * src_bpp);
+                for (auto& byte : src)
+                {
+                    byte = static_cast<uint8_t>(rng());
+                }
+                // Guard bytes past the end catch kernels writing beyond pixel_count
+                std::vector<uint8_t> expected(offset + count * dst_bpp + 16, 0xcd);
+                std::vector<uint8_t> actual(expected.size(), 0xcd);
+
+                pixelconversion::set_kernel_level(pixelconversion::KernelLevel::Scalar);
+                convert(src.data() + offset, expected.data() + offset, count);
+                pixelconversion::set_kernel_level(level);
+                convert(src.data() + offset, actual.data() + offset, count);
+
+                if (expected != actual)
+                {
+                    const auto mismatch = std::mismatch(expected.begin(), expected.end(), actual.begin());
+                    std::printf("MISMATCH %s %s: %zu pixels, offset %zu, byte %td (scalar %u, simd %u)\n",
+                                pixelconversion::get_kernel_level_name(level), name, count, offset,
+                                mismatch.first - expected.begin(), *mismatch.first, *mismatch.second);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool check_kernels_against_scalar()
+    {
+        using pixelconversion::KernelLevel;
+
+        const KernelLevel detected = pixelconversion::get_kernel_level();
+        bool all_match = true;
+        for (KernelLevel level : { KernelLevel::SSE2, KernelLevel::SSSE3, KernelLevel::AVX2, KernelLevel::NEON })
+        {
+            if (!pixelconversion::set_kernel_level(level))
+            {
+                continue;
+            }
+
+            bool level_matches = matches_scalar(level, "expand_rgb_to_rgba", 3, 4,
+                    [](const uint8_t* src, uint8_t* dst, size_t count) { pixelconversion::expand_rgb_to_rgba(src, dst, count, 0x7f); });
+            level_matches &= matches_scalar(level, "expand_bgr_to_rgba", 3, 4,
+                    [](const uint8_t* src, uint8_t* dst, size_t count) { pixelconversion::expand_bgr_to_rgba(src, dst, count); });
+            level_matches &= matches_scalar(level, "swizzle_bgra_to_rgba", 4, 4,
+                    [](const uint8_t* src, uint8_t* dst, size_t count) { pixelconversion::swizzle_bgra_to_rgba(src, dst, count); });
+            level_matches &= matches_scalar(level, "swizzle_bgra_to_rgba in place", 4, 4,
+                    [](const uint8_t* src, uint8_t* dst, size_t count)
+                    {
+                        std::memcpy(dst, src, count * 4);
+                        pixelconversion::swizzle_bgra_to_rgba(dst, dst, count);
+                    });
+            level_matches &= matches_scalar(level, "premultiply_alpha_rgba", 4, 4,
+                    [](const uint8_t* src, uint8_t* dst, size_t count)
+                    {
+                        std::memcpy(dst, src, count * 4);
+                        pixelconversion::premultiply_alpha_rgba(dst, count);
+                    });
+
+            std::printf("%-6s kernels %s the scalar reference\n", pixelconversion::get_kernel_level_name(level),
+                        level_matches ? "match" : "DO NOT match");
+            all_match &= level_matches;
+        }
+
+        pixelconversion::set_kernel_level(detected);
+        return all_match;
+    }
+
+    void report(const char* name, double baseline_ms, double kernel_ms, double megapixels)
+    {
+        std::printf("%-26s SDL %8.3f ms   kernel %8.3f ms   %6.2fx   (%.0f MPix/s)\n",
+                    name, baseline_ms, kernel_ms, baseline_ms / kernel_ms, megapixels / (kernel_ms / 1000.0));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 2048;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 2048;
+    const int iterations = argc > 3 ? std::atoi(argv[3]) : 21;
+    const double megapixels = static_cast<double>(width) * height / 1e6;
+
+    std::printf("Pixel conversion, %dx%d, %d iterations, kernel level %s\n", width, height, iterations,
+                pixelconversion::get_kernel_level_name(pixelconversion::get_kernel_level()));
+
+    if (!check_kernels_against_scalar())
+    {
+        return 1;
+    }
+
+    std::vector<uint8_t> staging;
+
+    if (SDL_Surface* rgb = make_random_surface(width, height, SDL_PIXELFORMAT_RGB24))
+    {
+        const double sdl_ms = median_milliseconds(iterations, [&] { sdl_convert_and_copy(rgb, staging); });
+        const double kernel_ms = median_milliseconds(iterations, [&]
+        {
+            kernel_into_staging(rgb, staging, [](const uint8_t* src, uint8_t* dst, size_t count)
+            {
+                pixelconversion::expand_rgb_to_rgba(src, dst, count);
+            });
+        });
+        report("RGB24 -> RGBA8", sdl_ms, kernel_ms, megapixels);
+        SDL_DestroySurface(rgb);
+    }
+
+    if (SDL_Surface* bgra = make_random_surface(width, height, SDL_PIXELFORMAT_BGRA32))
+    {
+        const double sdl_ms = median_milliseconds(iterations, [&] { sdl_convert_and_copy(bgra, staging); });
+        const double kernel_ms = median_milliseconds(iterations, [&]
+        {
+            kernel_into_staging(bgra, staging, [](const uint8_t* src, uint8_t* dst, size_t count)
+            {
+                pixelconversion::swizzle_bgra_to_rgba(src, dst, count);
+            });
+        });
+        report("BGRA32 -> RGBA8", sdl_ms, kernel_ms, megapixels);
+        SDL_DestroySurface(bgra);
+    }
+
+    if (SDL_Surface* rgba = make_random_surface(width, height, SDL_PIXELFORMAT_RGBA32))
+    {
+        std::vector<uint8_t> source(static_cast<uint8_t*>(rgba->pixels),
+                                    static_cast<uint8_t*>(rgba->pixels) + static_cast<size_t>(rgba->pitch) * height);
+        std::vector<uint8_t> work(source.size());
+
+        const double sdl_ms = median_milliseconds(iterations, [&]
+        {
+            SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_RGBA32, source.data(), rgba->pitch,
+                                 SDL_PIXELFORMAT_RGBA32, work.data(), rgba->pitch, false);
+        });
+        const double kernel_ms = median_milliseconds(iterations, [&]
+        {
+            std::memcpy(work.data(), source.data(), source.size());
+            pixelconversion::premultiply_alpha_rgba(work.data(), static_cast<size_t>(width) * height);
+        });
+        report("Premultiply RGBA8", sdl_ms, kernel_ms, megapixels);
+        SDL_DestroySurface(rgba);
+    }
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+// Times the CPU side of the render path on bgfx's Noop renderer, so it runs without a window or GPU.
+// Each scene is built from groups of one root sprite and three child sprites spread over eight textures.
+// Before timing, SpatialIndex queries are checked against a brute force pass over every mesh.
+// Usage: CyanVNE_bench_render [frames] [max sprites]
+
+#include "Core/Logger/Logger.h"
+#include "Runtime/Components/Components.h"
+#include "Runtime/Renderer/MeshBatchRenderer/MeshBatchRenderer.h"
+#include "Runtime/SpatialIndex/SpatialIndex.h"
+#include "Runtime/Systems/Systems.h"
+#include <bgfx/bgfx.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace runtime = cyanvne::runtime;
+namespace systems = cyanvne::ecs::systems;
+
+namespace
+{
+    constexpr uint32_t VIEW_WIDTH = 1920;
+    constexpr uint32_t VIEW_HEIGHT = 1080;
+    constexpr uint32_t TEXTURE_COUNT = 8;
+    constexpr uint32_t CHILDREN_PER_ROOT = 3;
+
+    struct StageTimes
+    {
+        std::vector<double> transform;
+        std::vector<double> render;
+        std::vector<double> frame;
+    };
+
+    double milliseconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double median(std::vector<double> samples)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    runtime::MeshComponent make_quad_mesh(float width, float height)
+    {
+        runtime::MeshComponent mesh;
+        mesh.vertices = {
+                {0.0f,  0.0f,   0.0f, 0.0f, 0.0f, 0xffffffff},
+                {width, 0.0f,   0.0f, 1.0f, 0.0f, 0xffffffff},
+                {width, height, 0.0f, 1.0f, 1.0f, 0xffffffff},
+                {0.0f,  height, 0.0f, 0.0f, 1.0f, 0xffffffff}
+        };
+        mesh.indices = { 0, 3, 2, 0, 2, 1 };
+        return mesh;
+    }
+
+    void add_sprite(entt::registry& registry, entt::entity entity, const glm::vec2& position,
+                    bgfx::TextureHandle texture, float size)
+    {
+        registry.emplace<runtime::TransformComponent>(entity, runtime::TransformComponent{ position, { 1.0f, 1.0f }, 0.0f });
+        registry.emplace<runtime::MeshComponent>(entity, make_quad_mesh(size, size));
+
+        auto& material = registry.emplace<runtime::MaterialComponent>(entity, "bench");
+        material.resource_handle.emplace<runtime::PinnedTexture>().texture_handle = texture;
+        material.load_state = runtime::MaterialComponent::LoadState::Loaded;
+    }
+
+    void build_scene(entt::registry& registry, uint32_t sprite_count, const std::vector<bgfx::TextureHandle>& textures)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(VIEW_WIDTH));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(VIEW_HEIGHT));
+        std::uniform_real_distribution<float> offset(-32.0f, 32.0f);
+
+        const auto camera = registry.create();
+        registry.emplace<runtime::TransformComponent>(camera);
+        auto& camera_component = registry.emplace<runtime::CameraComponent>(camera);
+        camera_component.projection_matrix = glm::ortho(0.0f, static_cast<float>(VIEW_WIDTH), static_cast<float>(VIEW_HEIGHT),
+                                                        0.0f, -1000.0f, 1000.0f);
+        camera_component.offscreen_size = { VIEW_WIDTH, VIEW_HEIGHT };
+
+        uint32_t created = 0;
+        while (created < sprite_count)
+        {
+            const auto root = registry.create();
+            add_sprite(registry, root, { x(rng), y(rng) }, textures[created % textures.size()], 64.0f);
+            ++created;
+
+            // Components are fetched again after each emplace, which may move the pool's storage
+            registry.emplace<runtime::HierarchyComponent>(root);
+            entt::entity previous = entt::null;
+            for (uint32_t c = 0; c < CHILDREN_PER_ROOT && created < sprite_count; ++c, ++created)
+            {
+                const auto child = registry.create();
+                add_sprite(registry, child, { offset(rng), offset(rng) }, textures[created % textures.size()], 32.0f);
+
+                auto& child_hierarchy = registry.emplace<runtime::HierarchyComponent>(child);
+                child_hierarchy.parent = root;
+                child_hierarchy.prev_sibling = previous;
+                if (previous == entt::null)
+                {
+                    registry.get<runtime::HierarchyComponent>(root).first_child = child;
+                }
+                else
+                {
+                    registry.get<runtime::HierarchyComponent>(previous).next_sibling = child;
+                }
+                previous = child;
+            }
+        }
+    }
+
+    // The textures are shared, so the pinned copies must not destroy them
+    void release_scene(entt::registry& registry)
+    {
+        for (auto [entity, material] : registry.view<runtime::MaterialComponent>().each())
+        {
+            if (auto* pinned = std::get_if<runtime::PinnedTexture>(&material.resource_handle))
+            {
+                pinned->texture_handle = BGFX_INVALID_HANDLE;
+            }
+        }
+        registry.clear();
+    }
+
+    StageTimes run_systems(entt::registry& registry, runtime::MeshBatchRenderer& renderer, int frames, uint32_t& draw_calls)
+    {
+        StageTimes times;
+        for (int i = -1; i < frames; ++i) // frame -1 warms up caches and lazy initialisation
+        {
+            auto start = std::chrono::steady_clock::now();
+            systems::TransformSystem(registry);
+            const double transform_ms = milliseconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            systems::RenderSystem(registry, renderer);
+            const double render_ms = milliseconds_since(start);
+            draw_calls = renderer.getLastDrawCallCount();
+
+            start = std::chrono::steady_clock::now();
+            bgfx::frame();
+            const double frame_ms = milliseconds_since(start);
+
+            if (i >= 0)
+            {
+                times.transform.push_back(transform_ms);
+                times.render.push_back(render_ms);
+                times.frame.push_back(frame_ms);
+            }
+        }
+        return times;
+    }
+
+    // submitSprite() straight into the batcher, without the ECS
+    StageTimes run_sprites(runtime::MeshBatchRenderer& renderer, uint32_t sprite_count,
+                           const std::vector<bgfx::TextureHandle>& textures, int frames, uint32_t& draw_calls)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(VIEW_WIDTH));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(VIEW_HEIGHT));
+        std::vector<glm::vec3> positions(sprite_count);
+        for (auto& position : positions)
+        {
+            position = { x(rng), y(rng), 0.0f };
+        }
+
+        const glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(VIEW_WIDTH), static_cast<float>(VIEW_HEIGHT),
+                                                0.0f, -1000.0f, 1000.0f);
+        const glm::mat4 view(1.0f);
+        bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(VIEW_WIDTH), static_cast<uint16_t>(VIEW_HEIGHT));
+        bgfx::setViewTransform(0, &view[0][0], &projection[0][0]);
+
+        StageTimes times;
+        for (int i = -1; i < frames; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            renderer.beginFrame();
+            renderer.begin(0, view);
+            for (uint32_t s = 0; s < sprite_count; ++s)
+            {
+                renderer.submitSprite(textures[s % textures.size()], positions[s], { 64.0f, 64.0f });
+            }
+            renderer.end();
+            const double render_ms = milliseconds_since(start);
+            draw_calls = renderer.getLastDrawCallCount();
+
+            start = std::chrono::steady_clock::now();
+            bgfx::frame();
+            const double frame_ms = milliseconds_since(start);
+
+            if (i >= 0)
+            {
+                times.render.push_back(render_ms);
+                times.frame.push_back(frame_ms);
+            }
+        }
+        return times;
+    }
+
+    // Every mesh whose transformed bounds touch the rect, in the order the render systems walk without an index
+    std::vector<entt::entity> brute_force_query(entt::registry& registry, const glm::vec4& rect)
+    {
+        std::vector<entt::entity> result;
+        for (auto [entity, mesh] : registry.view<runtime::MeshComponent>().each())
+        {
+            const auto* world_transform = registry.try_get<runtime::WorldTransformComponent>(entity);
+            if (world_transform == nullptr || mesh.vertices.empty())
+            {
+                continue;
+            }
+
+            glm::vec2 local_min(std::numeric_limits<float>::max());
+            glm::vec2 local_max(std::numeric_limits<float>::lowest());
+            for (const auto& vertex : mesh.vertices)
+            {
+                local_min = glm::min(local_min, glm::vec2(vertex.x, vertex.y));
+                local_max = glm::max(local_max, glm::vec2(vertex.x, vertex.y));
+            }
+
+            glm::vec2 world_min(std::numeric_limits<float>::max());
+            glm::vec2 world_max(std::numeric_limits<float>::lowest());
+            for (const glm::vec2 corner : { local_min, glm::vec2(local_max.x, local_min.y), local_max, glm::vec2(local_min.x, local_max.y) })
+            {
+                const glm::vec2 world = glm::vec2(world_transform->transform * glm::vec4(corner, 0.0f, 1.0f));
+                world_min = glm::min(world_min, world);
+                world_max = glm::max(world_max, world);
+            }
+
+            if (world_min.x <= rect.z && world_max.x >= rect.x && world_min.y <= rect.w && world_max.y >= rect.y)
+            {
+                result.push_back(entity);
+            }
+        }
+        return result;
+    }
+
+    // Random scenes with moves, removals and oversized meshes, the index must return the same entities in the same order
+    bool check_spatial_index_against_brute_force()
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> coordinate(-4096.0f, 4096.0f);
+        std::uniform_real_distribution<float> extent(1.0f, 256.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_int_distribution<int> percent(0, 99);
+
+        for (float cell_size : { 64.0f, 512.0f })
+        {
+            entt::registry registry;
+            runtime::SpatialIndex index(cell_size);
+            index.connect(registry);
+
+            std::vector<entt::entity> entities;
+            for (int i = 0; i < 2000; ++i)
+            {
+                const auto entity = registry.create();
+                registry.emplace<runtime::TransformComponent>(entity, runtime::TransformComponent{
+                        { coordinate(rng), coordinate(rng) }, { 1.0f, 1.0f }, angle(rng) });
+                // A few meshes span many cells and land in the oversized list
+                const float size = percent(rng) < 2 ? 4096.0f : extent(rng);
+                registry.emplace<runtime::MeshComponent>(entity, make_quad_mesh(size, extent(rng)));
+                entities.push_back(entity);
+            }
+
+            for (int round = 0; round < 8; ++round)
+            {
+                systems::TransformSystem(registry, &index);
+
+                for (int q = 0; q < 64; ++q)
+                {
+                    const float x = coordinate(rng);
+                    const float y = coordinate(rng);
+                    const float reach = q == 0 ? 1.0e9f : extent(rng) * 8.0f;
+                    const glm::vec4 rect(x - reach, y - reach, x + reach, y + reach);
+
+                    std::vector<entt::entity> indexed;
+                    index.query(rect, indexed);
+                    if (indexed != brute_force_query(registry, rect))
+                    {
+                        std::fprintf(stderr, "SpatialIndex query mismatch (cell size %.0f, round %d, query %d): %zu indexed entities\n",
+                                     cell_size, round, q, indexed.size());
+                        return false;
+                    }
+                }
+
+                // Move, remove and add meshes before the next round
+                for (auto& entity : entities)
+                {
+                    const int roll = percent(rng);
+                    if (roll < 10)
+                    {
+                        registry.patch<runtime::TransformComponent>(entity, [&](auto& transform)
+                        {
+                            transform.position = { coordinate(rng), coordinate(rng) };
+                        });
+                    }
+                    else if (roll < 13)
+                    {
+                        registry.destroy(entity);
+                        entity = registry.create();
+                        registry.emplace<runtime::TransformComponent>(entity, runtime::TransformComponent{
+                                { coordinate(rng), coordinate(rng) }, { 1.0f, 1.0f }, angle(rng) });
+                        registry.emplace<runtime::MeshComponent>(entity, make_quad_mesh(extent(rng), extent(rng)));
+                    }
+                    else if (roll < 15)
+                    {
+                        registry.remove<runtime::MeshComponent>(entity);
+                        registry.emplace<runtime::MeshComponent>(entity, make_quad_mesh(extent(rng), extent(rng)));
+                    }
+                }
+            }
+            index.disconnect();
+        }
+        return true;
+    }
+
+    void report(const char* name, uint32_t sprites, const StageTimes& times, uint32_t draw_calls)
+    {
+        std::printf("%-30s %7u   transform %8.3f ms   render %8.3f ms   bgfx::frame %8.3f ms   %6u draws\n",
+                    name, sprites, median(times.transform), median(times.render), median(times.frame), draw_calls);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 30;
+    const uint32_t max_sprites = argc > 2 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[2]))) : 100000;
+
+    cyanvne::core::GlobalLogger::LoggerConfig logger_config;
+    logger_config.console_log_level = spdlog::level::warn;
+    cyanvne::core::GlobalLogger::initUniversalCoreLogger(logger_config);
+    cyanvne::core::GlobalLogger::initUniversalClientLogger(logger_config);
+
+    // Single threaded mode, so bgfx::frame() also covers the (empty) render thread work
+    bgfx::renderFrame();
+
+    bgfx::Init init;
+    init.type = bgfx::RendererType::Noop;
+    init.resolution.width = VIEW_WIDTH;
+    init.resolution.height = VIEW_HEIGHT;
+    init.resolution.reset = BGFX_RESET_NONE;
+    // Large enough that 100k sprites stay on the transient path
+    init.limits.transientVbSize = 64 << 20;
+    init.limits.transientIbSize = 16 << 20;
+    if (!bgfx::init(init))
+    {
+        std::fprintf(stderr, "Failed to initialize bgfx with the Noop renderer\n");
+        return 1;
+    }
+
+    if (!check_spatial_index_against_brute_force())
+    {
+        bgfx::shutdown();
+        return 1;
+    }
+
+    std::vector<bgfx::TextureHandle> textures;
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        textures.push_back(bgfx::createTexture2D(64, 64, false, 1, bgfx::TextureFormat::RGBA8));
+    }
+
+    std::printf("Render path on the Noop renderer, %d frames, median per frame\n", frames);
+
+    {
+        runtime::MeshBatchRenderer renderer;
+        renderer.init();
+
+        const struct
+        {
+            const char* name;
+            runtime::MeshBatchRenderer::SubmissionMode mode;
+        } system_modes[] = {
+                { "ECS immediate", runtime::MeshBatchRenderer::SubmissionMode::Immediate },
+                { "ECS deferred", runtime::MeshBatchRenderer::SubmissionMode::Deferred }
+        };
+
+        const struct
+        {
+            const char* name;
+            runtime::MeshBatchRenderer::SpritePath path;
+        } sprite_paths[] = {
+                { "submitSprite vertices", runtime::MeshBatchRenderer::SpritePath::Vertices },
+                { "submitSprite instanced", runtime::MeshBatchRenderer::SpritePath::Instanced }
+        };
+
+        for (uint32_t sprites = 1000; sprites <= max_sprites; sprites *= 10)
+        {
+            uint32_t draw_calls = 0;
+
+            entt::registry registry;
+            build_scene(registry, sprites, textures);
+            for (const auto& system_mode : system_modes)
+            {
+                renderer.setSubmissionMode(system_mode.mode);
+                report(system_mode.name, sprites, run_systems(registry, renderer, frames, draw_calls), draw_calls);
+            }
+            release_scene(registry);
+
+            renderer.setSubmissionMode(runtime::MeshBatchRenderer::SubmissionMode::Immediate);
+            for (const auto& sprite_path : sprite_paths)
+            {
+                renderer.setSpritePath(sprite_path.path);
+                report(sprite_path.name, sprites, run_sprites(renderer, sprites, textures, frames, draw_calls), draw_calls);
+            }
+        }
+    }
+
+    for (const bgfx::TextureHandle texture : textures)
+    {
+        bgfx::destroy(texture);
+    }
+    bgfx::shutdown();
+    return 0;
+}
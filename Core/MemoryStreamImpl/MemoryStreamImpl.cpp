@@ -314,6 +314,14 @@ namespace cyanvne
                 return true;
             }
 
+            bool DynamicMemoryStreamImpl::lend_contiguous_buffer(const void*& data, uint64_t& size)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                data = data_.data();
+                size = data_.size();
+                return true;
+            }
+
             void DynamicMemoryStreamImpl::flush()
             {
                 std::lock_guard<std::mutex> lock(mutex_);
@@ -573,6 +581,14 @@ namespace cyanvne
                 return true;
             }
 
+            bool FixedSizeMemoryStreamImpl::lend_contiguous_buffer(const void*& data, uint64_t& size)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                data = data_.data();
+                size = data_.size();
+                return true;
+            }
+
             void FixedSizeMemoryStreamImpl::flush()
             {
                 std::lock_guard<std::mutex> lock(mutex_);
@@ -34,6 +34,7 @@ namespace cyanvne
                 bool boundedSeek(int64_t offset, SeekMode mode);
                 int64_t tell() override;
                 bool is_open() override;
+                bool lend_contiguous_buffer(const void*& data, uint64_t& size) override;
                 void flush() override;
                 const std::vector<uint8_t>& get_data() const;
                 std::vector<uint8_t> copyData() const;
@@ -64,6 +65,7 @@ namespace cyanvne
                 int64_t seek(int64_t offset, SeekMode mode) override;
                 int64_t tell() override;
                 bool is_open() override;
+                bool lend_contiguous_buffer(const void*& data, uint64_t& size) override;
                 void flush() override;
                 uint64_t getCapacity() const;
 
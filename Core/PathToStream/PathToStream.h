@@ -1,5 +1,7 @@
 #pragma once
 #include <Core/Stream/Stream.h>
+#include <Core/Stream/AsyncStream.h>
+#include <boost/asio/any_io_executor.hpp>
 #include <string>
 #include <memory>
 
@@ -18,6 +20,19 @@ namespace cyanvne::core
 		virtual std::shared_ptr<stream::InStreamInterface> getInStream(const std::string& path) = 0;
 		virtual std::shared_ptr<stream::OutStreamInterface> getOutStream(const std::string& path) = 0;
 
+		// Optional, providers without native positional IO return nullptr and readers fall back to seekable streams
+		virtual std::shared_ptr<stream::PositionalInStreamInterface> getPositionalInStream(const std::string& path)
+		{
+			return nullptr;
+		}
+
+		// Optional, providers without async IO return nullptr and the async getters block instead
+		virtual std::shared_ptr<stream::AsyncInStreamInterface> getAsyncInStream(const std::string& path,
+			const boost::asio::any_io_executor& executor)
+		{
+			return nullptr;
+		}
+
 		virtual ~IPathToStream() = default;
 	};
 }
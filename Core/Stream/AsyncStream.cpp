@@ -0,0 +1,51 @@
+#include "AsyncStream.h"
+#include <algorithm>
+
+cyanvne::core::stream::AsyncSubStream::AsyncSubStream(std::shared_ptr<AsyncInStreamInterface> parent, uint64_t offset, uint64_t size)
+        : parent_stream_(std::move(parent)),
+          resource_offset_(offset),
+          resource_size_(size)
+{
+}
+
+boost::asio::awaitable<size_t> cyanvne::core::stream::AsyncSubStream::async_read(void* buffer, size_t size, uint64_t offset)
+{
+    if (size == 0 || offset >= resource_size_)
+    {
+        co_return 0;
+    }
+
+    const size_t bytes_to_read = static_cast<size_t>(std::min(static_cast<uint64_t>(size), resource_size_ - offset));
+
+    co_return co_await parent_stream_->async_read(buffer, bytes_to_read, resource_offset_ + offset);
+}
+
+uint64_t cyanvne::core::stream::AsyncSubStream::size()
+{
+    return resource_size_;
+}
+
+bool cyanvne::core::stream::AsyncSubStream::is_open()
+{
+    return parent_stream_ && parent_stream_->is_open();
+}
+
+boost::asio::awaitable<size_t> cyanvne::core::stream::utils::async_read_exact(AsyncInStreamInterface& in, void* buffer,
+                                                                              size_t size, uint64_t offset)
+{
+    auto* destination = static_cast<uint8_t*>(buffer);
+    size_t total_bytes_read = 0;
+
+    while (total_bytes_read < size)
+    {
+        size_t bytes_read = co_await in.async_read(destination + total_bytes_read, size - total_bytes_read,
+                                                   offset + total_bytes_read);
+        if (bytes_read == 0)
+        {
+            break;
+        }
+        total_bytes_read += bytes_read;
+    }
+
+    co_return total_bytes_read;
+}
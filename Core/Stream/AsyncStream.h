@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <boost/asio/awaitable.hpp>
+
+namespace cyanvne
+{
+    namespace core
+    {
+        namespace stream
+        {
+            namespace asio = boost::asio;
+
+            // Thread safe, reads are positional and never share a cursor
+            class AsyncInStreamInterface
+            {
+            protected:
+                AsyncInStreamInterface() = default;
+            public:
+                AsyncInStreamInterface(const AsyncInStreamInterface&) = delete;
+                AsyncInStreamInterface& operator=(const AsyncInStreamInterface&) = delete;
+                AsyncInStreamInterface(AsyncInStreamInterface&&) = delete;
+                AsyncInStreamInterface& operator=(AsyncInStreamInterface&&) = delete;
+
+                // Reads up to size bytes starting at offset, returns 0 at end of data
+                virtual asio::awaitable<size_t> async_read(void* buffer, size_t size, uint64_t offset) = 0;
+                virtual uint64_t size() = 0;
+                virtual bool is_open() = 0;
+
+                virtual ~AsyncInStreamInterface() = default;
+            };
+
+            class AsyncSubStream : public AsyncInStreamInterface
+            {
+            private:
+                std::shared_ptr<AsyncInStreamInterface> parent_stream_;
+
+                uint64_t resource_offset_;
+                uint64_t resource_size_;
+
+            public:
+                AsyncSubStream(std::shared_ptr<AsyncInStreamInterface> parent, uint64_t offset, uint64_t size);
+
+                AsyncSubStream(const AsyncSubStream&) = delete;
+                AsyncSubStream& operator=(const AsyncSubStream&) = delete;
+                AsyncSubStream(AsyncSubStream&&) = delete;
+                AsyncSubStream& operator=(AsyncSubStream&&) = delete;
+                ~AsyncSubStream() override = default;
+
+                asio::awaitable<size_t> async_read(void* buffer, size_t size, uint64_t offset) override;
+                uint64_t size() override;
+                bool is_open() override;
+            };
+
+            namespace utils
+            {
+                // Keeps reading until size bytes arrived or the stream reports end of data
+                asio::awaitable<size_t> async_read_exact(AsyncInStreamInterface& in, void* buffer, size_t size, uint64_t offset);
+            }
+        }
+    }
+}
@@ -148,7 +148,116 @@ bool cyanvne::core::stream::SubStream::is_open()
     return parent_stream_ && parent_stream_->is_open();
 }
 
+bool cyanvne::core::stream::SubStream::lend_contiguous_buffer(const void*& data, uint64_t& size)
+{
+    const void* parent_data = nullptr;
+    uint64_t parent_size = 0;
+    if (!parent_stream_ || !parent_stream_->lend_contiguous_buffer(parent_data, parent_size))
+    {
+        return false;
+    }
+    if (resource_offset_ > parent_size || resource_size_ > parent_size - resource_offset_)
+    {
+        return false;
+    }
+
+    data = static_cast<const uint8_t*>(parent_data) + resource_offset_;
+    size = resource_size_;
+    return true;
+}
+
 uint64_t cyanvne::core::stream::SubStream::size() const
 {
     return resource_size_;
-}
\ No newline at end of file
+}
+
+size_t cyanvne::core::stream::utils::read_exact_at(cyanvne::core::stream::PositionalInStreamInterface& in, void* buffer,
+                                                   size_t size, uint64_t offset)
+{
+    auto* destination = static_cast<uint8_t*>(buffer);
+    size_t total_bytes_read = 0;
+
+    while (total_bytes_read < size)
+    {
+        size_t bytes_read = in.read_at(destination + total_bytes_read, size - total_bytes_read, offset + total_bytes_read);
+        if (bytes_read == 0)
+        {
+            break;
+        }
+        total_bytes_read += bytes_read;
+    }
+    return total_bytes_read;
+}
+
+cyanvne::core::stream::PositionalSubStream::PositionalSubStream(std::shared_ptr<PositionalInStreamInterface> parent,
+                                                                uint64_t offset, uint64_t size)
+        : parent_stream_(std::move(parent)),
+          resource_offset_(offset),
+          resource_size_(size),
+          current_position_(0)
+{
+}
+
+size_t cyanvne::core::stream::PositionalSubStream::read(void* buffer, size_t size_to_read)
+{
+    if (size_to_read == 0)
+    {
+        return 0;
+    }
+
+    const uint64_t remaining_bytes = resource_size_ - current_position_;
+    if (remaining_bytes == 0)
+    {
+        return 0;
+    }
+
+    const size_t bytes_to_read = static_cast<size_t>(std::min(static_cast<uint64_t>(size_to_read), remaining_bytes));
+
+    size_t bytes_actually_read = parent_stream_->read_at(buffer, bytes_to_read, resource_offset_ + current_position_);
+
+    current_position_ += bytes_actually_read;
+
+    return bytes_actually_read;
+}
+
+int64_t cyanvne::core::stream::PositionalSubStream::seek(int64_t offset, core::stream::SeekMode mode)
+{
+    int64_t new_pos;
+    switch (mode)
+    {
+        case core::stream::SeekMode::Begin:
+            new_pos = offset;
+            break;
+        case core::stream::SeekMode::Current:
+            new_pos = static_cast<int64_t>(current_position_) + offset;
+            break;
+        case core::stream::SeekMode::End:
+            new_pos = static_cast<int64_t>(resource_size_) + offset;
+            break;
+        default:
+            return -1;
+    }
+
+    if (new_pos < 0 || static_cast<uint64_t>(new_pos) > resource_size_)
+    {
+        return -1;
+    }
+
+    current_position_ = static_cast<uint64_t>(new_pos);
+    return static_cast<int64_t>(current_position_);
+}
+
+int64_t cyanvne::core::stream::PositionalSubStream::tell()
+{
+    return static_cast<int64_t>(current_position_);
+}
+
+bool cyanvne::core::stream::PositionalSubStream::is_open()
+{
+    return parent_stream_ && parent_stream_->is_open();
+}
+
+uint64_t cyanvne::core::stream::PositionalSubStream::size() const
+{
+    return resource_size_;
+}
@@ -32,6 +32,13 @@ namespace cyanvne
                 virtual int64_t tell() = 0;
 				virtual bool is_open() = 0;
 
+                // Exposes the whole backing storage when the stream is a view over contiguous memory.
+                // The pointer is only valid while the stream is alive and not written to.
+                virtual bool lend_contiguous_buffer(const void*& data, uint64_t& size)
+                {
+                    return false;
+                }
+
                 virtual ~InStreamInterface() = default;
 			};
 
@@ -90,6 +97,53 @@ namespace cyanvne
                 size_t read(void* buffer, size_t size_to_read) override;
                 int64_t seek(int64_t offset, core::stream::SeekMode mode) override;
 
+                int64_t tell() override;
+                bool is_open() override;
+                bool lend_contiguous_buffer(const void*& data, uint64_t& size) override;
+                uint64_t size() const;
+            };
+
+            // Thread safe, every read carries its own offset so one handle can serve concurrent readers
+            class PositionalInStreamInterface
+            {
+            protected:
+                PositionalInStreamInterface() = default;
+            public:
+                PositionalInStreamInterface(const PositionalInStreamInterface&) = delete;
+                PositionalInStreamInterface& operator=(const PositionalInStreamInterface&) = delete;
+                PositionalInStreamInterface(PositionalInStreamInterface&&) = delete;
+                PositionalInStreamInterface& operator=(PositionalInStreamInterface&&) = delete;
+
+                // Returns 0 only at end of data, read errors throw CyanVNEIOException
+                virtual size_t read_at(void* buffer, size_t size, uint64_t offset) = 0;
+                virtual uint64_t size() = 0;
+                virtual bool is_open() = 0;
+
+                virtual ~PositionalInStreamInterface() = default;
+            };
+
+            // Same as SubStream, but the cursor lives here and the shared parent is never seeked
+            class PositionalSubStream : public core::stream::InStreamInterface
+            {
+            private:
+                std::shared_ptr<PositionalInStreamInterface> parent_stream_;
+
+                uint64_t resource_offset_;
+                uint64_t resource_size_;
+                uint64_t current_position_;
+
+            public:
+                PositionalSubStream(std::shared_ptr<PositionalInStreamInterface> parent, uint64_t offset, uint64_t size);
+
+                PositionalSubStream(const PositionalSubStream&) = delete;
+                PositionalSubStream& operator=(const PositionalSubStream&) = delete;
+                PositionalSubStream(PositionalSubStream&&) = delete;
+                PositionalSubStream& operator=(PositionalSubStream&&) = delete;
+                ~PositionalSubStream() override = default;
+
+                size_t read(void* buffer, size_t size_to_read) override;
+                int64_t seek(int64_t offset, core::stream::SeekMode mode) override;
+
                 int64_t tell() override;
                 bool is_open() override;
                 uint64_t size() const;
@@ -103,6 +157,9 @@ namespace cyanvne
 
 				int64_t instream_size(InStreamInterface& in);
 				int64_t outstream_size(OutStreamInterface& out);
+
+				// Loops read_at until size bytes arrived or the stream reports end of data
+				size_t read_exact_at(PositionalInStreamInterface& in, void* buffer, size_t size, uint64_t offset);
 			}
 		}
 	}
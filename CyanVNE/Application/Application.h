@@ -11,6 +11,7 @@
 #include <string>
 #include <Core/Stream/Stream.h>
 #include <Resources/ThemeResourcesManager/ThemeResourcesManager.h>
+#include <Platform/Thread/UnifiedConcurrencyManager.h>
 #include <Runtime/GameStateManager/GameStateManager.h>
 #include <Runtime/GuiDebugState/GuiDebugState.h>
 
@@ -33,7 +34,11 @@ namespace cyanvne
 
 		std::shared_ptr<core::IPathToStream> path_to_stream_;
 
+		std::shared_ptr<platform::concurrency::UnifiedConcurrencyManager> concurrency_manager_;
+
 		std::shared_ptr<runtime::GameStateManager> game_state_manager_;
+
+		static constexpr Uint32 IDLE_WAIT_MS = 16;
 	public:
 		Application(const std::shared_ptr<core::stream::InStreamInterface>& in_stream,
 			const std::shared_ptr<core::IPathToStream>& path_to_stream) : path_to_stream_(path_to_stream)
@@ -108,20 +113,17 @@ namespace cyanvne
 			}
 
 
-			std::shared_ptr<core::stream::InStreamInterface> theme_resources_stream =
-				path_to_stream_->getInStream(app_settings_.theme_pack_path);
-			if (theme_resources_stream == nullptr)
-			{
-				core::GlobalLogger::getCoreLogger()->critical("Failed to open theme pack file");
-				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "CyanVNE FATAL Error",
-					"Failed to open theme pack file", nullptr);
-				return;
-			}
+			// IO threads serve the async pack reads, workers the decode and upload preparation
+			concurrency_manager_ = std::make_shared<platform::concurrency::UnifiedConcurrencyManager>();
 
 			try
 			{
 				std::shared_ptr<resources::ResourcesManager> theme_resources_manager =
-					std::make_shared<resources::ResourcesManager>(theme_resources_stream);
+					std::make_shared<resources::ResourcesManager>(app_settings_.theme_pack_path, path_to_stream_);
+				if (!theme_resources_manager->enableAsyncIO(concurrency_manager_->get_executor()))
+				{
+					core::GlobalLogger::getCoreLogger()->info("Theme pack provider has no async IO, using blocking reads");
+				}
 				theme_resources_ = std::make_shared<resources::ThemeResourcesManager>(theme_resources_manager,
 					app_settings_.caching.theme_caching_config.max_volatile_size,
 					window_context_->getRendererHinding()
@@ -147,16 +149,21 @@ namespace cyanvne
                 return;
             }
 
+			// The handle keeps the font pinned in the theme cache, the atlas reads it in place
+			auto font_handle = std::make_shared<resources::DataHandle>(theme_resources_->getData("built_in_font"));
+			platform::GuiContext::FontSource built_in_font{ (*font_handle)->data.data(), (*font_handle)->data.size(), font_handle };
+
 			gui_context_ = app_settings_.languages.is_enabled ?
 				platform::GuiContext::create(window_context_,
-					               theme_resources_->getData("built_in_font")->data, 30, app_settings_.languages.supported_languages)
+					               std::move(built_in_font), 30, app_settings_.languages.supported_languages)
 				:
 				platform::GuiContext::create(window_context_,
-					               theme_resources_->getData("built_in_font")->data, 30);
+					               std::move(built_in_font), 30);
 
 			event_bus_ = std::make_shared<platform::EventBus>();
 
-            game_state_manager_ = std::make_shared<runtime::GameStateManager>(window_context_, event_bus_);
+            game_state_manager_ = std::make_shared<runtime::GameStateManager>(window_context_, event_bus_,
+                                                                             nullptr, concurrency_manager_, nullptr);
 
 			game_state_manager_->pushState(std::make_unique<runtime::GuiDebugState>());
 
@@ -175,8 +182,18 @@ namespace cyanvne
 			SDL_Event e;
 			int32_t status = 1;
 
+			const std::shared_ptr<runtime::FrameDirtyTracker> dirty_tracker = game_state_manager_->getFrameDirtyTracker();
+			const std::shared_ptr<runtime::FrameProfiler> profiler = game_state_manager_->getFrameProfiler();
+			using Phase = runtime::FrameProfiler::Phase;
+
 			while (status == 1)
 			{
+				// Static frames wait for input instead of spinning, the timeout keeps scripted timers updating
+				if (!dirty_tracker->shouldRender())
+				{
+					SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
+				}
+
 				Uint64 current_time = SDL_GetTicks();
 				float delta_time = (current_time - last_time) / 1000.0f;
 
@@ -184,24 +201,59 @@ namespace cyanvne
 
 				last_time = current_time;
 
+				profiler->beginFrame();
+
+				profiler->begin(Phase::EventPump);
 				while (SDL_PollEvent(&e))
 				{
                     event_bus_->processAndPublishSDL(e, ImGui::GetIO());
+					// Input, resizes and exposes all change what ImGui or the swap chain shows
+					dirty_tracker->markDirty();
+
+					// Typed or composed text may need glyphs the atlas does not hold yet
+					if (e.type == SDL_EVENT_TEXT_INPUT && e.text.text != nullptr)
+					{
+						gui_context_->addGlyphs(e.text.text);
+					}
+					else if (e.type == SDL_EVENT_TEXT_EDITING && e.edit.text != nullptr)
+					{
+						gui_context_->addGlyphs(e.edit.text);
+					}
 
 					if (e.type == SDL_EVENT_QUIT)
 					{
 						status = 0;
 					}
 				}
+				profiler->end();
 
+				profiler->begin(Phase::DispatchEvents);
 				event_bus_->dispatchPendingEvents();
+				profiler->end();
 
+				profiler->begin(Phase::StateUpdate);
 				game_state_manager_->updateCurrentState(delta_time);
+				profiler->end();
+
+				// The previous frame stays on screen
+				if (!dirty_tracker->shouldRender())
+				{
+					profiler->endFrame(false);
+					continue;
+				}
 
+				profiler->begin(Phase::Render);
 
 				window_context_->setRenderDrawColorInt(255, 255, 255, 255);
 				window_context_->renderClear();
 
+				gui_context_->updateFontAtlas();
+				// Glyphs held back by the rebuild interval need another frame even if nothing else changes
+				if (gui_context_->hasPendingGlyphs())
+				{
+					dirty_tracker->markDirty();
+				}
+
 				ImGui_ImplSDLRenderer3_NewFrame();
 				ImGui_ImplSDL3_NewFrame();
 				ImGui::NewFrame();
@@ -209,10 +261,22 @@ namespace cyanvne
 				game_state_manager_->renderCurrentStates();
 
 
+				// Dragged widgets and blinking text cursors animate without new input
+				if (ImGui::IsAnyItemActive() || ImGui::GetIO().WantTextInput)
+				{
+					dirty_tracker->markDirty();
+				}
+
 				ImGui::Render();
 				ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), window_context_->getRendererHinding());
+				profiler->end();
 
+				profiler->begin(Phase::Present);
 				window_context_->presentRender();
+				profiler->end();
+
+				dirty_tracker->frameRendered();
+				profiler->endFrame();
 			}
 
 			core::GlobalLogger::getCoreLogger()->info("Application main loop finished.");
@@ -0,0 +1,122 @@
+#include "DistanceField.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cyanvne::platform::algorithm::distancefield
+{
+    namespace
+    {
+        constexpr float INF = 1e20f;
+
+        /**
+         * One dimensional squared distance transform of a sampled function, the lower envelope of parabolas.
+         * @param f Input samples, overwritten with the transformed values.
+         */
+        void transform_1d(float* f, uint32_t n, std::vector<float>& d, std::vector<uint32_t>& v, std::vector<float>& z)
+        {
+            d.resize(n);
+            v.resize(n);
+            z.resize(n + 1);
+
+            uint32_t k = 0;
+            v[0] = 0;
+            z[0] = -INF;
+            z[1] = INF;
+            for (uint32_t q = 1; q < n; ++q)
+            {
+                const auto intersection = [&](uint32_t p)
+                {
+                    const float fq = f[q] + static_cast<float>(q) * static_cast<float>(q);
+                    const float fp = f[p] + static_cast<float>(p) * static_cast<float>(p);
+                    return (fq - fp) / (2.0f * static_cast<float>(q) - 2.0f * static_cast<float>(p));
+                };
+
+                // z[0] is -INF and INF is far above any real intersection, so k never underflows
+                float s = intersection(v[k]);
+                while (s <= z[k])
+                {
+                    --k;
+                    s = intersection(v[k]);
+                }
+
+                ++k;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = INF;
+            }
+
+            k = 0;
+            for (uint32_t q = 0; q < n; ++q)
+            {
+                while (z[k + 1] < static_cast<float>(q))
+                {
+                    ++k;
+                }
+                const float delta = static_cast<float>(q) - static_cast<float>(v[k]);
+                d[q] = delta * delta + f[v[k]];
+            }
+            std::copy(d.begin(), d.end(), f);
+        }
+
+        // Squared distance from every pixel to the nearest seed, seeds hold 0 and the rest INF
+        void transform_2d(std::vector<float>& grid, uint32_t width, uint32_t height)
+        {
+            std::vector<float> d;
+            std::vector<uint32_t> v;
+            std::vector<float> z;
+            std::vector<float> column(height);
+
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t y = 0; y < height; ++y)
+                {
+                    column[y] = grid[y * width + x];
+                }
+                transform_1d(column.data(), height, d, v, z);
+                for (uint32_t y = 0; y < height; ++y)
+                {
+                    grid[y * width + x] = column[y];
+                }
+            }
+
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                transform_1d(grid.data() + static_cast<size_t>(y) * width, width, d, v, z);
+            }
+        }
+    }
+
+    void coverage_to_sdf(const uint8_t* coverage, uint32_t width, uint32_t height, float spread, std::vector<uint8_t>& out)
+    {
+        const size_t pixel_count = static_cast<size_t>(width) * height;
+        out.assign(pixel_count, 0);
+        if (pixel_count == 0 || coverage == nullptr)
+        {
+            return;
+        }
+
+        // Distance to the nearest inside pixel for outside pixels, and the other way around
+        std::vector<float> to_inside(pixel_count);
+        std::vector<float> to_outside(pixel_count);
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            const bool inside = coverage[i] >= 128;
+            to_inside[i] = inside ? 0.0f : INF;
+            to_outside[i] = inside ? INF : 0.0f;
+        }
+
+        transform_2d(to_inside, width, height);
+        transform_2d(to_outside, width, height);
+
+        const float scale = 127.0f / std::max(spread, std::numeric_limits<float>::epsilon());
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            // Both distances are measured to pixel centers, half a pixel puts the edge between them
+            const float distance = to_outside[i] > 0.0f
+                                           ? std::sqrt(to_outside[i]) - 0.5f
+                                           : -(std::sqrt(to_inside[i]) - 0.5f);
+            out[i] = static_cast<uint8_t>(std::clamp(128.0f + distance * scale, 0.0f, 255.0f));
+        }
+    }
+}
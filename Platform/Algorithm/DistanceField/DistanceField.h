@@ -0,0 +1,24 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include <cstdint>
+#include <vector>
+
+namespace cyanvne::platform::algorithm::distancefield
+{
+    /**
+     * Converts an 8-bit coverage mask into a signed distance field of the same size.
+     * Pixels with coverage >= 128 are inside. The output stores 128 at the edge, larger values inside and
+     * smaller values outside, clamped at spread pixels away from the edge. Leave at least spread pixels of
+     * empty border around the shape or the outer falloff is cut off.
+     * Uses an exact squared Euclidean distance transform (Felzenszwalb and Huttenlocher), O(width * height).
+     * @param coverage Row major coverage values, width * height bytes.
+     * @param width Width of the mask in pixels.
+     * @param height Height of the mask in pixels.
+     * @param spread Distance in pixels mapped to the full 0..255 range.
+     * @param out Receives width * height bytes.
+     */
+    void coverage_to_sdf(const uint8_t* coverage, uint32_t width, uint32_t height, float spread, std::vector<uint8_t>& out);
+}
+
+#endif //DISTANCEFIELD_H
@@ -0,0 +1,449 @@
+#include "PixelConversion.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CYANVNE_PIXEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define CYANVNE_PIXEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// SSE2 is the x86-64 baseline, wider kernels are compiled per function and picked at runtime
+#if defined(__GNUC__) || defined(__clang__)
+#define CYANVNE_PIXEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CYANVNE_PIXEL_TARGET(isa)
+#endif
+
+namespace cyanvne::platform::algorithm::pixelconversion
+{
+    namespace
+    {
+        // x * a / 255, rounded, for x, a in [0, 255]
+        inline uint8_t div255(uint32_t x)
+        {
+            x += 128;
+            return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+        }
+
+        void expand_scalar(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha, bool bgr)
+        {
+            const int r = bgr ? 2 : 0;
+            const int b = bgr ? 0 : 2;
+            for (size_t i = 0; i < pixel_count; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 3 + r];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + b];
+                dst[i * 4 + 3] = alpha;
+            }
+        }
+
+        void swizzle_scalar(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+        {
+            for (size_t i = 0; i < pixel_count; ++i)
+            {
+                const uint8_t b = src[i * 4 + 0];
+                const uint8_t g = src[i * 4 + 1];
+                const uint8_t r = src[i * 4 + 2];
+                const uint8_t a = src[i * 4 + 3];
+                dst[i * 4 + 0] = r;
+                dst[i * 4 + 1] = g;
+                dst[i * 4 + 2] = b;
+                dst[i * 4 + 3] = a;
+            }
+        }
+
+        void premultiply_scalar(uint8_t* pixels, size_t pixel_count)
+        {
+            for (size_t i = 0; i < pixel_count; ++i)
+            {
+                uint8_t* p = pixels + i * 4;
+                const uint32_t a = p[3];
+                p[0] = div255(p[0] * a);
+                p[1] = div255(p[1] * a);
+                p[2] = div255(p[2] * a);
+            }
+        }
+
+#if defined(CYANVNE_PIXEL_X86)
+        bool cpu_has_ssse3()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[2] & (1 << 9)) != 0;
+#else
+            return __builtin_cpu_supports("ssse3");
+#endif
+        }
+
+        bool cpu_has_avx2()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            if (!os_saves_ymm)
+            {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        void swizzle_sse2(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+        {
+            const __m128i ga_mask = _mm_set1_epi32(static_cast<int>(0xff00ff00u));
+            const __m128i rb_mask = _mm_set1_epi32(0x00ff00ff);
+
+            size_t i = 0;
+            for (; i + 4 <= pixel_count; i += 4)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                const __m128i rb = _mm_and_si128(v, rb_mask);
+                const __m128i swapped = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_and_si128(v, ga_mask), swapped));
+            }
+            swizzle_scalar(src + i * 4, dst + i * 4, pixel_count - i);
+        }
+
+        void premultiply_sse2(uint8_t* pixels, size_t pixel_count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(128);
+            // Alpha is multiplied by 255 so it survives the division unchanged
+            const __m128i alpha_lanes = _mm_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0);
+
+            size_t i = 0;
+            for (; i + 4 <= pixel_count; i += 4)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+                __m128i lo = _mm_unpacklo_epi8(v, zero);
+                __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+                const __m128i alpha_lo = _mm_or_si128(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xff), 0xff), alpha_lanes);
+                const __m128i alpha_hi = _mm_or_si128(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xff), 0xff), alpha_lanes);
+
+                lo = _mm_add_epi16(_mm_mullo_epi16(lo, alpha_lo), round);
+                hi = _mm_add_epi16(_mm_mullo_epi16(hi, alpha_hi), round);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i * 4), _mm_packus_epi16(lo, hi));
+            }
+            premultiply_scalar(pixels + i * 4, pixel_count - i);
+        }
+
+        CYANVNE_PIXEL_TARGET("ssse3")
+        void expand_ssse3(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha, bool bgr)
+        {
+            const __m128i shuffle = bgr
+                    ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                    : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const __m128i alpha_bits = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+            // Each load reads 16 bytes for 12 bytes of pixels, stop early enough to stay in bounds
+            size_t i = 0;
+            for (; i + 6 <= pixel_count; i += 4)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha_bits));
+            }
+            expand_scalar(src + i * 3, dst + i * 4, pixel_count - i, alpha, bgr);
+        }
+
+        CYANVNE_PIXEL_TARGET("ssse3")
+        void swizzle_ssse3(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+        {
+            const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            size_t i = 0;
+            for (; i + 4 <= pixel_count; i += 4)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, shuffle));
+            }
+            swizzle_scalar(src + i * 4, dst + i * 4, pixel_count - i);
+        }
+
+        CYANVNE_PIXEL_TARGET("avx2")
+        void expand_avx2(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha, bool bgr)
+        {
+            const __m256i shuffle = bgr
+                    ? _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                       2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                    : _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                       0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const __m256i alpha_bits = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+            // Two 16 byte loads, 12 bytes apart, feed the two 128-bit lanes
+            size_t i = 0;
+            for (; i + 10 <= pixel_count; i += 8)
+            {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 12));
+                const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4),
+                                    _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha_bits));
+            }
+            expand_ssse3(src + i * 3, dst + i * 4, pixel_count - i, alpha, bgr);
+        }
+
+        CYANVNE_PIXEL_TARGET("avx2")
+        void swizzle_avx2(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+        {
+            const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                     2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            size_t i = 0;
+            for (; i + 8 <= pixel_count; i += 8)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, shuffle));
+            }
+            swizzle_ssse3(src + i * 4, dst + i * 4, pixel_count - i);
+        }
+
+        CYANVNE_PIXEL_TARGET("avx2")
+        void premultiply_avx2(uint8_t* pixels, size_t pixel_count)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i round = _mm256_set1_epi16(128);
+            const __m256i alpha_lanes = _mm256_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0);
+
+            size_t i = 0;
+            for (; i + 8 <= pixel_count; i += 8)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i * 4));
+                __m256i lo = _mm256_unpacklo_epi8(v, zero);
+                __m256i hi = _mm256_unpackhi_epi8(v, zero);
+
+                const __m256i alpha_lo = _mm256_or_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xff), 0xff), alpha_lanes);
+                const __m256i alpha_hi = _mm256_or_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xff), 0xff), alpha_lanes);
+
+                lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alpha_lo), round);
+                hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, alpha_hi), round);
+                lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+                hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+                // unpack and pack both work per 128-bit lane, so the pixel order is preserved
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i * 4), _mm256_packus_epi16(lo, hi));
+            }
+            premultiply_sse2(pixels + i * 4, pixel_count - i);
+        }
+#endif
+
+#if defined(CYANVNE_PIXEL_NEON)
+        void expand_neon(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha, bool bgr)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixel_count; i += 16)
+            {
+                const uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+                uint8x16x4_t rgba;
+                rgba.val[0] = bgr ? rgb.val[2] : rgb.val[0];
+                rgba.val[1] = rgb.val[1];
+                rgba.val[2] = bgr ? rgb.val[0] : rgb.val[2];
+                rgba.val[3] = vdupq_n_u8(alpha);
+                vst4q_u8(dst + i * 4, rgba);
+            }
+            expand_scalar(src + i * 3, dst + i * 4, pixel_count - i, alpha, bgr);
+        }
+
+        void swizzle_neon(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixel_count; i += 16)
+            {
+                uint8x16x4_t v = vld4q_u8(src + i * 4);
+                const uint8x16_t b = v.val[0];
+                v.val[0] = v.val[2];
+                v.val[2] = b;
+                vst4q_u8(dst + i * 4, v);
+            }
+            swizzle_scalar(src + i * 4, dst + i * 4, pixel_count - i);
+        }
+
+        inline uint8x8_t mul_div255_neon(uint8x8_t x, uint8x8_t a)
+        {
+            const uint16x8_t product = vmull_u8(x, a);
+            return vraddhn_u16(product, vrshrq_n_u16(product, 8));
+        }
+
+        void premultiply_neon(uint8_t* pixels, size_t pixel_count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixel_count; i += 16)
+            {
+                uint8x16x4_t v = vld4q_u8(pixels + i * 4);
+                for (int c = 0; c < 3; ++c)
+                {
+                    v.val[c] = vcombine_u8(mul_div255_neon(vget_low_u8(v.val[c]), vget_low_u8(v.val[3])),
+                                           mul_div255_neon(vget_high_u8(v.val[c]), vget_high_u8(v.val[3])));
+                }
+                vst4q_u8(pixels + i * 4, v);
+            }
+            premultiply_scalar(pixels + i * 4, pixel_count - i);
+        }
+#endif
+
+        KernelLevel detect_kernel_level()
+        {
+#if defined(CYANVNE_PIXEL_X86)
+            if (cpu_has_avx2())
+            {
+                return KernelLevel::AVX2;
+            }
+            if (cpu_has_ssse3())
+            {
+                return KernelLevel::SSSE3;
+            }
+            return KernelLevel::SSE2;
+#elif defined(CYANVNE_PIXEL_NEON)
+            return KernelLevel::NEON;
+#else
+            return KernelLevel::Scalar;
+#endif
+        }
+
+        void expand_dispatch(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha, bool bgr)
+        {
+            switch (get_kernel_level())
+            {
+#if defined(CYANVNE_PIXEL_X86)
+            case KernelLevel::AVX2:
+                expand_avx2(src, dst, pixel_count, alpha, bgr);
+                return;
+            case KernelLevel::SSSE3:
+                expand_ssse3(src, dst, pixel_count, alpha, bgr);
+                return;
+#elif defined(CYANVNE_PIXEL_NEON)
+            case KernelLevel::NEON:
+                expand_neon(src, dst, pixel_count, alpha, bgr);
+                return;
+#endif
+            default:
+                expand_scalar(src, dst, pixel_count, alpha, bgr);
+                return;
+            }
+        }
+    }
+
+    namespace
+    {
+        KernelLevel detected_kernel_level()
+        {
+            static const KernelLevel level = detect_kernel_level();
+            return level;
+        }
+
+        std::atomic<KernelLevel>& active_kernel_level()
+        {
+            static std::atomic<KernelLevel> level{ detected_kernel_level() };
+            return level;
+        }
+    }
+
+    KernelLevel get_kernel_level()
+    {
+        return active_kernel_level().load(std::memory_order_relaxed);
+    }
+
+    bool set_kernel_level(KernelLevel level)
+    {
+        const KernelLevel detected = detected_kernel_level();
+        bool supported = level == KernelLevel::Scalar || level == detected;
+#if defined(CYANVNE_PIXEL_X86)
+        // The x86 levels are cumulative
+        supported = supported || (level != KernelLevel::NEON && level <= detected);
+#endif
+        if (supported)
+        {
+            active_kernel_level().store(level, std::memory_order_relaxed);
+        }
+        return supported;
+    }
+
+    const char* get_kernel_level_name(KernelLevel level)
+    {
+        switch (level)
+        {
+        case KernelLevel::SSE2:
+            return "SSE2";
+        case KernelLevel::SSSE3:
+            return "SSSE3";
+        case KernelLevel::AVX2:
+            return "AVX2";
+        case KernelLevel::NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+        }
+    }
+
+    void expand_rgb_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha)
+    {
+        expand_dispatch(src, dst, pixel_count, alpha, false);
+    }
+
+    void expand_bgr_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha)
+    {
+        expand_dispatch(src, dst, pixel_count, alpha, true);
+    }
+
+    void swizzle_bgra_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count)
+    {
+        switch (get_kernel_level())
+        {
+#if defined(CYANVNE_PIXEL_X86)
+        case KernelLevel::AVX2:
+            swizzle_avx2(src, dst, pixel_count);
+            return;
+        case KernelLevel::SSSE3:
+            swizzle_ssse3(src, dst, pixel_count);
+            return;
+        case KernelLevel::SSE2:
+            swizzle_sse2(src, dst, pixel_count);
+            return;
+#elif defined(CYANVNE_PIXEL_NEON)
+        case KernelLevel::NEON:
+            swizzle_neon(src, dst, pixel_count);
+            return;
+#endif
+        default:
+            swizzle_scalar(src, dst, pixel_count);
+            return;
+        }
+    }
+
+    void premultiply_alpha_rgba(uint8_t* pixels, size_t pixel_count)
+    {
+        switch (get_kernel_level())
+        {
+#if defined(CYANVNE_PIXEL_X86)
+        case KernelLevel::AVX2:
+            premultiply_avx2(pixels, pixel_count);
+            return;
+        case KernelLevel::SSSE3:
+        case KernelLevel::SSE2:
+            premultiply_sse2(pixels, pixel_count);
+            return;
+#elif defined(CYANVNE_PIXEL_NEON)
+        case KernelLevel::NEON:
+            premultiply_neon(pixels, pixel_count);
+            return;
+#endif
+        default:
+            premultiply_scalar(pixels, pixel_count);
+            return;
+        }
+    }
+}
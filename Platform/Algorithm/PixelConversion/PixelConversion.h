@@ -0,0 +1,59 @@
+#ifndef PIXELCONVERSION_H
+#define PIXELCONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cyanvne::platform::algorithm::pixelconversion
+{
+    enum class KernelLevel
+    {
+        Scalar,
+        SSE2,
+        SSSE3,
+        AVX2,
+        NEON
+    };
+
+    /**
+     * Widest kernel set usable on this CPU, detected once at first use.
+     * Every conversion below dispatches on it, so callers never pick an ISA themselves.
+     */
+    KernelLevel get_kernel_level();
+    const char* get_kernel_level_name(KernelLevel level);
+
+    /**
+     * Switches every conversion to a narrower kernel set, used to check the SIMD kernels against the scalar ones.
+     * @return false, leaving the level unchanged, if this CPU cannot run the requested kernels.
+     */
+    bool set_kernel_level(KernelLevel level);
+
+    /**
+     * Expands packed 24-bit pixels to 32-bit RGBA.
+     * @param src Source pixels, 3 bytes each in R, G, B order.
+     * @param dst Destination, 4 bytes per pixel. Must not overlap src.
+     * @param pixel_count Number of pixels to convert.
+     * @param alpha Value written to every alpha channel.
+     */
+    void expand_rgb_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha = 0xff);
+
+    // Same as expand_rgb_to_rgba for sources in B, G, R order
+    void expand_bgr_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count, uint8_t alpha = 0xff);
+
+    /**
+     * Swaps the R and B channels of 32-bit pixels, turning BGRA into RGBA and back.
+     * @param src Source pixels. May equal dst for an in-place swap.
+     * @param dst Destination pixels.
+     * @param pixel_count Number of pixels to convert.
+     */
+    void swizzle_bgra_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count);
+
+    /**
+     * Multiplies the color channels of RGBA pixels by their alpha, rounding like x * a / 255.
+     * @param pixels RGBA pixels, converted in place.
+     * @param pixel_count Number of pixels to convert.
+     */
+    void premultiply_alpha_rgba(uint8_t* pixels, size_t pixel_count);
+}
+
+#endif //PIXELCONVERSION_H
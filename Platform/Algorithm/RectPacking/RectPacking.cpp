@@ -0,0 +1,136 @@
+#include "RectPacking.h"
+#include <algorithm>
+#include <limits>
+
+namespace cyanvne::platform::algorithm::rectpacking
+{
+    SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+        : width_(width), height_(height)
+    {
+        reset();
+    }
+
+    void SkylinePacker::reset()
+    {
+        skyline_.clear();
+        skyline_.push_back({ 0, 0, width_ });
+        used_area_ = 0;
+    }
+
+    std::optional<uint32_t> SkylinePacker::fitAt(size_t index, uint32_t rect_width, uint32_t rect_height) const
+    {
+        const uint32_t x = skyline_[index].x;
+        if (x + rect_width > width_)
+        {
+            return std::nullopt;
+        }
+
+        uint32_t y = 0;
+        uint32_t remaining = rect_width;
+        for (size_t i = index; remaining > 0; ++i)
+        {
+            if (i >= skyline_.size())
+            {
+                return std::nullopt;
+            }
+
+            y = std::max(y, skyline_[i].y);
+            if (y + rect_height > height_)
+            {
+                return std::nullopt;
+            }
+
+            remaining = skyline_[i].width >= remaining ? 0 : remaining - skyline_[i].width;
+        }
+        return y;
+    }
+
+    std::optional<PackedRect> SkylinePacker::insert(uint32_t rect_width, uint32_t rect_height)
+    {
+        if (rect_width == 0 || rect_height == 0 || rect_width > width_ || rect_height > height_)
+        {
+            return std::nullopt;
+        }
+
+        size_t best_index = std::numeric_limits<size_t>::max();
+        uint32_t best_top = std::numeric_limits<uint32_t>::max();
+        uint32_t best_width = std::numeric_limits<uint32_t>::max();
+        PackedRect best{};
+
+        for (size_t i = 0; i < skyline_.size(); ++i)
+        {
+            std::optional<uint32_t> y = fitAt(i, rect_width, rect_height);
+            if (!y)
+            {
+                continue;
+            }
+
+            // Bottom-left rule, ties broken by the narrower segment to keep the skyline flat
+            const uint32_t top = *y + rect_height;
+            if (top < best_top || (top == best_top && skyline_[i].width < best_width))
+            {
+                best_index = i;
+                best_top = top;
+                best_width = skyline_[i].width;
+                best = { skyline_[i].x, *y, rect_width, rect_height };
+            }
+        }
+
+        if (best_index == std::numeric_limits<size_t>::max())
+        {
+            return std::nullopt;
+        }
+
+        addLevel(best_index, best);
+        used_area_ += static_cast<uint64_t>(rect_width) * rect_height;
+        return best;
+    }
+
+    void SkylinePacker::addLevel(size_t index, const PackedRect& rect)
+    {
+        skyline_.insert(skyline_.begin() + static_cast<std::ptrdiff_t>(index),
+                        { rect.x, rect.y + rect.height, rect.width });
+
+        // Shrink or drop the segments now covered by the new one
+        for (size_t i = index + 1; i < skyline_.size(); )
+        {
+            const SkylineNode& previous = skyline_[i - 1];
+            SkylineNode& node = skyline_[i];
+            const uint32_t previous_end = previous.x + previous.width;
+            if (node.x >= previous_end)
+            {
+                break;
+            }
+
+            const uint32_t shrink = previous_end - node.x;
+            if (node.width <= shrink)
+            {
+                skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            node.x += shrink;
+            node.width -= shrink;
+            break;
+        }
+
+        // Merge neighbours at the same height
+        for (size_t i = 0; i + 1 < skyline_.size(); )
+        {
+            if (skyline_[i].y == skyline_[i + 1].y)
+            {
+                skyline_[i].width += skyline_[i + 1].width;
+                skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    float SkylinePacker::getOccupancy() const
+    {
+        const uint64_t total = static_cast<uint64_t>(width_) * height_;
+        return total == 0 ? 0.0f : static_cast<float>(static_cast<double>(used_area_) / static_cast<double>(total));
+    }
+}
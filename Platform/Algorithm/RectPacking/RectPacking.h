@@ -0,0 +1,67 @@
+#ifndef RECTPACKING_H
+#define RECTPACKING_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace cyanvne::platform::algorithm::rectpacking
+{
+    struct PackedRect
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    /**
+     * Online bottom-left skyline packer.
+     * Rectangles are placed one at a time and never moved, which suits atlases that are
+     * filled while rendering. Freed space is only reclaimed by reset().
+     */
+    class SkylinePacker
+    {
+    private:
+        struct SkylineNode
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        uint32_t width_;
+        uint32_t height_;
+        uint64_t used_area_ = 0;
+        std::vector<SkylineNode> skyline_;
+
+        /**
+         * Finds the lowest y at which a rect of the given size fits when its left edge sits on node index.
+         * @return The y coordinate, or nullopt if the rect does not fit there.
+         */
+        std::optional<uint32_t> fitAt(size_t index, uint32_t rect_width, uint32_t rect_height) const;
+        void addLevel(size_t index, const PackedRect& rect);
+
+    public:
+        SkylinePacker(uint32_t width, uint32_t height);
+
+        /**
+         * Reserves space for a rectangle.
+         * @param rect_width Width in pixels, including any padding the caller needs.
+         * @param rect_height Height in pixels, including any padding the caller needs.
+         * @return Placement of the rectangle, or nullopt if the bin is full.
+         */
+        std::optional<PackedRect> insert(uint32_t rect_width, uint32_t rect_height);
+
+        // Forgets every placed rectangle
+        void reset();
+
+        uint32_t getWidth() const { return width_; }
+        uint32_t getHeight() const { return height_; }
+
+        // Fraction of the bin covered by placed rectangles, in [0, 1]
+        float getOccupancy() const;
+    };
+}
+
+#endif //RECTPACKING_H
@@ -0,0 +1,205 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cyanvne::platform::algorithm::spatialgrid
+{
+    UniformGrid::UniformGrid(float cell_size, uint32_t max_cells_per_item)
+        : cell_size_(cell_size > 0.0f ? cell_size : 1.0f),
+          max_cells_per_item_(std::max<uint32_t>(1, max_cells_per_item))
+    {  }
+
+    namespace
+    {
+        // Unbounded query areas would overflow the cell coordinates
+        constexpr float MAX_CELL = static_cast<float>(1 << 30);
+
+        int32_t to_cell(float coordinate, float cell_size)
+        {
+            return static_cast<int32_t>(std::clamp(std::floor(coordinate / cell_size), -MAX_CELL, MAX_CELL));
+        }
+    }
+
+    UniformGrid::CellRange UniformGrid::cellRange(const Bounds& bounds) const
+    {
+        return {
+            to_cell(bounds.min_x, cell_size_),
+            to_cell(bounds.min_y, cell_size_),
+            to_cell(bounds.max_x, cell_size_),
+            to_cell(bounds.max_y, cell_size_)
+        };
+    }
+
+    uint64_t UniformGrid::cellKey(int32_t x, int32_t y)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+    }
+
+    void UniformGrid::link(uint64_t id, const Item& item)
+    {
+        if (item.oversized)
+        {
+            oversized_.push_back(id);
+            return;
+        }
+
+        for (int32_t y = item.cells.min_y; y <= item.cells.max_y; ++y)
+        {
+            for (int32_t x = item.cells.min_x; x <= item.cells.max_x; ++x)
+            {
+                cells_[cellKey(x, y)].push_back(id);
+            }
+        }
+    }
+
+    void UniformGrid::unlink(uint64_t id, const Item& item)
+    {
+        const auto erase_id = [id](std::vector<uint64_t>& ids)
+        {
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end())
+            {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        };
+
+        if (item.oversized)
+        {
+            erase_id(oversized_);
+            return;
+        }
+
+        for (int32_t y = item.cells.min_y; y <= item.cells.max_y; ++y)
+        {
+            for (int32_t x = item.cells.min_x; x <= item.cells.max_x; ++x)
+            {
+                auto cell = cells_.find(cellKey(x, y));
+                if (cell == cells_.end())
+                {
+                    continue;
+                }
+
+                erase_id(cell->second);
+                if (cell->second.empty())
+                {
+                    cells_.erase(cell);
+                }
+            }
+        }
+    }
+
+    void UniformGrid::update(uint64_t id, const Bounds& bounds)
+    {
+        const CellRange cells = cellRange(bounds);
+        const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(cells.max_x) - cells.min_x + 1) *
+                              static_cast<uint64_t>(static_cast<int64_t>(cells.max_y) - cells.min_y + 1);
+        const bool oversized = span > max_cells_per_item_;
+
+        auto it = items_.find(id);
+        if (it != items_.end())
+        {
+            Item& item = it->second;
+            item.bounds = bounds;
+            if (item.oversized == oversized && (oversized || item.cells == cells))
+            {
+                return;
+            }
+
+            unlink(id, item);
+            item.cells = cells;
+            item.oversized = oversized;
+            link(id, item);
+            return;
+        }
+
+        const Item item{ bounds, cells, oversized };
+        items_.emplace(id, item);
+        link(id, item);
+    }
+
+    void UniformGrid::remove(uint64_t id)
+    {
+        auto it = items_.find(id);
+        if (it == items_.end())
+        {
+            return;
+        }
+
+        unlink(id, it->second);
+        items_.erase(it);
+    }
+
+    void UniformGrid::clear()
+    {
+        cells_.clear();
+        items_.clear();
+        oversized_.clear();
+    }
+
+    bool UniformGrid::contains(uint64_t id) const
+    {
+        return items_.contains(id);
+    }
+
+    void UniformGrid::query(const Bounds& area, std::vector<uint64_t>& out) const
+    {
+        const size_t first = out.size();
+        const auto accept = [&](uint64_t id)
+        {
+            if (items_.at(id).bounds.intersects(area))
+            {
+                out.push_back(id);
+            }
+        };
+
+        for (uint64_t id : oversized_)
+        {
+            accept(id);
+        }
+
+        const CellRange cells = cellRange(area);
+        const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(cells.max_x) - cells.min_x + 1) *
+                              static_cast<uint64_t>(static_cast<int64_t>(cells.max_y) - cells.min_y + 1);
+
+        if (span > cells_.size())
+        {
+            // The area covers more cells than are occupied, walking the occupied ones is cheaper
+            for (const auto& [key, ids] : cells_)
+            {
+                const int32_t x = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+                const int32_t y = static_cast<int32_t>(static_cast<uint32_t>(key));
+                if (x < cells.min_x || x > cells.max_x || y < cells.min_y || y > cells.max_y)
+                {
+                    continue;
+                }
+                for (uint64_t id : ids)
+                {
+                    accept(id);
+                }
+            }
+        }
+        else
+        {
+            for (int32_t y = cells.min_y; y <= cells.max_y; ++y)
+            {
+                for (int32_t x = cells.min_x; x <= cells.max_x; ++x)
+                {
+                    auto cell = cells_.find(cellKey(x, y));
+                    if (cell == cells_.end())
+                    {
+                        continue;
+                    }
+                    for (uint64_t id : cell->second)
+                    {
+                        accept(id);
+                    }
+                }
+            }
+        }
+
+        // Items spanning several cells show up once per cell, sorting also makes the order deterministic
+        std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+        out.erase(std::unique(out.begin() + static_cast<std::ptrdiff_t>(first), out.end()), out.end());
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cyanvne::platform::algorithm::spatialgrid
+{
+    struct Bounds
+    {
+        float min_x;
+        float min_y;
+        float max_x;
+        float max_y;
+
+        bool intersects(const Bounds& other) const
+        {
+            return min_x <= other.max_x && max_x >= other.min_x &&
+                   min_y <= other.max_y && max_y >= other.min_y;
+        }
+    };
+
+    /**
+     * Uniform grid of axis aligned bounds, keyed by caller supplied ids.
+     * Items are registered in every cell they overlap. Moving an item within the same cells
+     * only rewrites its bounds, so mostly static scenes update in O(1) per item.
+     * Items spanning more than max_cells_per_item cells are kept in a separate list that every query scans.
+     */
+    class UniformGrid
+    {
+    private:
+        struct CellRange
+        {
+            int32_t min_x;
+            int32_t min_y;
+            int32_t max_x;
+            int32_t max_y;
+
+            bool operator==(const CellRange& other) const = default;
+        };
+
+        struct Item
+        {
+            Bounds bounds;
+            CellRange cells;
+            bool oversized;
+        };
+
+        float cell_size_;
+        uint32_t max_cells_per_item_;
+        std::unordered_map<uint64_t, std::vector<uint64_t>> cells_;
+        std::unordered_map<uint64_t, Item> items_;
+        std::vector<uint64_t> oversized_;
+
+        CellRange cellRange(const Bounds& bounds) const;
+        static uint64_t cellKey(int32_t x, int32_t y);
+        void link(uint64_t id, const Item& item);
+        void unlink(uint64_t id, const Item& item);
+
+    public:
+        explicit UniformGrid(float cell_size = 512.0f, uint32_t max_cells_per_item = 64);
+
+        // Inserts the item or moves it to new bounds
+        void update(uint64_t id, const Bounds& bounds);
+        void remove(uint64_t id);
+        void clear();
+
+        bool contains(uint64_t id) const;
+        size_t size() const { return items_.size(); }
+
+        /**
+         * Appends the ids of all items whose bounds intersect the area, each id at most once.
+         * Safe to call from several threads as long as nothing updates the grid meanwhile.
+         */
+        void query(const Bounds& area, std::vector<uint64_t>& out) const;
+    };
+}
+
+#endif //SPATIALGRID_H
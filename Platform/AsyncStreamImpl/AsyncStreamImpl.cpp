@@ -0,0 +1,109 @@
+#include "AsyncStreamImpl.h"
+#include "Core/Logger/Logger.h"
+#include <exception>
+
+cyanvne::platform::AsyncFileInStreamImpl::AsyncFileInStreamImpl(asio::any_io_executor executor)
+	: executor_(std::move(executor))
+#if defined(BOOST_ASIO_HAS_FILE)
+	, file_(executor_)
+#endif
+{  }
+
+std::shared_ptr<cyanvne::platform::AsyncFileInStreamImpl> cyanvne::platform::AsyncFileInStreamImpl::createFromBinaryFile(
+	const std::string& path, const asio::any_io_executor& executor)
+{
+	auto impl = std::make_shared<AsyncFileInStreamImpl>(executor);
+	if (!impl->open(path))
+	{
+		core::GlobalLogger::getCoreLogger()->warn("AsyncFileInStreamImpl: Failed to open '{}'", path);
+		return nullptr;
+	}
+	return impl;
+}
+
+bool cyanvne::platform::AsyncFileInStreamImpl::open(const std::string& path)
+{
+#if defined(BOOST_ASIO_HAS_FILE)
+	boost::system::error_code ec;
+	file_.open(path, asio::file_base::read_only, ec);
+	if (ec)
+	{
+		return false;
+	}
+	size_ = file_.size(ec);
+	return !ec;
+#else
+	reader_ = PositionalFileInStreamImpl::createFromBinaryFile(path);
+	if (!reader_)
+	{
+		return false;
+	}
+	size_ = reader_->size();
+	return true;
+#endif
+}
+
+boost::asio::awaitable<size_t> cyanvne::platform::AsyncFileInStreamImpl::async_read(void* buffer, size_t size, uint64_t offset)
+{
+	if (size == 0 || offset >= size_)
+	{
+		co_return 0;
+	}
+
+#if defined(BOOST_ASIO_HAS_FILE)
+	// The completion resumes the coroutine on its own executor, callers continue where they awaited
+	boost::system::error_code ec;
+	size_t bytes_read = co_await file_.async_read_some_at(offset, asio::buffer(buffer, size),
+		asio::redirect_error(asio::use_awaitable, ec));
+	if (ec && ec != asio::error::eof)
+	{
+		throw boost::system::system_error(ec);
+	}
+	co_return bytes_read;
+#else
+	// Hop onto the IO pool so the blocking read never runs on the awaiting thread's executor, and back
+	// afterwards so callers continue on their own executor, as with the native file path
+	const asio::any_io_executor caller = co_await asio::this_coro::executor;
+	co_await asio::post(asio::bind_executor(executor_, asio::use_awaitable));
+
+	size_t bytes_read = 0;
+	std::exception_ptr exception;
+	try
+	{
+		bytes_read = reader_->read_at(buffer, size, offset);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	co_await asio::post(asio::bind_executor(caller, asio::use_awaitable));
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+	co_return bytes_read;
+#endif
+}
+
+uint64_t cyanvne::platform::AsyncFileInStreamImpl::size()
+{
+	return size_;
+}
+
+bool cyanvne::platform::AsyncFileInStreamImpl::is_open()
+{
+#if defined(BOOST_ASIO_HAS_FILE)
+	return file_.is_open();
+#else
+	return reader_ && reader_->is_open();
+#endif
+}
+
+cyanvne::platform::AsyncFileInStreamImpl::~AsyncFileInStreamImpl()
+{
+#if defined(BOOST_ASIO_HAS_FILE)
+	boost::system::error_code ec;
+	file_.close(ec);
+#endif
+}
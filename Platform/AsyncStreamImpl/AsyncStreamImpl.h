@@ -0,0 +1,52 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <bx/platform.h>
+#include <Core/Stream/AsyncStream.h>
+#include <Platform/PositionalStreamImpl/PositionalStreamImpl.h>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace cyanvne
+{
+	namespace platform
+	{
+		namespace asio = boost::asio;
+
+		// Positional file reader running on an asio executor, normally the UCM IO context.
+		// Uses asio's native file support (io_uring / IOCP) when available,
+		// otherwise a PositionalFileInStreamImpl read posted to the executor.
+		class AsyncFileInStreamImpl : public core::stream::AsyncInStreamInterface
+		{
+		private:
+			asio::any_io_executor executor_;
+			uint64_t size_ = 0;
+
+#if defined(BOOST_ASIO_HAS_FILE)
+			asio::random_access_file file_;
+#else
+			std::shared_ptr<PositionalFileInStreamImpl> reader_;
+#endif
+
+			bool open(const std::string& path);
+		public:
+			explicit AsyncFileInStreamImpl(asio::any_io_executor executor);
+
+			AsyncFileInStreamImpl(const AsyncFileInStreamImpl&) = delete;
+			AsyncFileInStreamImpl(AsyncFileInStreamImpl&&) = delete;
+			AsyncFileInStreamImpl& operator=(const AsyncFileInStreamImpl&) = delete;
+			AsyncFileInStreamImpl& operator=(AsyncFileInStreamImpl&&) = delete;
+
+			static std::shared_ptr<AsyncFileInStreamImpl> createFromBinaryFile(const std::string& path,
+				const asio::any_io_executor& executor);
+
+			asio::awaitable<size_t> async_read(void* buffer, size_t size, uint64_t offset) override;
+			uint64_t size() override;
+			bool is_open() override;
+
+			~AsyncFileInStreamImpl() override;
+		};
+	}
+}
@@ -3,3 +3,253 @@
 //
 
 #include "FontManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <Core/Logger/Logger.h>
+#include "Platform/Algorithm/DistanceField/DistanceField.h"
+
+namespace cyanvne::platform
+{
+    FontManager::FontManager(Config config) : config_(config)
+    {
+        config_.raster_size = std::max(config_.raster_size, 1.0f);
+        config_.sdf_spread = std::max(config_.sdf_spread, 1.0f);
+    }
+
+    FontManager::~FontManager()
+    {
+        for (auto& [id, font] : fonts_)
+        {
+            TTF_CloseFont(font.font);
+        }
+    }
+
+    TTF_Font* FontManager::find(FontId font) const
+    {
+        auto it = fonts_.find(font);
+        return it != fonts_.end() ? it->second.font : nullptr;
+    }
+
+    FontManager::FontId FontManager::loadFont(const uint8_t* data, size_t size)
+    {
+        if (data == nullptr || size == 0)
+        {
+            core::GlobalLogger::getCoreLogger()->error("FontManager: Cannot load a font from empty data.");
+            return INVALID_FONT;
+        }
+        return loadFont(std::vector<uint8_t>(data, data + size));
+    }
+
+    FontManager::FontId FontManager::loadFont(std::vector<uint8_t> data)
+    {
+        if (data.empty())
+        {
+            core::GlobalLogger::getCoreLogger()->error("FontManager: Cannot load a font from empty data.");
+            return INVALID_FONT;
+        }
+
+        Font font;
+        font.data = std::move(data);
+
+        SDL_IOStream* stream = SDL_IOFromConstMem(font.data.data(), font.data.size());
+        if (stream == nullptr)
+        {
+            core::GlobalLogger::getCoreLogger()->error("FontManager: Failed to create font stream: {}", SDL_GetError());
+            return INVALID_FONT;
+        }
+
+        font.font = TTF_OpenFontIO(stream, true, config_.raster_size);
+        if (font.font == nullptr)
+        {
+            core::GlobalLogger::getCoreLogger()->error("FontManager: Failed to open font: {}", SDL_GetError());
+            return INVALID_FONT;
+        }
+
+        // Moving the vector keeps its buffer, so the stream stays valid
+        const FontId id = next_id_++;
+        fonts_.emplace(id, std::move(font));
+        return id;
+    }
+
+    void FontManager::unloadFont(FontId font)
+    {
+        auto it = fonts_.find(font);
+        if (it == fonts_.end())
+        {
+            return;
+        }
+
+        TTF_CloseFont(it->second.font);
+        fonts_.erase(it);
+    }
+
+    bool FontManager::hasGlyph(FontId font, uint32_t codepoint) const
+    {
+        TTF_Font* ttf = find(font);
+        return ttf != nullptr && TTF_FontHasGlyph(ttf, codepoint);
+    }
+
+    std::optional<FontManager::GlyphBitmap> FontManager::rasterizeGlyph(FontId font, uint32_t codepoint) const
+    {
+        TTF_Font* ttf = find(font);
+        if (ttf == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        int min_x = 0, max_x = 0, min_y = 0, max_y = 0, advance = 0;
+        if (!TTF_GetGlyphMetrics(ttf, codepoint, &min_x, &max_x, &min_y, &max_y, &advance))
+        {
+            core::GlobalLogger::getCoreLogger()->warn("FontManager: No metrics for glyph U+{:04X}: {}", codepoint, SDL_GetError());
+            return std::nullopt;
+        }
+
+        GlyphBitmap glyph;
+        glyph.codepoint = codepoint;
+        glyph.advance = static_cast<float>(advance);
+
+        SDL_Surface* rendered = TTF_RenderGlyph_Blended(ttf, codepoint, SDL_Color{ 255, 255, 255, 255 });
+        if (rendered == nullptr)
+        {
+            // Blank glyphs such as spaces have nothing to render but still advance the pen
+            return glyph;
+        }
+
+        SDL_Surface* surface = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(rendered);
+        if (surface == nullptr)
+        {
+            core::GlobalLogger::getCoreLogger()->error("FontManager: Failed to convert glyph surface: {}", SDL_GetError());
+            return std::nullopt;
+        }
+
+        if (SDL_MUSTLOCK(surface))
+        {
+            SDL_LockSurface(surface);
+        }
+
+        const auto* pixels = static_cast<const uint8_t*>(surface->pixels);
+        const auto alpha = [&](int x, int y)
+        {
+            return pixels[y * surface->pitch + x * 4 + 3];
+        };
+
+        // Crop to the inked area, the surface spans the whole line height and advance
+        int crop_min_x = surface->w, crop_min_y = surface->h, crop_max_x = -1, crop_max_y = -1;
+        for (int y = 0; y < surface->h; ++y)
+        {
+            for (int x = 0; x < surface->w; ++x)
+            {
+                if (alpha(x, y) != 0)
+                {
+                    crop_min_x = std::min(crop_min_x, x);
+                    crop_max_x = std::max(crop_max_x, x);
+                    crop_min_y = std::min(crop_min_y, y);
+                    crop_max_y = std::max(crop_max_y, y);
+                }
+            }
+        }
+
+        if (crop_max_x < 0)
+        {
+            if (SDL_MUSTLOCK(surface))
+            {
+                SDL_UnlockSurface(surface);
+            }
+            SDL_DestroySurface(surface);
+            return glyph;
+        }
+
+        // The field needs room to fall off outside the outline
+        const uint32_t padding = static_cast<uint32_t>(std::ceil(config_.sdf_spread));
+        const uint32_t ink_width = static_cast<uint32_t>(crop_max_x - crop_min_x + 1);
+        const uint32_t ink_height = static_cast<uint32_t>(crop_max_y - crop_min_y + 1);
+        glyph.width = ink_width + padding * 2;
+        glyph.height = ink_height + padding * 2;
+
+        std::vector<uint8_t> coverage(static_cast<size_t>(glyph.width) * glyph.height, 0);
+        for (uint32_t y = 0; y < ink_height; ++y)
+        {
+            for (uint32_t x = 0; x < ink_width; ++x)
+            {
+                coverage[(y + padding) * glyph.width + x + padding] =
+                        alpha(crop_min_x + static_cast<int>(x), crop_min_y + static_cast<int>(y));
+            }
+        }
+
+        // SDL3_ttf shifts glyphs with a negative left bearing right so they start at x = 0,
+        // the baseline sits at the ascent
+        const int origin_x = std::max(0, -min_x);
+        const int origin_y = TTF_GetFontAscent(ttf);
+        glyph.offset_x = static_cast<float>(crop_min_x - origin_x) - static_cast<float>(padding);
+        glyph.offset_y = static_cast<float>(crop_min_y - origin_y) - static_cast<float>(padding);
+
+        if (SDL_MUSTLOCK(surface))
+        {
+            SDL_UnlockSurface(surface);
+        }
+        SDL_DestroySurface(surface);
+
+        algorithm::distancefield::coverage_to_sdf(coverage.data(), glyph.width, glyph.height, config_.sdf_spread, glyph.pixels);
+        return glyph;
+    }
+
+    std::optional<FontManager::GlyphMetrics> FontManager::getGlyphMetrics(FontId font, uint32_t codepoint) const
+    {
+        TTF_Font* ttf = find(font);
+        if (ttf == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        int min_x = 0, max_x = 0, min_y = 0, max_y = 0, advance = 0;
+        if (!TTF_GetGlyphMetrics(ttf, codepoint, &min_x, &max_x, &min_y, &max_y, &advance))
+        {
+            return std::nullopt;
+        }
+
+        GlyphMetrics metrics;
+        metrics.advance = static_cast<float>(advance);
+        if (max_x <= min_x || max_y <= min_y)
+        {
+            return metrics;
+        }
+
+        // Same padding as the field, y of the outline bounds grows upwards from the baseline
+        const float padding = std::ceil(config_.sdf_spread);
+        metrics.offset_x = static_cast<float>(min_x) - padding;
+        metrics.offset_y = -static_cast<float>(max_y) - padding;
+        metrics.width = static_cast<float>(max_x - min_x) + padding * 2.0f;
+        metrics.height = static_cast<float>(max_y - min_y) + padding * 2.0f;
+        return metrics;
+    }
+
+    float FontManager::getKerning(FontId font, uint32_t previous_codepoint, uint32_t codepoint) const
+    {
+        TTF_Font* ttf = find(font);
+        int kerning = 0;
+        if (ttf == nullptr || !TTF_GetGlyphKerning(ttf, previous_codepoint, codepoint, &kerning))
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(kerning);
+    }
+
+    std::optional<FontManager::FontMetrics> FontManager::getMetrics(FontId font) const
+    {
+        TTF_Font* ttf = find(font);
+        if (ttf == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        return FontMetrics{
+            static_cast<float>(TTF_GetFontAscent(ttf)),
+            static_cast<float>(TTF_GetFontDescent(ttf)),
+            static_cast<float>(TTF_GetFontLineSkip(ttf))
+        };
+    }
+}
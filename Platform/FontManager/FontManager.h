@@ -5,12 +5,128 @@
 #ifndef CYANVNE_FONTMANAGER_H
 #define CYANVNE_FONTMANAGER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+typedef struct TTF_Font TTF_Font;
 
 namespace cyanvne::platform
 {
+    /**
+     * Owns TrueType fonts opened at a single raster size and turns their glyphs into signed distance fields.
+     * Every metric is in raster pixels, callers scale by their size / getRasterSize(). Since the fields
+     * are resolution independent, one rasterization serves every text size.
+     * Requires SDL3_ttf to be initialized (WMInitializer).
+     */
     class FontManager
     {
+    public:
+        using FontId = uint32_t;
+        static constexpr FontId INVALID_FONT = 0;
+
+        struct Config
+        {
+            // Pixel size glyphs are rasterized at before the distance transform
+            float raster_size = 48.0f;
+            // Distance in raster pixels covered by the field on each side of the edge, also the glyph padding
+            float sdf_spread = 6.0f;
+        };
+
+        struct FontMetrics
+        {
+            float ascent;
+            // Negative, below the baseline
+            float descent;
+            float line_height;
+        };
+
+        struct GlyphBitmap
+        {
+            uint32_t codepoint = 0;
+            // Size of the field including the spread padding, 0 for blank glyphs such as spaces
+            uint32_t width = 0;
+            uint32_t height = 0;
+            // Top left corner of the field relative to the pen position on the baseline, y grows downwards
+            float offset_x = 0.0f;
+            float offset_y = 0.0f;
+            float advance = 0.0f;
+            // R8, width * height bytes, 128 at the edge
+            std::vector<uint8_t> pixels;
+        };
+
+        // The box and advance of a GlyphBitmap, taken from the outline without rendering it
+        struct GlyphMetrics
+        {
+            float offset_x = 0.0f;
+            float offset_y = 0.0f;
+            // 0 for blank glyphs
+            float width = 0.0f;
+            float height = 0.0f;
+            float advance = 0.0f;
+        };
+
+    private:
+        struct Font
+        {
+            TTF_Font* font = nullptr;
+            // TTF_Font reads the file lazily, so the bytes live as long as the font
+            std::vector<uint8_t> data;
+        };
+
+        Config config_;
+        std::unordered_map<FontId, Font> fonts_;
+        FontId next_id_ = 1;
+
+        TTF_Font* find(FontId font) const;
+
+    public:
+        explicit FontManager(Config config = Config());
+        ~FontManager();
+
+        FontManager(const FontManager&) = delete;
+        FontManager& operator=(const FontManager&) = delete;
+        FontManager(FontManager&&) = delete;
+        FontManager& operator=(FontManager&&) = delete;
+
+        /**
+         * Opens a TrueType or OpenType font from memory.
+         * @param data The font file, kept alive by the manager.
+         * @return The font id, or INVALID_FONT if SDL3_ttf cannot open it.
+         */
+        FontId loadFont(std::vector<uint8_t> data);
+        FontId loadFont(const uint8_t* data, size_t size);
+        void unloadFont(FontId font);
+
+        bool hasGlyph(FontId font, uint32_t codepoint) const;
+
+        /**
+         * Rasterizes a glyph and converts its coverage into a signed distance field.
+         * @return The glyph, or nullopt if the font is unknown or SDL3_ttf fails to render it.
+         */
+        std::optional<GlyphBitmap> rasterizeGlyph(FontId font, uint32_t codepoint) const;
+
+        /**
+         * Measures a glyph for layout. The box comes from the outline bounds and can differ from the inked
+         * pixels of rasterizeGlyph() by a pixel, the advance is the same.
+         * @return The metrics, or nullopt if the font is unknown or has no metrics for the glyph.
+         */
+        std::optional<GlyphMetrics> getGlyphMetrics(FontId font, uint32_t codepoint) const;
+
+        // Horizontal adjustment between two consecutive glyphs, 0 when the font has no kerning for the pair
+        float getKerning(FontId font, uint32_t previous_codepoint, uint32_t codepoint) const;
+        std::optional<FontMetrics> getMetrics(FontId font) const;
 
+        float getRasterSize() const
+        {
+            return config_.raster_size;
+        }
+        float getSpread() const
+        {
+            return config_.sdf_spread;
+        }
     };
 }
 
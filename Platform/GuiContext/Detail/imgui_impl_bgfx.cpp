@@ -21,6 +21,8 @@
 #include "bx/math.h"
 #include "bx/timer.h"
 
+#include <string.h>
+
 // Data
 static uint8_t g_View = 255;
 static bgfx::TextureHandle g_FontTexture = BGFX_INVALID_HANDLE;
@@ -28,6 +30,64 @@ static bgfx::ProgramHandle g_ShaderHandle = BGFX_INVALID_HANDLE;
 static bgfx::UniformHandle g_AttribLocationTex = BGFX_INVALID_HANDLE;
 static bgfx::VertexLayout g_VertexLayout;
 
+// Overflow buffers, used when a frame's draw data does not fit the transient pool.
+// They grow on demand and are kept, as overlays that overflow once usually keep overflowing
+static bgfx::DynamicVertexBufferHandle g_OverflowVertices = BGFX_INVALID_HANDLE;
+static bgfx::DynamicIndexBufferHandle g_OverflowIndices = BGFX_INVALID_HANDLE;
+
+// View setup persists in bgfx, it is only sent again when the display changes
+static float g_ViewWidth = -1.0f;
+static float g_ViewHeight = -1.0f;
+static int g_ViewFbWidth = -1;
+static int g_ViewFbHeight = -1;
+
+// Alpha-blending enabled, no face culling, no depth testing, scissor enabled
+static constexpr uint64_t g_State =
+        BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_MSAA |
+        BGFX_STATE_BLEND_FUNC(
+                BGFX_STATE_BLEND_SRC_ALPHA, BGFX_STATE_BLEND_INV_SRC_ALPHA);
+
+static bool ImGui_Implbgfx_UploadOverflow(ImDrawData* draw_data)
+{
+    const uint32_t numVertices = (uint32_t)draw_data->TotalVtxCount;
+    const uint32_t numIndices = (uint32_t)draw_data->TotalIdxCount;
+
+    const bgfx::Memory* vertexMem = bgfx::alloc(numVertices * sizeof(ImDrawVert));
+    const bgfx::Memory* indexMem = bgfx::alloc(numIndices * sizeof(ImDrawIdx));
+    ImDrawVert* verts = (ImDrawVert*)vertexMem->data;
+    ImDrawIdx* indices = (ImDrawIdx*)indexMem->data;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        memcpy(verts, cmd_list->VtxBuffer.Data,
+               cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+        memcpy(indices, cmd_list->IdxBuffer.Data,
+               cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        verts += cmd_list->VtxBuffer.Size;
+        indices += cmd_list->IdxBuffer.Size;
+    }
+
+    if (!isValid(g_OverflowVertices)) {
+        g_OverflowVertices = bgfx::createDynamicVertexBuffer(
+                numVertices, g_VertexLayout, BGFX_BUFFER_ALLOW_RESIZE);
+    }
+    if (!isValid(g_OverflowIndices)) {
+        g_OverflowIndices = bgfx::createDynamicIndexBuffer(
+                numIndices,
+                sizeof(ImDrawIdx) == 4
+                        ? BGFX_BUFFER_ALLOW_RESIZE | BGFX_BUFFER_INDEX32
+                        : BGFX_BUFFER_ALLOW_RESIZE);
+    }
+    if (!isValid(g_OverflowVertices) || !isValid(g_OverflowIndices)) {
+        return false;
+    }
+
+    // Updates are applied before the frame's draws, so this only supports
+    // one RenderDrawLists call per frame
+    bgfx::update(g_OverflowVertices, 0, vertexMem);
+    bgfx::update(g_OverflowIndices, 0, indexMem);
+    return true;
+}
+
 // This is the main rendering function that you have to implement and call after
 // ImGui::Render(). Pass ImGui::GetDrawData() to this function.
 // Note: If text or lines are blurry when integrating ImGui into your engine,
@@ -46,74 +106,111 @@ void ImGui_Implbgfx_RenderDrawLists(ImDrawData* draw_data)
 
     draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
-    // Setup render state: alpha-blending enabled, no face culling,
-    // no depth testing, scissor enabled
-    uint64_t state =
-            BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_MSAA |
-            BGFX_STATE_BLEND_FUNC(
-                    BGFX_STATE_BLEND_SRC_ALPHA, BGFX_STATE_BLEND_INV_SRC_ALPHA);
-
-    const bgfx::Caps* caps = bgfx::getCaps();
-
     // Setup viewport, orthographic projection matrix
-    float ortho[16];
-    bx::mtxOrtho(
-            ortho, 0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, 0.0f, 1000.0f,
-            0.0f, caps->homogeneousDepth);
-    bgfx::setViewTransform(g_View, NULL, ortho);
-    bgfx::setViewRect(g_View, 0, 0, (uint16_t)fb_width, (uint16_t)fb_height);
-
-    // Render command lists
-    for (int n = 0; n < draw_data->CmdListsCount; n++) {
-        const ImDrawList* cmd_list = draw_data->CmdLists[n];
-
-        bgfx::TransientVertexBuffer tvb;
-        bgfx::TransientIndexBuffer tib;
+    if (io.DisplaySize.x != g_ViewWidth || io.DisplaySize.y != g_ViewHeight ||
+        fb_width != g_ViewFbWidth || fb_height != g_ViewFbHeight) {
+        const bgfx::Caps* caps = bgfx::getCaps();
+
+        float ortho[16];
+        bx::mtxOrtho(
+                ortho, 0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, 0.0f, 1000.0f,
+                0.0f, caps->homogeneousDepth);
+        bgfx::setViewTransform(g_View, NULL, ortho);
+        bgfx::setViewRect(g_View, 0, 0, (uint16_t)fb_width, (uint16_t)fb_height);
+
+        g_ViewWidth = io.DisplaySize.x;
+        g_ViewHeight = io.DisplaySize.y;
+        g_ViewFbWidth = fb_width;
+        g_ViewFbHeight = fb_height;
+    }
 
-        uint32_t numVertices = (uint32_t)cmd_list->VtxBuffer.size();
-        uint32_t numIndices = (uint32_t)cmd_list->IdxBuffer.size();
+    const uint32_t totalVertices = (uint32_t)draw_data->TotalVtxCount;
+    const uint32_t totalIndices = (uint32_t)draw_data->TotalIdxCount;
+    if (totalVertices == 0 || totalIndices == 0) {
+        return;
+    }
 
-        if ((numVertices != bgfx::getAvailTransientVertexBuffer(
-                numVertices, g_VertexLayout)) ||
-            (numIndices != bgfx::getAvailTransientIndexBuffer(numIndices))) {
-            // not enough space in transient buffer, quit drawing the rest...
-            break;
-        }
+    // One allocation for the whole frame, lists are laid out back to back and
+    // addressed through their base vertex and first index
+    bgfx::TransientVertexBuffer tvb;
+    bgfx::TransientIndexBuffer tib;
+    const bool transient =
+            totalVertices == bgfx::getAvailTransientVertexBuffer(
+                    totalVertices, g_VertexLayout) &&
+            totalIndices == bgfx::getAvailTransientIndexBuffer(
+                    totalIndices, sizeof(ImDrawIdx) == 4);
 
-        bgfx::allocTransientVertexBuffer(&tvb, numVertices, g_VertexLayout);
-        bgfx::allocTransientIndexBuffer(&tib, numIndices);
+    if (transient) {
+        bgfx::allocTransientVertexBuffer(&tvb, totalVertices, g_VertexLayout);
+        bgfx::allocTransientIndexBuffer(&tib, totalIndices, sizeof(ImDrawIdx) == 4);
 
         ImDrawVert* verts = (ImDrawVert*)tvb.data;
-        memcpy(
-                verts, cmd_list->VtxBuffer.begin(),
-                numVertices * sizeof(ImDrawVert));
-
         ImDrawIdx* indices = (ImDrawIdx*)tib.data;
-        memcpy(
-                indices, cmd_list->IdxBuffer.begin(),
-                numIndices * sizeof(ImDrawIdx));
+        for (int n = 0; n < draw_data->CmdListsCount; n++) {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+            memcpy(verts, cmd_list->VtxBuffer.Data,
+                   cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            memcpy(indices, cmd_list->IdxBuffer.Data,
+                   cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+            verts += cmd_list->VtxBuffer.Size;
+            indices += cmd_list->IdxBuffer.Size;
+        }
+    } else if (!ImGui_Implbgfx_UploadOverflow(draw_data)) {
+        return;
+    }
+
+    // Render command lists
+    uint32_t listVertexOffset = 0;
+    uint32_t listIndexOffset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
 
             if (pcmd->UserCallback) {
-                pcmd->UserCallback(cmd_list, pcmd);
+                // State is set for every draw, so there is nothing to reset
+                if (pcmd->UserCallback != ImDrawCallback_ResetRenderState) {
+                    pcmd->UserCallback(cmd_list, pcmd);
+                }
+                continue;
+            }
+
+            const float clipMinX = bx::max(pcmd->ClipRect.x, 0.0f);
+            const float clipMinY = bx::max(pcmd->ClipRect.y, 0.0f);
+            const float clipMaxX = bx::min(pcmd->ClipRect.z, (float)fb_width);
+            const float clipMaxY = bx::min(pcmd->ClipRect.w, (float)fb_height);
+            if (pcmd->ElemCount == 0 || clipMaxX <= clipMinX || clipMaxY <= clipMinY) {
+                continue;
+            }
+
+            const uint16_t xx = (uint16_t)clipMinX;
+            const uint16_t yy = (uint16_t)clipMinY;
+            bgfx::setScissor(
+                    xx, yy, (uint16_t)clipMaxX - xx, (uint16_t)clipMaxY - yy);
+
+            bgfx::setState(g_State);
+            bgfx::TextureHandle texture = {
+                    (uint16_t)((intptr_t)pcmd->TextureId & 0xffff)};
+            bgfx::setTexture(0, g_AttribLocationTex, texture);
+
+            // Indices stay relative to the command's vertex offset, which lets
+            // 16-bit indices address lists of any size
+            const uint32_t startVertex = listVertexOffset + pcmd->VtxOffset;
+            const uint32_t numVertices = (uint32_t)cmd_list->VtxBuffer.Size - pcmd->VtxOffset;
+            const uint32_t startIndex = listIndexOffset + pcmd->IdxOffset;
+            if (transient) {
+                bgfx::setVertexBuffer(0, &tvb, startVertex, numVertices);
+                bgfx::setIndexBuffer(&tib, startIndex, pcmd->ElemCount);
             } else {
-                const uint16_t xx = (uint16_t)bx::max(pcmd->ClipRect.x, 0.0f);
-                const uint16_t yy = (uint16_t)bx::max(pcmd->ClipRect.y, 0.0f);
-                bgfx::setScissor(
-                        xx, yy, (uint16_t)bx::min(pcmd->ClipRect.z, 65535.0f) - xx,
-                        (uint16_t)bx::min(pcmd->ClipRect.w, 65535.0f) - yy);
-
-                bgfx::setState(state);
-                bgfx::TextureHandle texture = {
-                        (uint16_t)((intptr_t)pcmd->TextureId & 0xffff)};
-                bgfx::setTexture(0, g_AttribLocationTex, texture);
-                bgfx::setVertexBuffer(0, &tvb, 0, numVertices);
-                bgfx::setIndexBuffer(&tib, pcmd->IdxOffset, pcmd->ElemCount);
-                bgfx::submit(g_View, g_ShaderHandle);
+                bgfx::setVertexBuffer(0, g_OverflowVertices, startVertex, numVertices);
+                bgfx::setIndexBuffer(g_OverflowIndices, startIndex, pcmd->ElemCount);
             }
+            bgfx::submit(g_View, g_ShaderHandle);
         }
+
+        listVertexOffset += (uint32_t)cmd_list->VtxBuffer.Size;
+        listIndexOffset += (uint32_t)cmd_list->IdxBuffer.Size;
     }
 }
 
@@ -136,6 +233,18 @@ bool ImGui_Implbgfx_CreateFontsTexture()
     return true;
 }
 
+void ImGui_Implbgfx_UpdateFontsTexture()
+{
+    if (!isValid(g_FontTexture)) {
+        return;
+    }
+
+    // Destruction is deferred until the frame that still samples it is done
+    bgfx::destroy(g_FontTexture);
+    g_FontTexture.idx = bgfx::kInvalidHandle;
+    ImGui_Implbgfx_CreateFontsTexture();
+}
+
 #include "fs_ocornut_imgui.bin.h"
 #include "vs_ocornut_imgui.bin.h"
 
@@ -170,6 +279,17 @@ void ImGui_Implbgfx_InvalidateDeviceObjects()
     bgfx::destroy(g_AttribLocationTex);
     bgfx::destroy(g_ShaderHandle);
 
+    if (isValid(g_OverflowVertices)) {
+        bgfx::destroy(g_OverflowVertices);
+        g_OverflowVertices.idx = bgfx::kInvalidHandle;
+    }
+    if (isValid(g_OverflowIndices)) {
+        bgfx::destroy(g_OverflowIndices);
+        g_OverflowIndices.idx = bgfx::kInvalidHandle;
+    }
+    g_ViewWidth = -1.0f;
+    g_ViewHeight = -1.0f;
+
     if (isValid(g_FontTexture)) {
         bgfx::destroy(g_FontTexture);
         ImGui::GetIO().Fonts->TexID = 0;
@@ -180,6 +300,13 @@ void ImGui_Implbgfx_InvalidateDeviceObjects()
 void ImGui_Implbgfx_Init(int view)
 {
     g_View = (uint8_t)(view & 0xff);
+    g_ViewWidth = -1.0f;
+    g_ViewHeight = -1.0f;
+
+    // Draw commands carry vertex offsets, so large lists are not split by 16-bit indices
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendRendererName = "imgui_impl_bgfx";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
 }
 
 void ImGui_Implbgfx_Shutdown()
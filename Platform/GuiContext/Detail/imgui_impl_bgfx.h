@@ -15,6 +15,10 @@ void ImGui_Implbgfx_Shutdown();
 void ImGui_Implbgfx_NewFrame();
 void ImGui_Implbgfx_RenderDrawLists(struct ImDrawData* draw_data);
 
+// Re-uploads the font atlas after it was rebuilt, e.g. with new glyphs.
+// Does nothing before the device objects exist, they upload the atlas when created.
+void ImGui_Implbgfx_UpdateFontsTexture();
+
 // Use if you want to reset your rendering device without losing ImGui state.
 void ImGui_Implbgfx_InvalidateDeviceObjects();
 bool ImGui_Implbgfx_CreateDeviceObjects();
\ No newline at end of file
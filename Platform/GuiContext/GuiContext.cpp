@@ -1,14 +1,15 @@
 #include "GuiContext.h"
+#include <imgui_internal.h>
 #include "Core/Logger/Logger.h"
 #include "Core/ViewID/ViewID.h"
 #include <bx/platform.h>
 #include <Platform/PlatformException/PlatformException.h>
 
 cyanvne::platform::GuiContext::GuiContext(const std::shared_ptr<WindowContext>& window,
-    const std::vector<uint8_t>& font_data,
+    FontSource font,
     float size_pixels,
     const std::set<std::string>& extra_languages_support)
-    : font_size_(font_data.size()), font_pixels_size_(size_pixels)
+    : font_(std::move(font)), font_pixels_size_(size_pixels)
 {
     core::GlobalLogger::getCoreLogger()->info("Try to Creating GUI Context");
     IMGUI_CHECKVERSION();
@@ -48,20 +49,121 @@ cyanvne::platform::GuiContext::GuiContext(const std::shared_ptr<WindowContext>&
     int32_t h, w;
     window->getWindowSize(&w, &h);
 
-    if (font_size_ > 0)
+    if (font_.data != nullptr && font_.size > 0)
     {
-        font_data_ = new char[font_size_];
-        memcpy(font_data_, font_data.data(), font_size_);
-        
         core::GlobalLogger::getCoreLogger()->info("Built-in Font Loaded, memory size: {:d}, pixel: {:.2f}",
-            font_size_, size_pixels);
+            font_.size, size_pixels);
 
-        io->Fonts->AddFontFromMemoryTTF(font_data_, static_cast<int>(font_size_), size_pixels);
-        ImGui::GetIO().FontGlobalScale = calculateScreenScale(w, h, size_pixels);
+        glyphs_.AddRanges(io->Fonts->GetGlyphRangesDefault());
+        for (const std::string& language : extra_languages_support)
+        {
+            // No string source feeds addGlyphs() yet, so CJK languages still load their whole range up front
+            const std::string_view prefix = std::string_view(language).substr(0, 2);
+            if (prefix == "ru" || prefix == "uk" || prefix == "be" || prefix == "bg" || prefix == "sr" || prefix == "kk")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesCyrillic());
+            }
+            else if (prefix == "el")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesGreek());
+            }
+            else if (prefix == "vi")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesVietnamese());
+            }
+            else if (prefix == "th")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesThai());
+            }
+            else if (prefix == "zh")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesChineseFull());
+            }
+            else if (prefix == "ja")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesJapanese());
+            }
+            else if (prefix == "ko")
+            {
+                glyphs_.AddRanges(io->Fonts->GetGlyphRangesKorean());
+            }
+        }
+
+        rebuildFontAtlas();
     }
 
     ImGui::GetIO().FontGlobalScale = calculateScreenScale(w, h, font_pixels_size_);
 
     setupImGuiStyle(false, 0.7f);
 }
-    
\ No newline at end of file
+    
+
+void cyanvne::platform::GuiContext::addGlyphs(std::string_view utf8)
+{
+    if (font_.data == nullptr)
+    {
+        return;
+    }
+
+    const char* text = utf8.data();
+    const char* text_end = utf8.data() + utf8.size();
+    while (text < text_end)
+    {
+        unsigned int codepoint = 0;
+        const int length = ImTextCharFromUtf8(&codepoint, text, text_end);
+        text += length > 0 ? length : 1;
+
+        if (codepoint == 0 || codepoint > IM_UNICODE_CODEPOINT_MAX || glyphs_.GetBit(codepoint))
+        {
+            continue;
+        }
+        glyphs_.SetBit(codepoint);
+        ++pending_glyphs_;
+    }
+}
+
+bool cyanvne::platform::GuiContext::updateFontAtlas()
+{
+    if (pending_glyphs_ == 0)
+    {
+        return false;
+    }
+
+    // The cost of a rebuild grows with the atlas, so bursts of new text share one
+    const uint64_t now = SDL_GetTicks();
+    if (now - last_rebuild_ticks_ < GLYPH_REBUILD_INTERVAL_MS)
+    {
+        return false;
+    }
+
+    core::GlobalLogger::getCoreLogger()->debug("GUI font atlas: adding {:d} glyphs", pending_glyphs_);
+    rebuildFontAtlas();
+    return true;
+}
+
+void cyanvne::platform::GuiContext::rebuildFontAtlas()
+{
+    glyph_ranges_.clear();
+    glyphs_.BuildRanges(&glyph_ranges_);
+
+    ImFontConfig config;
+    // Borrowed from font_.owner, the atlas must not free it
+    config.FontDataOwnedByAtlas = false;
+
+    io->Fonts->Clear();
+    io->Fonts->AddFontFromMemoryTTF(const_cast<uint8_t*>(font_.data), static_cast<int>(font_.size), font_pixels_size_,
+        &config, glyph_ranges_.Data);
+    io->Fonts->Build();
+
+    ImGui_Implbgfx_UpdateFontsTexture();
+    // The application draws through ImGui_ImplSDLRenderer3, whose texture is a copy of the atlas taken when it was created.
+    // Only that backend sets the renderer user data. Before its init there is no copy yet, NewFrame() creates it later
+    if (io->BackendRendererUserData != nullptr)
+    {
+        ImGui_ImplSDLRenderer3_DestroyFontsTexture();
+        ImGui_ImplSDLRenderer3_CreateFontsTexture();
+    }
+
+    pending_glyphs_ = 0;
+    last_rebuild_ticks_ = SDL_GetTicks();
+}
\ No newline at end of file
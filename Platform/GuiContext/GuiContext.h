@@ -15,6 +15,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string_view>
 
 namespace cyanvne
 {
@@ -22,17 +23,37 @@ namespace cyanvne
     {
         class GuiContext
         {
+        public:
+            // Font file borrowed by the atlas, owner keeps data alive (e.g. a cache handle pinning the resource)
+            struct FontSource
+            {
+                const uint8_t* data = nullptr;
+                size_t size = 0;
+                std::shared_ptr<void> owner;
+            };
+
         private:
             inline static std::mutex _mutex;
             inline static volatile GuiContext* _instance;
 
+            // Lower bound between two atlas rebuilds, glyphs requested in between are batched
+            static constexpr uint64_t GLYPH_REBUILD_INTERVAL_MS = 250;
+
             ImGuiIO* io;
 
-            char* font_data_ = nullptr;
-            uint64_t font_size_;
+            FontSource font_;
 
             float font_pixels_size_ = 0;
 
+            // Every code point the atlas holds or will hold after the next rebuild
+            ImFontGlyphRangesBuilder glyphs_;
+            // The atlas keeps a pointer to the ranges until it is rebuilt
+            ImVector<ImWchar> glyph_ranges_;
+            uint32_t pending_glyphs_ = 0;
+            uint64_t last_rebuild_ticks_ = 0;
+
+            void rebuildFontAtlas();
+
             static float calculateScreenScale(const int32_t& screen_width, const int32_t& screen_height, const float base_font_size = 30.0f)
             {
                 constexpr float reference_width = 1920.0f;
@@ -50,7 +71,7 @@ namespace cyanvne
                 return std::clamp(final_scale, min_scale, max_scale);
             }
             GuiContext(const std::shared_ptr<WindowContext>& window,
-                const std::vector<uint8_t>& font_data = {},
+                FontSource font = {},
                 float size_pixels = 30.0f,
                 const std::set<std::string>& extra_languages_support = {});
         public:
@@ -59,8 +80,13 @@ namespace cyanvne
             GuiContext(GuiContext&&) = delete;
             GuiContext& operator=(GuiContext&&) = delete;
 
+            /**
+             * @param font The atlas starts with ASCII and Latin-1, each language in extra_languages_support
+             * adds its script's range (Cyrillic, Greek, Vietnamese, Thai, Chinese, Japanese, Korean).
+             * addGlyphs() adds code points outside those ranges.
+             */
             static std::shared_ptr<GuiContext> create(const std::shared_ptr<WindowContext>& window,
-                const std::vector<uint8_t>& font_data = {},
+                FontSource font = {},
                 float size_pixels = 30.0f,
                 const std::set<std::string>& extra_languages_support = {})
             {
@@ -69,7 +95,7 @@ namespace cyanvne
                     _mutex.lock();
                     if (_instance == nullptr)
                     {
-                        _instance = new GuiContext(window, font_data, size_pixels, extra_languages_support);
+                        _instance = new GuiContext(window, std::move(font), size_pixels, extra_languages_support);
                     }
                     _mutex.unlock();
                 }
@@ -86,6 +112,24 @@ namespace cyanvne
                 return *io;
             }
 
+            /**
+             * Requests the glyphs of a UTF-8 text, e.g. the current locale's string table or typed input.
+             * Code points already in the atlas are ignored, the rest are added by the next updateFontAtlas().
+             */
+            void addGlyphs(std::string_view utf8);
+
+            /**
+             * Rebuilds the font atlas when glyphs are pending and the last rebuild is old enough.
+             * Call before ImGui::NewFrame(), the atlas cannot change during a frame.
+             * @return True if the atlas was rebuilt.
+             */
+            bool updateFontAtlas();
+
+            bool hasPendingGlyphs() const
+            {
+                return pending_glyphs_ > 0;
+            }
+
             void setupImGuiStyle(bool dark_style, float alpha)
             {
                 ImGuiStyle& style = ImGui::GetStyle();
@@ -115,7 +159,7 @@ namespace cyanvne
 
             ~GuiContext()
             {
-                // Notice : This code will clean up the memory pointed to by the font pointer
+                // Notice : The atlas does not own the font data, font_.owner releases it after the context is gone
                 ImGui_ImplSDL3_Shutdown();
                 ImGui_Implbgfx_Shutdown();
                 ImGui::DestroyContext();
@@ -0,0 +1,175 @@
+#include "PositionalStreamImpl.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+
+#if BX_PLATFORM_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#elif BX_PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
+std::shared_ptr<cyanvne::platform::PositionalFileInStreamImpl> cyanvne::platform::PositionalFileInStreamImpl::
+createFromBinaryFile(const std::string& path)
+{
+	auto impl = std::make_shared<PositionalFileInStreamImpl>();
+	if (!impl->open(path))
+	{
+		core::GlobalLogger::getCoreLogger()->warn("PositionalFileInStreamImpl: Failed to open '{}'", path);
+		return nullptr;
+	}
+	return impl;
+}
+
+bool cyanvne::platform::PositionalFileInStreamImpl::open(const std::string& path)
+{
+#if BX_PLATFORM_POSIX
+	fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd_ < 0)
+	{
+		return false;
+	}
+	struct stat file_stat{};
+	if (::fstat(fd_, &file_stat) != 0)
+	{
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+	size_ = static_cast<uint64_t>(file_stat.st_size);
+	return true;
+#elif BX_PLATFORM_WINDOWS
+	int wide_length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+	if (wide_length <= 0)
+	{
+		return false;
+	}
+	std::wstring wide_path(static_cast<size_t>(wide_length), L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide_path.data(), wide_length);
+
+	HANDLE handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(handle, &file_size))
+	{
+		CloseHandle(handle);
+		return false;
+	}
+	file_handle_ = handle;
+	size_ = static_cast<uint64_t>(file_size.QuadPart);
+	return true;
+#else
+	stream_ = SDL_IOFromFile(path.c_str(), "rb");
+	if (!stream_)
+	{
+		return false;
+	}
+	Sint64 stream_size = SDL_GetIOSize(stream_);
+	if (stream_size < 0)
+	{
+		SDL_CloseIO(stream_);
+		stream_ = nullptr;
+		return false;
+	}
+	size_ = static_cast<uint64_t>(stream_size);
+	return true;
+#endif
+}
+
+size_t cyanvne::platform::PositionalFileInStreamImpl::read_at(void* buffer, size_t size, uint64_t offset)
+{
+	if (size == 0 || offset >= size_)
+	{
+		return 0;
+	}
+	if (buffer == nullptr)
+	{
+		throw exception::NullPointerException("PositionalFileInStreamImpl: Null pointer in read_at");
+	}
+
+#if BX_PLATFORM_POSIX
+	ssize_t bytes_read;
+	do
+	{
+		bytes_read = ::pread(fd_, buffer, size, static_cast<off_t>(offset));
+	} while (bytes_read < 0 && errno == EINTR);
+
+	if (bytes_read < 0)
+	{
+		throw exception::CyanVNEIOException("PositionalFileInStreamImpl: pread failed, errno " + std::to_string(errno));
+	}
+	return static_cast<size_t>(bytes_read);
+#elif BX_PLATFORM_WINDOWS
+	// The offset travels in the OVERLAPPED block, so concurrent calls never race on a shared file pointer
+	OVERLAPPED overlapped{};
+	overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+	overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+	DWORD bytes_read = 0;
+	DWORD bytes_to_read = static_cast<DWORD>(std::min<size_t>(size, 0xFFFFFFFFu));
+	if (!ReadFile(static_cast<HANDLE>(file_handle_), buffer, bytes_to_read, &bytes_read, &overlapped))
+	{
+		const DWORD error = GetLastError();
+		if (error == ERROR_HANDLE_EOF)
+		{
+			return 0;
+		}
+		throw exception::CyanVNEIOException("PositionalFileInStreamImpl: ReadFile failed, error " + std::to_string(error));
+	}
+	return static_cast<size_t>(bytes_read);
+#else
+	std::lock_guard<std::mutex> lock(stream_mutex_);
+	if (SDL_SeekIO(stream_, static_cast<Sint64>(offset), SDL_IO_SEEK_SET) < 0)
+	{
+		throw exception::CyanVNEIOException(std::string("PositionalFileInStreamImpl: Seek failed, ") + SDL_GetError());
+	}
+	const size_t bytes_read = SDL_ReadIO(stream_, buffer, size);
+	if (bytes_read == 0 && SDL_GetIOStatus(stream_) == SDL_IO_STATUS_ERROR)
+	{
+		throw exception::CyanVNEIOException(std::string("PositionalFileInStreamImpl: Read failed, ") + SDL_GetError());
+	}
+	return bytes_read;
+#endif
+}
+
+uint64_t cyanvne::platform::PositionalFileInStreamImpl::size()
+{
+	return size_;
+}
+
+bool cyanvne::platform::PositionalFileInStreamImpl::is_open()
+{
+#if BX_PLATFORM_POSIX
+	return fd_ >= 0;
+#elif BX_PLATFORM_WINDOWS
+	return file_handle_ != nullptr;
+#else
+	return stream_ != nullptr;
+#endif
+}
+
+cyanvne::platform::PositionalFileInStreamImpl::~PositionalFileInStreamImpl()
+{
+#if BX_PLATFORM_POSIX
+	if (fd_ >= 0)
+	{
+		::close(fd_);
+	}
+#elif BX_PLATFORM_WINDOWS
+	if (file_handle_)
+	{
+		CloseHandle(static_cast<HANDLE>(file_handle_));
+	}
+#else
+	if (stream_)
+	{
+		SDL_CloseIO(stream_);
+	}
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <bx/platform.h>
+#include <Core/Stream/Stream.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace cyanvne
+{
+	namespace platform
+	{
+		// One shared file handle serving concurrent positional reads.
+		// pread() on POSIX, overlapped-offset ReadFile on Windows, a locked SDL stream elsewhere.
+		class PositionalFileInStreamImpl : public core::stream::PositionalInStreamInterface
+		{
+		private:
+			uint64_t size_ = 0;
+
+#if BX_PLATFORM_POSIX
+			int fd_ = -1;
+#elif BX_PLATFORM_WINDOWS
+			void* file_handle_ = nullptr;
+#else
+			std::mutex stream_mutex_;
+			SDL_IOStream* stream_ = nullptr;
+#endif
+
+			bool open(const std::string& path);
+		public:
+			PositionalFileInStreamImpl() = default;
+
+			PositionalFileInStreamImpl(const PositionalFileInStreamImpl&) = delete;
+			PositionalFileInStreamImpl(PositionalFileInStreamImpl&&) = delete;
+			PositionalFileInStreamImpl& operator=(const PositionalFileInStreamImpl&) = delete;
+			PositionalFileInStreamImpl& operator=(PositionalFileInStreamImpl&&) = delete;
+
+			static std::shared_ptr<PositionalFileInStreamImpl> createFromBinaryFile(const std::string& path);
+
+			size_t read_at(void* buffer, size_t size, uint64_t offset) override;
+			uint64_t size() override;
+			bool is_open() override;
+
+			~PositionalFileInStreamImpl() override;
+		};
+	}
+}
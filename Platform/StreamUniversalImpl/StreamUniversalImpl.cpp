@@ -21,7 +21,10 @@ std::shared_ptr<cyanvne::resources::InStreamUniversalImpl> cyanvne::resources::I
 		return nullptr;
 	}
 
-	return std::make_shared<InStreamUniversalImpl>(stream);
+	auto impl = std::make_shared<InStreamUniversalImpl>(stream);
+	impl->memory_data_ = data;
+	impl->memory_size_ = size;
+	return impl;
 }
 
 size_t cyanvne::resources::InStreamUniversalImpl::read(void* buffer, size_t size)
@@ -83,6 +86,18 @@ bool cyanvne::resources::InStreamUniversalImpl::is_open()
 	return SDL_GetIOStatus(in_stream_) == SDL_IO_STATUS_READY;
 }
 
+bool cyanvne::resources::InStreamUniversalImpl::lend_contiguous_buffer(const void*& data, uint64_t& size)
+{
+	if (!in_stream_ || !memory_data_)
+	{
+		return false;
+	}
+
+	data = memory_data_;
+	size = memory_size_;
+	return true;
+}
+
 cyanvne::resources::InStreamUniversalImpl::~InStreamUniversalImpl()
 {
 	if (in_stream_)
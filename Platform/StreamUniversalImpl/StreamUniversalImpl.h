@@ -13,6 +13,10 @@ namespace cyanvne
 		{
 		private:
 			SDL_IOStream* in_stream_;
+
+			// Set when the stream was created over caller-owned memory
+			const void* memory_data_ = nullptr;
+			size_t memory_size_ = 0;
 		public:
 			InStreamUniversalImpl(SDL_IOStream* in_stream)
 				: in_stream_(in_stream)
@@ -30,6 +34,7 @@ namespace cyanvne
 			int64_t seek(int64_t offset, core::stream::SeekMode mode) override;
 			int64_t tell() override;
 			bool is_open() override;
+			bool lend_contiguous_buffer(const void*& data, uint64_t& size) override;
 
 			~InStreamUniversalImpl() override;
 		};
@@ -5,6 +5,8 @@
 #include <bx/platform.h>
 #include "Core/PathToStream/PathToStream.h"
 #include "Platform/StreamUniversalImpl/StreamUniversalImpl.h"
+#include "Platform/AsyncStreamImpl/AsyncStreamImpl.h"
+#include "Platform/PositionalStreamImpl/PositionalStreamImpl.h"
 
 namespace cyanvne
 {
@@ -37,6 +39,19 @@ namespace cyanvne
                 return resources::OutStreamUniversalImpl::createFromBinaryFile(full_path);
             }
 
+            std::shared_ptr<core::stream::PositionalInStreamInterface> getPositionalInStream(const std::string& path) override
+            {
+                std::string full_path = getFullPath(path);
+                return PositionalFileInStreamImpl::createFromBinaryFile(full_path);
+            }
+
+            std::shared_ptr<core::stream::AsyncInStreamInterface> getAsyncInStream(const std::string& path,
+                const boost::asio::any_io_executor& executor) override
+            {
+                std::string full_path = getFullPath(path);
+                return AsyncFileInStreamImpl::createFromBinaryFile(full_path, executor);
+            }
+
         private:
             std::string getFullPath(const std::string& path) const
             {
@@ -2,6 +2,11 @@
 
 namespace cyanvne::resources::adapters
 {
+    namespace
+    {
+        constexpr const char* kInStreamOwnerProperty = "cyanvne.adapters.in_stream_owner";
+    }
+
     Sint64 SDLCALL sdl_size_in_cb(void* userdata)
     {
         auto* context = static_cast<SdlInStreamAdapterContext*>(userdata);
@@ -9,6 +14,9 @@ namespace cyanvne::resources::adapters
         if (!context || !context->stream)
             return -1;
 
+        if (context->cached_size >= 0)
+            return context->cached_size;
+
         auto* stream = context->stream.get();
 
         int64_t current_pos = stream->tell();
@@ -20,6 +28,9 @@ namespace cyanvne::resources::adapters
 
         stream->seek(current_pos, core::stream::SeekMode::Begin);
 
+        if (size >= 0)
+            context->cached_size = size;
+
         return size;
     }
 
@@ -100,6 +111,14 @@ namespace cyanvne::resources::adapters
         return true;
     }
 
+    void SDLCALL sdl_release_in_owner_cb(void* userdata, void* value)
+    {
+        if (value)
+        {
+            delete static_cast<SdlInStreamAdapterContext*>(value);
+        }
+    }
+
     Sint64 SDLCALL sdl_size_out_cb(void* userdata)
     {
         auto* context = static_cast<SdlOutStreamAdapterContext*>(userdata);
@@ -286,6 +305,37 @@ namespace cyanvne::resources::adapters
         if (!cyanvne_stream || !cyanvne_stream->is_open())
             return nullptr;
 
+        // Memory-backed streams are handed to SDL's native memory reader, the adapter context
+        // only rides along as an IO property to keep the backing stream alive until SDL_CloseIO
+        const void* buffer = nullptr;
+        uint64_t buffer_size = 0;
+        if (cyanvne_stream->lend_contiguous_buffer(buffer, buffer_size))
+        {
+            int64_t position = cyanvne_stream->tell();
+            SDL_IOStream* memory_io = SDL_IOFromConstMem(buffer, static_cast<size_t>(buffer_size));
+            if (memory_io)
+            {
+                auto* owner = new(std::nothrow) SdlInStreamAdapterContext { cyanvne_stream };
+                SDL_PropertiesID props = SDL_GetIOProperties(memory_io);
+
+                // SDL_SetPointerPropertyWithCleanup releases the owner itself when it fails
+                if (owner && props &&
+                    SDL_SetPointerPropertyWithCleanup(props, kInStreamOwnerProperty, owner, sdl_release_in_owner_cb, nullptr))
+                {
+                    if (position > 0)
+                    {
+                        SDL_SeekIO(memory_io, position, SDL_IO_SEEK_SET);
+                    }
+                    return memory_io;
+                }
+                if (owner && !props)
+                {
+                    delete owner;
+                }
+                SDL_CloseIO(memory_io);
+            }
+        }
+
         auto* context = new(std::nothrow) SdlInStreamAdapterContext { std::move(cyanvne_stream) };
 
         if (!context)
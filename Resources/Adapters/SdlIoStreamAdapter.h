@@ -12,6 +12,9 @@ namespace cyanvne
             struct SdlInStreamAdapterContext
             {
                 std::shared_ptr<core::stream::InStreamInterface> stream;
+
+                // Input streams never change size, so it is measured once on first use
+                int64_t cached_size = -1;
             };
             struct SdlOutStreamAdapterContext
             {
@@ -27,6 +30,7 @@ namespace cyanvne
             size_t SDLCALL sdl_read_in_cb(void* userdata, void* ptr, size_t size, SDL_IOStatus* status);
             size_t SDLCALL sdl_write_in_cb(void* userdata, const void* ptr, size_t size, SDL_IOStatus* status);
             bool SDLCALL sdl_close_in_cb(void* userdata);
+            void SDLCALL sdl_release_in_owner_cb(void* userdata, void* value);
 
             Sint64 SDLCALL sdl_size_out_cb(void* userdata);
             Sint64 SDLCALL sdl_seek_out_cb(void* userdata, Sint64 offset, SDL_IOWhence whence);
@@ -7,12 +7,102 @@
 #include "soloud_wav.h"
 #include "bimg/bimg.h"
 #include "bx/readerwriter.h"
+#include "bx/allocator.h"
+#include "Platform/Algorithm/PixelConversion/PixelConversion.h"
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 namespace cyanvne
 {
     namespace resources
     {
+        namespace
+        {
+            std::atomic<uint64_t> next_texture_id{ 1 };
+
+            struct TextureDestroyListeners
+            {
+                std::mutex mutex;
+                uint64_t next_id = 1;
+                std::vector<std::pair<uint64_t, TextureResource::DestroyListener>> listeners;
+            };
+
+            TextureDestroyListeners& texture_destroy_listeners()
+            {
+                static TextureDestroyListeners listeners;
+                return listeners;
+            }
+
+            using SharedPixels = std::shared_ptr<std::vector<uint8_t>>;
+
+            /**
+             * Hands the pixels to bgfx without a copy. bgfx releases the reference once the texture is uploaded,
+             * or right away when creation fails, keep holds the pixels so a failed upload can restore them.
+             */
+            const bgfx::Memory* make_pixel_ref(std::vector<uint8_t>& pixels, SharedPixels& keep)
+            {
+                keep = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+                auto* owner = new SharedPixels(keep);
+                return bgfx::makeRef(keep->data(), static_cast<uint32_t>(keep->size()),
+                                     [](void*, void* user_data)
+                                     {
+                                         delete static_cast<SharedPixels*>(user_data);
+                                     }, owner);
+            }
+
+            /**
+             * Writes a decoded surface as tightly packed RGBA8 rows.
+             * @return false if the surface format has no direct kernel and must go through SDL_ConvertSurface first.
+             */
+            bool convert_surface_rows(const SDL_Surface* surface, uint8_t* dst)
+            {
+                namespace pixelconversion = platform::algorithm::pixelconversion;
+
+                const size_t width = static_cast<size_t>(surface->w);
+                const size_t row_bytes = width * 4;
+                const auto* src = static_cast<const uint8_t*>(surface->pixels);
+
+                switch (surface->format)
+                {
+                    case SDL_PIXELFORMAT_RGBA32:
+                    case SDL_PIXELFORMAT_BGRA32:
+                    case SDL_PIXELFORMAT_RGB24:
+                    case SDL_PIXELFORMAT_BGR24:
+                        break;
+                    default:
+                        return false;
+                }
+
+                for (int y = 0; y < surface->h; ++y)
+                {
+                    const uint8_t* row = src + static_cast<size_t>(y) * surface->pitch;
+                    uint8_t* out = dst + static_cast<size_t>(y) * row_bytes;
+
+                    switch (surface->format)
+                    {
+                        case SDL_PIXELFORMAT_RGBA32:
+                            std::memcpy(out, row, row_bytes);
+                            break;
+                        case SDL_PIXELFORMAT_BGRA32:
+                            pixelconversion::swizzle_bgra_to_rgba(row, out, width);
+                            break;
+                        case SDL_PIXELFORMAT_RGB24:
+                            pixelconversion::expand_rgb_to_rgba(row, out, width);
+                            break;
+                        case SDL_PIXELFORMAT_BGR24:
+                            pixelconversion::expand_bgr_to_rgba(row, out, width);
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                return true;
+            }
+        }
+
         RawDataResource::RawDataResource(uint64_t id, const ResourcesManager* base_manager)
         {
             data = base_manager->getResourceDataById(id);
@@ -23,48 +113,41 @@ namespace cyanvne
             return data.size();
         }
 
-        TextureResource::TextureResource(const std::vector<uint8_t>& raw_data, ImageLoader loader)
+        DecodedImage decodeImage(const uint8_t* data, size_t size, ImageLoader loader)
         {
-            if (raw_data.empty())
+            if (data == nullptr || size == 0)
             {
                 throw exception::resourcesexception::ResourceManagerIOException("Cannot create texture from empty data.");
             }
 
+            DecodedImage image;
+
             if (loader == ImageLoader::INTERNAL)
             {
-                bx::MemoryReader reader(raw_data.data(), raw_data.size());
+                bx::DefaultAllocator allocator;
                 bx::Error err;
 
-                bimg::ImageContainer image_container;
-
-                if (!bimg::imageParse(image_container, &reader, &err))
+                bimg::ImageContainer* image_container = bimg::imageParse(&allocator, data, static_cast<uint32_t>(size),
+                                                                         bimg::TextureFormat::Count, &err);
+                if (image_container == nullptr)
                 {
-                    bimg::imageFree(&image_container);
                     throw exception::resourcesexception::ResourceManagerIOException("bimg failed to parse image data.");
                 }
 
-                if (bgfx::isTextureValid(0, false, image_container.m_numLayers,
-                                         static_cast<bgfx::TextureFormat::Enum>(image_container.m_format), BGFX_TEXTURE_NONE))
-                {
-                    texture_handle = bgfx::createTexture2D(
-                            uint16_t(image_container.m_width),
-                            uint16_t(image_container.m_height),
-                            false,
-                            image_container.m_numLayers,
-                            static_cast<bgfx::TextureFormat::Enum>(image_container.m_format),
-                            BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE,
-                            bgfx::copy(image_container.m_data, image_container.m_size)
-                    );
-                }
+                image.width = static_cast<uint16_t>(image_container->m_width);
+                image.height = static_cast<uint16_t>(image_container->m_height);
+                image.num_layers = image_container->m_numLayers;
+                image.num_mips = image_container->m_numMips;
+                image.format = static_cast<bgfx::TextureFormat::Enum>(image_container->m_format);
 
-                texture_size_bytes_ = image_container.m_size;
+                const auto* first = static_cast<const uint8_t*>(image_container->m_data);
+                image.pixels.assign(first, first + image_container->m_size);
 
-                bimg::imageFree(&image_container);
+                bimg::imageFree(image_container);
             }
             else
             {
-                // EXTENDED (SDL_Image) 加载路径 - 关键修复
-                SDL_IOStream* stream = SDL_IOFromConstMem(raw_data.data(), static_cast<int>(raw_data.size()));
+                SDL_IOStream* stream = SDL_IOFromConstMem(data, size);
                 if (!stream)
                 {
                     throw exception::resourcesexception::ResourceManagerIOException("Failed to create SDL_IOStream from memory.");
@@ -77,31 +160,73 @@ namespace cyanvne
                             "SDL_image failed to load image: " + std::string(SDL_GetError()));
                 }
 
-                SDL_Surface* converted_surface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
-                SDL_DestroySurface(surface);
+                image.width = static_cast<uint16_t>(surface->w);
+                image.height = static_cast<uint16_t>(surface->h);
+                image.format = bgfx::TextureFormat::RGBA8;
+                image.pixels.resize(static_cast<size_t>(surface->w) * surface->h * 4);
 
-                if (!converted_surface)
+                // The staging buffer is what bgfx receives, so converting straight into it is the only pass
+                if (!convert_surface_rows(surface, image.pixels.data()))
                 {
-                    throw exception::resourcesexception::ResourceManagerIOException("Failed to convert surface to ABGR8888.");
+                    SDL_Surface* converted_surface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+                    SDL_DestroySurface(surface);
+
+                    if (!converted_surface)
+                    {
+                        throw exception::resourcesexception::ResourceManagerIOException("Failed to convert surface to RGBA32.");
+                    }
+                    surface = converted_surface;
+                    convert_surface_rows(surface, image.pixels.data());
                 }
-                surface = converted_surface;
 
-                const bgfx::Memory* mem = bgfx::copy(surface->pixels, surface->w * surface->h * 4);
+                SDL_DestroySurface(surface);
+            }
 
-                texture_handle = bgfx::createTexture2D(
-                        static_cast<uint16_t>(surface->w), static_cast<uint16_t>(surface->h),
-                        false, 1, bgfx::TextureFormat::RGBA8,
-                        BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem
-                );
+            return image;
+        }
 
-                texture_size_bytes_ = mem->size;
-                SDL_DestroySurface(surface);
+        TextureResource::TextureResource(const std::vector<uint8_t>& raw_data, ImageLoader loader)
+            : unique_id_(next_texture_id.fetch_add(1, std::memory_order_relaxed)),
+              staging_(decodeImage(raw_data.data(), raw_data.size(), loader))
+        {
+            texture_size_bytes_ = static_cast<uint32_t>(staging_.pixels.size());
+        }
+
+        uint32_t TextureResource::upload()
+        {
+            if (uploaded_.load(std::memory_order_acquire))
+            {
+                return 0;
             }
 
+            if (!bgfx::isTextureValid(0, staging_.num_mips > 1, staging_.num_layers, staging_.format, BGFX_TEXTURE_NONE))
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Decoded image format is not supported by the renderer.");
+            }
+
+            // bgfx reads the pixels on the render thread, hand the staging buffer over instead of copying it
+            SharedPixels pixels;
+            const bgfx::Memory* mem = make_pixel_ref(staging_.pixels, pixels);
+
+            texture_handle = bgfx::createTexture2D(
+                    staging_.width,
+                    staging_.height,
+                    staging_.num_mips > 1,
+                    staging_.num_layers,
+                    staging_.format,
+                    BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE,
+                    mem
+            );
+
             if (!bgfx::isValid(texture_handle))
             {
+                // Keeps the staging data so the upload can be retried
+                staging_.pixels = *pixels;
                 throw exception::resourcesexception::ResourceManagerIOException("Failed to create a valid bgfx texture.");
             }
+
+            uploaded_.store(true, std::memory_order_release);
+            return texture_size_bytes_;
         }
 
         TextureResource::~TextureResource()
@@ -110,6 +235,32 @@ namespace cyanvne
             {
                 bgfx::destroy(texture_handle);
             }
+
+            TextureDestroyListeners& destroy_listeners = texture_destroy_listeners();
+            std::lock_guard<std::mutex> lock(destroy_listeners.mutex);
+            for (const auto& [id, listener] : destroy_listeners.listeners)
+            {
+                listener(unique_id_);
+            }
+        }
+
+        uint64_t TextureResource::addDestroyListener(DestroyListener listener)
+        {
+            TextureDestroyListeners& destroy_listeners = texture_destroy_listeners();
+            std::lock_guard<std::mutex> lock(destroy_listeners.mutex);
+            const uint64_t id = destroy_listeners.next_id++;
+            destroy_listeners.listeners.emplace_back(id, std::move(listener));
+            return id;
+        }
+
+        void TextureResource::removeDestroyListener(uint64_t listener_id)
+        {
+            TextureDestroyListeners& destroy_listeners = texture_destroy_listeners();
+            std::lock_guard<std::mutex> lock(destroy_listeners.mutex);
+            std::erase_if(destroy_listeners.listeners, [listener_id](const auto& entry)
+            {
+                return entry.first == listener_id;
+            });
         }
 
         size_t TextureResource::getSizeInBytes() const
@@ -117,6 +268,203 @@ namespace cyanvne
             return texture_size_bytes_;
         }
 
+        namespace
+        {
+            // 2x2 box filter on RGBA8, odd edges repeat their last texel
+            DecodedImage downsample_rgba8(const DecodedImage& source)
+            {
+                DecodedImage result;
+                result.width = static_cast<uint16_t>(std::max(1, source.width / 2));
+                result.height = static_cast<uint16_t>(std::max(1, source.height / 2));
+                result.format = bgfx::TextureFormat::RGBA8;
+                result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+                const size_t src_pitch = static_cast<size_t>(source.width) * 4;
+                for (uint32_t y = 0; y < result.height; ++y)
+                {
+                    const uint32_t y0 = std::min<uint32_t>(y * 2, source.height - 1);
+                    const uint32_t y1 = std::min<uint32_t>(y * 2 + 1, source.height - 1);
+                    const uint8_t* row0 = source.pixels.data() + y0 * src_pitch;
+                    const uint8_t* row1 = source.pixels.data() + y1 * src_pitch;
+                    uint8_t* dst = result.pixels.data() + static_cast<size_t>(y) * result.width * 4;
+
+                    for (uint32_t x = 0; x < result.width; ++x)
+                    {
+                        const uint32_t x0 = std::min<uint32_t>(x * 2, source.width - 1) * 4;
+                        const uint32_t x1 = std::min<uint32_t>(x * 2 + 1, source.width - 1) * 4;
+                        for (uint32_t c = 0; c < 4; ++c)
+                        {
+                            const uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                            dst[x * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                        }
+                    }
+                }
+                return result;
+            }
+        }
+
+        std::vector<DecodedImage> decodeImageMipChain(const uint8_t* data, size_t size, ImageLoader loader, uint16_t min_dimension)
+        {
+            std::vector<DecodedImage> levels;
+
+            if (loader == ImageLoader::INTERNAL)
+            {
+                if (data == nullptr || size == 0)
+                {
+                    throw exception::resourcesexception::ResourceManagerIOException("Cannot create texture from empty data.");
+                }
+
+                bx::DefaultAllocator allocator;
+                bx::Error err;
+
+                bimg::ImageContainer* image_container = bimg::imageParse(&allocator, data, static_cast<uint32_t>(size),
+                                                                         bimg::TextureFormat::Count, &err);
+                if (image_container == nullptr)
+                {
+                    throw exception::resourcesexception::ResourceManagerIOException("bimg failed to parse image data.");
+                }
+
+                // Use the stored chain when the pack already carries one
+                if (image_container->m_numMips > 1 && image_container->m_numLayers == 1 && !image_container->m_cubeMap)
+                {
+                    for (uint8_t lod = 0; lod < image_container->m_numMips; ++lod)
+                    {
+                        bimg::ImageMip mip;
+                        if (!bimg::imageGetRawData(*image_container, 0, lod, image_container->m_data,
+                                                   image_container->m_size, mip))
+                        {
+                            break;
+                        }
+
+                        DecodedImage level;
+                        level.width = static_cast<uint16_t>(mip.m_width);
+                        level.height = static_cast<uint16_t>(mip.m_height);
+                        level.format = static_cast<bgfx::TextureFormat::Enum>(mip.m_format);
+                        level.pixels.assign(mip.m_data, mip.m_data + mip.m_size);
+                        levels.push_back(std::move(level));
+                    }
+                    bimg::imageFree(image_container);
+
+                    if (levels.empty())
+                    {
+                        throw exception::resourcesexception::ResourceManagerIOException("bimg failed to read image mip chain.");
+                    }
+                    return levels;
+                }
+
+                bimg::ImageContainer* rgba = image_container;
+                if (image_container->m_format != bimg::TextureFormat::RGBA8)
+                {
+                    rgba = bimg::imageConvert(&allocator, bimg::TextureFormat::RGBA8, *image_container, false);
+                    bimg::imageFree(image_container);
+                    if (rgba == nullptr)
+                    {
+                        throw exception::resourcesexception::ResourceManagerIOException("bimg failed to convert image to RGBA8.");
+                    }
+                }
+
+                DecodedImage level;
+                level.width = static_cast<uint16_t>(rgba->m_width);
+                level.height = static_cast<uint16_t>(rgba->m_height);
+                level.format = bgfx::TextureFormat::RGBA8;
+                const auto* first = static_cast<const uint8_t*>(rgba->m_data);
+                level.pixels.assign(first, first + static_cast<size_t>(level.width) * level.height * 4);
+                bimg::imageFree(rgba);
+                levels.push_back(std::move(level));
+            }
+            else
+            {
+                levels.push_back(decodeImage(data, size, loader));
+            }
+
+            while (levels.back().width > min_dimension || levels.back().height > min_dimension)
+            {
+                if (levels.back().width == 1 && levels.back().height == 1)
+                {
+                    break;
+                }
+                levels.push_back(downsample_rgba8(levels.back()));
+            }
+            return levels;
+        }
+
+        StreamingTextureResource::StreamingTextureResource(const std::vector<uint8_t>& raw_data, ImageLoader loader)
+            : levels_(decodeImageMipChain(raw_data.data(), raw_data.size(), loader))
+        {
+            resident_level_ = levels_.size();
+
+            size_t size_bytes = 0;
+            for (const auto& level : levels_)
+            {
+                size_bytes += level.pixels.size();
+            }
+            size_bytes_.store(size_bytes, std::memory_order_relaxed);
+        }
+
+        StreamingTextureResource::~StreamingTextureResource()
+        {
+            if (bgfx::isValid(texture_handle))
+            {
+                bgfx::destroy(texture_handle);
+            }
+        }
+
+        uint32_t StreamingTextureResource::uploadNextLevel()
+        {
+            if (isFullyResident())
+            {
+                return 0;
+            }
+
+            DecodedImage& level = levels_[resident_level_ - 1];
+            if (!bgfx::isTextureValid(0, false, 1, level.format, BGFX_TEXTURE_NONE))
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Decoded image format is not supported by the renderer.");
+            }
+
+            SharedPixels pixels;
+            const bgfx::Memory* mem = make_pixel_ref(level.pixels, pixels);
+            const auto bytes = static_cast<uint32_t>(pixels->size());
+
+            bgfx::TextureHandle refined = bgfx::createTexture2D(level.width, level.height, false, 1, level.format,
+                                                                BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem);
+            if (!bgfx::isValid(refined))
+            {
+                level.pixels = *pixels;
+                throw exception::resourcesexception::ResourceManagerIOException("Failed to create a valid bgfx texture.");
+            }
+
+            // bgfx defers the destruction past the current frame, draws already submitted stay valid
+            if (bgfx::isValid(texture_handle))
+            {
+                bgfx::destroy(texture_handle);
+            }
+            texture_handle = refined;
+            --resident_level_;
+
+            // The new level only moved to bgfx, the replaced one is gone
+            size_bytes_.fetch_sub(resident_bytes_, std::memory_order_relaxed);
+            resident_bytes_ = bytes;
+
+            // Smaller levels can never be needed again
+            for (size_t i = resident_level_ + 1; i < levels_.size(); ++i)
+            {
+                levels_[i].pixels.clear();
+                levels_[i].pixels.shrink_to_fit();
+            }
+            return bytes;
+        }
+
+        uint32_t StreamingTextureResource::getNextLevelBytes() const
+        {
+            return isFullyResident() ? 0 : static_cast<uint32_t>(levels_[resident_level_ - 1].pixels.size());
+        }
+
+        size_t StreamingTextureResource::getSizeInBytes() const
+        {
+            return size_bytes_.load(std::memory_order_relaxed);
+        }
+
         SoLoudWavResource::SoLoudWavResource(const std::vector<uint8_t>& raw_data)
         {
             SoLoud::result res = sound.loadMem(
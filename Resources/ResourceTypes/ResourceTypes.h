@@ -1,6 +1,8 @@
 #pragma once
 #include <Resources/ICachedResource/ICachedResource.h>
 #include <vector>
+#include <atomic>
+#include <functional>
 #include <Resources/ResourcesManager/ResourcesManager.h>
 #include <soloud_wav.h>
 #include <bgfx/bgfx.h>
@@ -26,16 +28,131 @@ namespace cyanvne
             size_t getSizeInBytes() const override;
         };
 
+        // CPU side pixels produced by a decoder, laid out the way bgfx::createTexture2D expects them
+        struct DecodedImage
+        {
+            uint16_t width = 0;
+            uint16_t height = 0;
+            uint16_t num_layers = 1;
+            uint8_t num_mips = 1;
+            bgfx::TextureFormat::Enum format = bgfx::TextureFormat::Unknown;
+            std::vector<uint8_t> pixels;
+        };
+
+        // Thread safe, does not touch bgfx. Throws ResourceManagerIOException on failure
+        DecodedImage decodeImage(const uint8_t* data, size_t size, ImageLoader loader = ImageLoader::INTERNAL);
+
         class TextureResource : public ICachedResource
         {
         private:
             uint32_t texture_size_bytes_ = 0;
+            uint64_t unique_id_;
+
+            // Released to bgfx by upload()
+            DecodedImage staging_;
+            std::atomic<bool> uploaded_ = false;
         public:
             bgfx::TextureHandle texture_handle = BGFX_INVALID_HANDLE;
 
+            // Only decodes, may run on any thread. The GPU texture is created by upload()
             explicit TextureResource(const std::vector<uint8_t>& raw_data,
                                      ImageLoader loader = ImageLoader::INTERNAL);
             ~TextureResource() override;
+
+            /**
+             * @brief Creates the bgfx texture from the staging buffer. Must be called on the main thread.
+             * @return Bytes handed to bgfx, 0 if the texture was already uploaded.
+             */
+            uint32_t upload();
+            bool isUploaded() const
+            {
+                return uploaded_.load(std::memory_order_acquire);
+            }
+            uint32_t getPendingUploadBytes() const
+            {
+                return isUploaded() ? 0 : texture_size_bytes_;
+            }
+
+            // Never reused, unlike bgfx handles, so it can key caches derived from this texture
+            uint64_t getUniqueId() const
+            {
+                return unique_id_;
+            }
+
+            // Called with the unique id from the destructor, on whichever thread drops the last handle
+            using DestroyListener = std::function<void(uint64_t unique_id)>;
+            static uint64_t addDestroyListener(DestroyListener listener);
+            static void removeDestroyListener(uint64_t listener_id);
+            uint16_t getWidth() const
+            {
+                return staging_.width;
+            }
+            uint16_t getHeight() const
+            {
+                return staging_.height;
+            }
+            uint16_t getNumLayers() const
+            {
+                return staging_.num_layers;
+            }
+            bgfx::TextureFormat::Enum getFormat() const
+            {
+                return staging_.format;
+            }
+
+            size_t getSizeInBytes() const override;
+        };
+
+        /**
+         * @brief Decodes an image into a chain of progressively halved levels.
+         * Mip chains stored in the pack (KTX, DDS) are used as they are, anything else is converted to
+         * RGBA8 and box filtered. Thread safe, does not touch bgfx.
+         * @param min_dimension Downsampling stops once both sides are at or below this size.
+         * @return Levels ordered from full resolution down to the smallest one, each with num_mips == 1.
+         */
+        std::vector<DecodedImage> decodeImageMipChain(const uint8_t* data, size_t size,
+                                                      ImageLoader loader = ImageLoader::INTERNAL,
+                                                      uint16_t min_dimension = 64);
+
+        /**
+         * @brief Texture that becomes drawable as soon as its smallest level is on the GPU.
+         * Each uploadNextLevel() call replaces the bgfx texture with the next larger level, so
+         * texture_handle must be re-read every frame. UVs stay valid across levels.
+         */
+        class StreamingTextureResource : public ICachedResource
+        {
+        private:
+            // Levels still decoded plus the level on the GPU, read by the cache from any thread
+            std::atomic<size_t> size_bytes_ = 0;
+            uint32_t resident_bytes_ = 0;
+
+            // Full resolution first, pixels are released once a level has been replaced by a larger one
+            std::vector<DecodedImage> levels_;
+            // Index into levels_ of the level currently on the GPU, levels_.size() while nothing is resident
+            size_t resident_level_ = 0;
+        public:
+            bgfx::TextureHandle texture_handle = BGFX_INVALID_HANDLE;
+
+            explicit StreamingTextureResource(const std::vector<uint8_t>& raw_data,
+                                              ImageLoader loader = ImageLoader::INTERNAL);
+            ~StreamingTextureResource() override;
+
+            /**
+             * @brief Uploads the next larger level and swaps it in. Must be called on the main thread.
+             * @return Bytes handed to bgfx, 0 once the full resolution level is resident.
+             */
+            uint32_t uploadNextLevel();
+
+            bool hasResidentLevel() const
+            {
+                return resident_level_ < levels_.size();
+            }
+            bool isFullyResident() const
+            {
+                return resident_level_ == 0;
+            }
+            uint32_t getNextLevelBytes() const;
+
             size_t getSizeInBytes() const override;
         };
 
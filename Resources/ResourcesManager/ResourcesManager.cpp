@@ -51,9 +51,46 @@ namespace cyanvne
                 throw exception::resourcesexception::ResourceManagerIOException("Failed to deserialize alias_to_id_ map.");
             }
 
+            shared_reader_ = path_to_stream_->getPositionalInStream(resource_file_path_);
+            if (shared_reader_ && !shared_reader_->is_open())
+            {
+                shared_reader_.reset();
+            }
+            if (!shared_reader_)
+            {
+                releasePooledStream(std::move(in_stream));
+            }
+
             initialized_ = true;
         }
 
+        std::shared_ptr<core::stream::InStreamInterface> ResourcesManager::acquirePooledStream() const
+        {
+            {
+                std::lock_guard<std::mutex> lock(stream_pool_mutex_);
+                if (!idle_streams_.empty())
+                {
+                    auto stream = std::move(idle_streams_.back());
+                    idle_streams_.pop_back();
+                    return stream;
+                }
+            }
+            return path_to_stream_->getInStream(resource_file_path_);
+        }
+
+        void ResourcesManager::releasePooledStream(std::shared_ptr<core::stream::InStreamInterface> stream) const
+        {
+            if (!stream || !stream->is_open())
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(stream_pool_mutex_);
+            if (idle_streams_.size() < MAX_POOLED_STREAMS)
+            {
+                idle_streams_.push_back(std::move(stream));
+            }
+        }
+
         const ResourceDefinition* ResourcesManager::getDefinitionById(uint64_t id) const
         {
             if (!initialized_)
@@ -101,16 +138,28 @@ namespace cyanvne
             std::vector<uint8_t> data_buffer(def->size);
             if (def->size > 0)
             {
-                auto in_stream = path_to_stream_->getInStream(resource_file_path_);
-                if (!in_stream || !in_stream->is_open())
+                size_t bytes_actually_read = 0;
+                if (shared_reader_)
                 {
-                    throw exception::resourcesexception::ResourceManagerIOException("Input stream is not available for reading resource data.");
+                    bytes_actually_read = core::stream::utils::read_exact_at(*shared_reader_, data_buffer.data(),
+                                                                             static_cast<size_t>(def->size), def->offset);
                 }
-                if (in_stream->seek(static_cast<int64_t>(def->offset), core::stream::SeekMode::Begin) == -1)
+                else
                 {
-                    throw exception::resourcesexception::ResourceManagerIOException("Failed to seek to resource offset for ID: " + std::to_string(id) + ".");
+                    auto in_stream = acquirePooledStream();
+                    if (!in_stream || !in_stream->is_open())
+                    {
+                        throw exception::resourcesexception::ResourceManagerIOException("Input stream is not available for reading resource data.");
+                    }
+                    if (in_stream->seek(static_cast<int64_t>(def->offset), core::stream::SeekMode::Begin) == -1)
+                    {
+                        // Every read seeks from the beginning, the handle is still fine for the next caller
+                        releasePooledStream(std::move(in_stream));
+                        throw exception::resourcesexception::ResourceManagerIOException("Failed to seek to resource offset for ID: " + std::to_string(id) + ".");
+                    }
+                    bytes_actually_read = in_stream->read(data_buffer.data(), def->size);
+                    releasePooledStream(std::move(in_stream));
                 }
-                size_t bytes_actually_read = in_stream->read(data_buffer.data(), def->size);
                 if (bytes_actually_read != def->size)
                 {
                     throw exception::resourcesexception::ResourceManagerIOException("Failed to read complete resource data for ID: " + std::to_string(id) + ". Expected " + std::to_string(def->size) + " bytes, Got " + std::to_string(bytes_actually_read) + " bytes.");
@@ -137,6 +186,12 @@ namespace cyanvne
                 throw exception::resourcesexception::ResourceManagerIOException("Resource not found for ID: " + std::to_string(id) + ".");
             }
 
+            if (shared_reader_)
+            {
+                return std::make_shared<core::stream::PositionalSubStream>(shared_reader_, def->offset, def->size);
+            }
+
+            // Sub streams own their parent for their whole lifetime, so they get a dedicated handle
             auto full_stream = path_to_stream_->getInStream(resource_file_path_);
             if (!full_stream || !full_stream->is_open())
             {
@@ -164,5 +219,84 @@ namespace cyanvne
             }
             return definitions_;
         }
+
+        bool ResourcesManager::enableAsyncIO(const boost::asio::any_io_executor& executor)
+        {
+            if (!initialized_)
+            {
+                throw exception::IllegalStateException("ResourcesManager not initialized, cannot enable async IO.");
+            }
+
+            auto async_stream = path_to_stream_->getAsyncInStream(resource_file_path_, executor);
+            if (!async_stream || !async_stream->is_open())
+            {
+                return false;
+            }
+
+            async_stream_ = std::move(async_stream);
+            return true;
+        }
+
+        boost::asio::awaitable<std::vector<uint8_t>> ResourcesManager::getResourceDataByIdAsync(uint64_t id) const
+        {
+            if (!async_stream_)
+            {
+                co_return getResourceDataById(id);
+            }
+
+            const ResourceDefinition* def = getDefinitionById(id);
+            if (!def)
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Resource not found for ID: " + std::to_string(id) + ".");
+            }
+
+            std::vector<uint8_t> data_buffer(def->size);
+            if (def->size > 0)
+            {
+                size_t bytes_actually_read = co_await core::stream::utils::async_read_exact(
+                        *async_stream_, data_buffer.data(), static_cast<size_t>(def->size), def->offset);
+                if (bytes_actually_read != def->size)
+                {
+                    throw exception::resourcesexception::ResourceManagerIOException("Failed to read complete resource data for ID: " + std::to_string(id) + ". Expected " + std::to_string(def->size) + " bytes, Got " + std::to_string(bytes_actually_read) + " bytes.");
+                }
+            }
+            co_return data_buffer;
+        }
+
+        boost::asio::awaitable<std::vector<uint8_t>> ResourcesManager::getResourceDataByAliasAsync(const std::string& alias) const
+        {
+            const ResourceDefinition* def = getDefinitionByAlias(alias);
+            if (!def)
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Resource not found for alias: " + alias + ".");
+            }
+            co_return co_await getResourceDataByIdAsync(def->id);
+        }
+
+        std::shared_ptr<core::stream::AsyncInStreamInterface> ResourcesManager::openAsyncResourceStreamById(uint64_t id) const
+        {
+            if (!async_stream_)
+            {
+                throw exception::IllegalStateException("Async IO is not enabled for this ResourcesManager.");
+            }
+
+            const ResourceDefinition* def = getDefinitionById(id);
+            if (!def)
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Resource not found for ID: " + std::to_string(id) + ".");
+            }
+
+            return std::make_shared<core::stream::AsyncSubStream>(async_stream_, def->offset, def->size);
+        }
+
+        std::shared_ptr<core::stream::AsyncInStreamInterface> ResourcesManager::openAsyncResourceStreamByAlias(const std::string& alias) const
+        {
+            const ResourceDefinition* def = getDefinitionByAlias(alias);
+            if (!def)
+            {
+                throw exception::resourcesexception::ResourceManagerIOException("Resource not found for alias: " + alias + ".");
+            }
+            return openAsyncResourceStreamById(def->id);
+        }
     }
 }
\ No newline at end of file
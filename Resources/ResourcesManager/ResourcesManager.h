@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/Stream/Stream.h>
+#include <Core/Stream/AsyncStream.h>
 #include <Resources/ResourcesDefination/ResourcesDefination.h>
 #include <Core/PathToStream/PathToStream.h>
 #include <vector>
@@ -8,6 +9,8 @@
 #include <map>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <boost/asio/any_io_executor.hpp>
 
 namespace cyanvne
 {
@@ -25,9 +28,21 @@ namespace cyanvne
             std::map<uint64_t, uint64_t> id_to_definition_index_;
             std::map<std::string, uint64_t> alias_to_id_;
 
+            std::shared_ptr<core::stream::AsyncInStreamInterface> async_stream_;
+
+            // One descriptor shared by every reader when the provider supports positional reads
+            std::shared_ptr<core::stream::PositionalInStreamInterface> shared_reader_;
+
+            // Otherwise idle seekable handles are recycled instead of reopening the pack per read
+            static constexpr size_t MAX_POOLED_STREAMS = 8;
+            mutable std::mutex stream_pool_mutex_;
+            mutable std::vector<std::shared_ptr<core::stream::InStreamInterface>> idle_streams_;
+
             bool initialized_ = false;
 
             void loadDefinitions();
+            std::shared_ptr<core::stream::InStreamInterface> acquirePooledStream() const;
+            void releasePooledStream(std::shared_ptr<core::stream::InStreamInterface> stream) const;
         public:
             explicit ResourcesManager(const std::string& resource_file_path, std::shared_ptr<core::IPathToStream> path_to_stream);
             ~ResourcesManager() = default;
@@ -49,6 +64,20 @@ namespace cyanvne
             std::shared_ptr<core::stream::InStreamInterface> openResourceStreamByAlias(const std::string& alias) const;
 
             const std::vector<ResourceDefinition>& getAllDefinitions() const;
+
+            /**
+             * @brief Opens the pack for positional async reads on the given executor (usually the UCM IO context).
+             * @return false when the IPathToStream provider has no async support, the async getters then fall back to blocking reads.
+             */
+            bool enableAsyncIO(const boost::asio::any_io_executor& executor);
+            bool isAsyncIOEnabled() const { return async_stream_ != nullptr; }
+
+            // The manager must outlive the returned awaitables
+            boost::asio::awaitable<std::vector<uint8_t>> getResourceDataByIdAsync(uint64_t id) const;
+            boost::asio::awaitable<std::vector<uint8_t>> getResourceDataByAliasAsync(const std::string& alias) const;
+
+            std::shared_ptr<core::stream::AsyncInStreamInterface> openAsyncResourceStreamById(uint64_t id) const;
+            std::shared_ptr<core::stream::AsyncInStreamInterface> openAsyncResourceStreamByAlias(const std::string& alias) const;
         };
     }
 }
\ No newline at end of file
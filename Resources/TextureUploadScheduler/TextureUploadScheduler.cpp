@@ -0,0 +1,98 @@
+#include "TextureUploadScheduler.h"
+#include "Core/Logger/Logger.h"
+#include <chrono>
+#include <exception>
+
+namespace cyanvne
+{
+    namespace resources
+    {
+        TextureUploadScheduler::TextureUploadScheduler(Budget budget) : budget_(budget)
+        {  }
+
+        void TextureUploadScheduler::enqueue(uint64_t estimated_bytes, UploadJob job, bool urgent)
+        {
+            if (!job)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (urgent)
+            {
+                queue_.push_front({ estimated_bytes, std::move(job) });
+            }
+            else
+            {
+                queue_.push_back({ estimated_bytes, std::move(job) });
+            }
+        }
+
+        const TextureUploadScheduler::FrameStats& TextureUploadScheduler::processFrame()
+        {
+            last_frame_stats_ = FrameStats();
+
+            Budget budget = getBudget();
+            const auto frame_start = std::chrono::steady_clock::now();
+
+            while (true)
+            {
+                PendingJob pending;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    if (queue_.empty())
+                    {
+                        break;
+                    }
+
+                    // Always let the first job through, otherwise a texture larger than the budget never uploads
+                    if (last_frame_stats_.jobs_executed > 0 &&
+                        last_frame_stats_.bytes_uploaded + queue_.front().estimated_bytes > budget.max_bytes_per_frame)
+                    {
+                        break;
+                    }
+
+                    pending = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+
+                try
+                {
+                    last_frame_stats_.bytes_uploaded += pending.job();
+                }
+                catch (const std::exception& e)
+                {
+                    core::GlobalLogger::getCoreLogger()->error("Texture upload job failed: {}", e.what());
+                }
+                ++last_frame_stats_.jobs_executed;
+
+                last_frame_stats_.milliseconds_spent = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - frame_start).count();
+                if (last_frame_stats_.milliseconds_spent >= budget.max_milliseconds_per_frame)
+                {
+                    break;
+                }
+            }
+
+            return last_frame_stats_;
+        }
+
+        void TextureUploadScheduler::setBudget(const Budget& budget)
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            budget_ = budget;
+        }
+
+        TextureUploadScheduler::Budget TextureUploadScheduler::getBudget() const
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            return budget_;
+        }
+
+        size_t TextureUploadScheduler::getPendingCount() const
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            return queue_.size();
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace cyanvne
+{
+    namespace resources
+    {
+        /**
+         * @brief Spreads GPU uploads over several frames.
+         * Jobs are queued from any thread and drained on the main thread by processFrame() until the
+         * per-frame byte or time budget is spent. At least one job runs per frame so a single oversized
+         * texture can never stall the queue.
+         */
+        class TextureUploadScheduler
+        {
+        public:
+            // Performs the upload on the main thread and returns the number of bytes handed to bgfx
+            using UploadJob = std::function<uint64_t()>;
+
+            struct Budget
+            {
+                uint64_t max_bytes_per_frame = 8ull * 1024 * 1024;
+                double max_milliseconds_per_frame = 2.0;
+            };
+
+            struct FrameStats
+            {
+                uint32_t jobs_executed = 0;
+                uint64_t bytes_uploaded = 0;
+                double milliseconds_spent = 0.0;
+            };
+        private:
+            struct PendingJob
+            {
+                uint64_t estimated_bytes;
+                UploadJob job;
+            };
+
+            Budget budget_;
+            std::deque<PendingJob> queue_;
+            mutable std::mutex queue_mutex_;
+            FrameStats last_frame_stats_;
+
+        public:
+            explicit TextureUploadScheduler(Budget budget = Budget());
+            ~TextureUploadScheduler() = default;
+
+            TextureUploadScheduler(const TextureUploadScheduler&) = delete;
+            TextureUploadScheduler& operator=(const TextureUploadScheduler&) = delete;
+            TextureUploadScheduler(TextureUploadScheduler&&) = delete;
+            TextureUploadScheduler& operator=(TextureUploadScheduler&&) = delete;
+
+            // Thread safe. Urgent jobs skip ahead of everything already queued
+            void enqueue(uint64_t estimated_bytes, UploadJob job, bool urgent = false);
+
+            // Main thread only
+            const FrameStats& processFrame();
+
+            void setBudget(const Budget& budget);
+            Budget getBudget() const;
+
+            size_t getPendingCount() const;
+            const FrameStats& getLastFrameStats() const
+            {
+                return last_frame_stats_;
+            }
+        };
+    }
+}
@@ -77,7 +77,10 @@ namespace cyanvne
             TextureHandle getTexture(const std::string& alias) const
             {
                 if (!initialized_) throw exception::resourcesexception::ResourceManagerIOException("ThemeResourcesManager is not initialized.");
-                return cache_manager_->get<TextureResource>(alias);
+                // Theme textures are requested from the main thread and used right away, skip the scheduler
+                TextureHandle texture = cache_manager_->get<TextureResource>(alias);
+                texture->upload();
+                return texture;
             }
 
             DataHandle getData(const std::string& alias) const
@@ -25,6 +25,11 @@ namespace cyanvne
             if (it != cache_map_.end() && it->second.ref_count > 0)
             {
                 it->second.ref_count--;
+
+                // Streaming textures shrink while they are held, charge what they use now
+                const size_t size_bytes = it->second.resource->getSizeInBytes();
+                current_size_bytes_ = current_size_bytes_ - it->second.size_bytes + size_bytes;
+                it->second.size_bytes = size_bytes;
             }
         }
 
@@ -46,7 +51,7 @@ namespace cyanvne
 
         void UnifiedCacheManager::evictEntry(const CacheIterator& it)
         {
-            current_size_bytes_ -= it->second.resource->getSizeInBytes();
+            current_size_bytes_ -= it->second.size_bytes;
             if (it->second.location == CacheLocation::IN_A1)
             {
                 a1_in_queue_.erase(it->second.queue_iterator);
@@ -138,6 +143,7 @@ namespace cyanvne
             CacheEntry new_entry;
             new_entry.resource = std::move(new_resource);
             new_entry.ref_count = 1;
+            new_entry.size_bytes = resource_size;
             new_entry.location = CacheLocation::IN_A1;
             new_entry.queue_iterator = a1_in_queue_.begin();
 
@@ -192,6 +198,7 @@ namespace cyanvne
             CacheEntry new_entry;
             new_entry.resource = std::move(new_resource);
             new_entry.ref_count = 1;
+            new_entry.size_bytes = resource_size;
             new_entry.location = CacheLocation::IN_A1;
             new_entry.queue_iterator = a1_in_queue_.begin();
 
@@ -263,6 +270,13 @@ namespace cyanvne
             return loadResource(id, ImageLoader::INTERNAL);
         }
 
+        template<>
+        inline std::unique_ptr<StreamingTextureResource> UnifiedCacheManager::loadResource<StreamingTextureResource>(uint64_t id)
+        {
+            auto raw_data_handle = get<RawDataResource>(id);
+            return std::make_unique<StreamingTextureResource>(raw_data_handle->data, ImageLoader::INTERNAL);
+        }
+
         template<>
         inline std::unique_ptr<SoLoudWavResource> UnifiedCacheManager::loadResource<SoLoudWavResource>(uint64_t id)
         {
@@ -272,10 +286,12 @@ namespace cyanvne
 
         template ResourceHandle<RawDataResource> UnifiedCacheManager::get<RawDataResource>(uint64_t);
         template ResourceHandle<TextureResource> UnifiedCacheManager::get<TextureResource>(uint64_t);
+        template ResourceHandle<StreamingTextureResource> UnifiedCacheManager::get<StreamingTextureResource>(uint64_t);
         template ResourceHandle<SoLoudWavResource> UnifiedCacheManager::get<SoLoudWavResource>(uint64_t);
 
         template ResourceHandle<RawDataResource> UnifiedCacheManager::get<RawDataResource>(const std::string&);
         template ResourceHandle<TextureResource> UnifiedCacheManager::get<TextureResource>(const std::string&);
+        template ResourceHandle<StreamingTextureResource> UnifiedCacheManager::get<StreamingTextureResource>(const std::string&);
         template ResourceHandle<SoLoudWavResource> UnifiedCacheManager::get<SoLoudWavResource>(const std::string&);
     }
 }
\ No newline at end of file
@@ -70,6 +70,8 @@ namespace cyanvne
                 std::unique_ptr<ICachedResource> resource;
                 std::list<uint64_t>::iterator queue_iterator;
                 size_t ref_count = 0;
+                // Bytes counted in current_size_bytes_, evicting subtracts this rather than the current size
+                size_t size_bytes = 0;
                 CacheLocation location;
             };
             using CacheIterator = std::unordered_map<uint64_t, CacheEntry>::iterator;
@@ -20,6 +20,11 @@ namespace cyanvne::runtime
     struct MeshComponent
     {
         uint32_t layer_mask = 1;
+        // Draw order bucket inside a camera when the renderer runs in deferred mode
+        uint8_t sort_layer = 0;
+        // Uploaded once into GPU buffers when the renderer has a StaticMeshCache.
+        // Edit through registry.patch<MeshComponent>() or replace() so the cached copy is invalidated
+        bool is_static = false;
 
         std::vector<MeshBatchRenderer::PosTexColorVertex> vertices;
         std::vector<uint32_t> indices;
@@ -44,25 +49,33 @@ namespace cyanvne::runtime
         {
             Unloaded,
             Loading,
+            // Decoded on a worker, waiting for its slot in the TextureUploadScheduler
+            Uploading,
             Loaded,
             Failed
         };
 
         std::string texture_atlas_alias;
         bool is_pinned = false;
+        // Draw from the smallest mip as soon as it is uploaded and refine over the following frames
+        bool is_streamed = false;
+        // No blending, lets the deferred renderer sort front-to-back
+        bool is_opaque = false;
 
         LoadState load_state = LoadState::Unloaded;
 
         using ResourceVariant = std::variant<std::monostate,
                                                 PinnedTexture,
-                                                resources::ResourceHandle<resources::TextureResource>>;
+                                                resources::ResourceHandle<resources::TextureResource>,
+                                                resources::ResourceHandle<resources::StreamingTextureResource>>;
         ResourceVariant resource_handle;
 
         glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
 
-        explicit MaterialComponent(std::string alias, bool pinned = false)
+        explicit MaterialComponent(std::string alias, bool pinned = false, bool streamed = false)
                 : texture_atlas_alias(std::move(alias)),
-                  is_pinned(pinned)
+                  is_pinned(pinned),
+                  is_streamed(streamed)
         {}
     };
 
@@ -76,6 +89,7 @@ namespace cyanvne::runtime
         bool loop = true;
     };
 
+    // Edit through registry.patch<TransformComponent>() or replace() so a TransformTracker recomputes the subtree
     struct TransformComponent
     {
         glm::vec2 position = { 0.0f, 0.0f };
@@ -83,6 +97,7 @@ namespace cyanvne::runtime
         float rotation = 0.0f;
     };
 
+    // Edit through registry.patch<HierarchyComponent>() or replace() so a TransformTracker picks up the new parent
     struct HierarchyComponent
     {
         entt::entity parent = entt::null;
@@ -105,10 +120,17 @@ namespace cyanvne::runtime
         glm::mat4 projection_matrix{1.0f};
 
         std::weak_ptr<platform::WindowContext> target_window;
+        // Used without a target window, the view then keeps its current frame buffer (the back buffer by default).
+        // Lets headless tools such as the render benchmark drive cameras
+        glm::uvec2 offscreen_size = { 0, 0 };
 
         glm::vec4 viewport_rect = { 0.0f, 0.0f, 1.0f, 1.0f };
 
         uint32_t culling_mask = 0xFFFFFFFF;
+
+        // Renders into a LayerCache target that is only refreshed when the camera or its visible entities change.
+        // Suited to backgrounds and stationary character composites, the target is transparent where nothing is drawn
+        bool is_cached = false;
     };
 
     struct AudioSourceComponent
@@ -118,6 +140,8 @@ namespace cyanvne::runtime
         float volume = 1.0f;
         bool loop = false;
         bool play_on_create = true;
+        // Keeps the FrameDirtyTracker rendering while the voice plays, for visuals that follow the audio
+        bool drives_visuals = false;
 
         audio::VoiceHandle voice_handle = 0;
     };
@@ -4,10 +4,13 @@ cyanvne::runtime::EcsGameState::EcsGameState() : scene_(std::make_unique<ecs::Sc
 {  }
 
 void cyanvne::runtime::EcsGameState::init(std::shared_ptr<GameStateManager> manager)
-{  }
+{
+    manager->getFrameDirtyTracker()->connect(registry_);
+}
 
 void cyanvne::runtime::EcsGameState::shutdown(std::shared_ptr<GameStateManager> manager)
 {
+    manager->getFrameDirtyTracker()->disconnect(registry_);
 }
 
 void cyanvne::runtime::EcsGameState::handle_events(std::shared_ptr<GameStateManager> manager)
@@ -0,0 +1,143 @@
+#include "FrameDirtyTracker.h"
+#include "Runtime/Components/Components.h"
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    namespace
+    {
+        template <typename Component, auto Candidate, typename Instance>
+        void connect_changes(entt::registry& registry, Instance& instance)
+        {
+            registry.on_construct<Component>().template connect<Candidate>(instance);
+            registry.on_update<Component>().template connect<Candidate>(instance);
+            registry.on_destroy<Component>().template connect<Candidate>(instance);
+        }
+
+        template <typename Component, auto Candidate, typename Instance>
+        void disconnect_changes(entt::registry& registry, Instance& instance)
+        {
+            registry.on_construct<Component>().template disconnect<Candidate>(instance);
+            registry.on_update<Component>().template disconnect<Candidate>(instance);
+            registry.on_destroy<Component>().template disconnect<Candidate>(instance);
+        }
+    }
+
+    FrameDirtyTracker::FrameDirtyTracker(uint32_t settle_frames)
+        : settle_frames_(std::max<uint32_t>(1, settle_frames)),
+          pending_frames_(settle_frames_)
+    {  }
+
+    FrameDirtyTracker::~FrameDirtyTracker()
+    {
+        disconnectAll();
+    }
+
+    void FrameDirtyTracker::connect(entt::registry& registry)
+    {
+        if (std::find(registries_.begin(), registries_.end(), &registry) != registries_.end())
+        {
+            return;
+        }
+
+        connect_changes<TransformComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        connect_changes<MaterialComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        connect_changes<MeshComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        connect_changes<CameraComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        registries_.push_back(&registry);
+        markDirty();
+    }
+
+    void FrameDirtyTracker::disconnect(entt::registry& registry)
+    {
+        auto it = std::find(registries_.begin(), registries_.end(), &registry);
+        if (it == registries_.end())
+        {
+            return;
+        }
+
+        disconnect_changes<TransformComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        disconnect_changes<MaterialComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        disconnect_changes<MeshComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        disconnect_changes<CameraComponent, &FrameDirtyTracker::onComponentChanged>(registry, *this);
+        registries_.erase(it);
+        markDirty();
+    }
+
+    void FrameDirtyTracker::disconnectAll()
+    {
+        while (!registries_.empty())
+        {
+            disconnect(*registries_.back());
+        }
+    }
+
+    void FrameDirtyTracker::onComponentChanged(entt::registry& registry, entt::entity entity)
+    {
+        markDirty();
+    }
+
+    void FrameDirtyTracker::markDirty()
+    {
+        pending_frames_ = settle_frames_;
+    }
+
+    bool FrameDirtyTracker::hasActiveContent(const entt::registry& registry) const
+    {
+        for (auto [entity, animation] : registry.view<const SpriteAnimationComponent>().each())
+        {
+            if (animation.is_playing && !animation.frames.empty())
+            {
+                return true;
+            }
+        }
+
+        for (auto [entity, material] : registry.view<const MaterialComponent>().each())
+        {
+            // Unloaded materials wait for a request and draw nothing, they must not keep an idle scene rendering.
+            // Loaded is only checked for streamed textures, each refined level has to reach the screen
+            if (material.load_state == MaterialComponent::LoadState::Loading ||
+                material.load_state == MaterialComponent::LoadState::Uploading)
+            {
+                return true;
+            }
+            if (const auto* streaming = std::get_if<resources::ResourceHandle<resources::StreamingTextureResource>>(&material.resource_handle))
+            {
+                if (*streaming && !(*streaming)->isFullyResident())
+                {
+                    return true;
+                }
+            }
+        }
+
+        for (auto [entity, source] : registry.view<const AudioSourceComponent>().each())
+        {
+            if (source.drives_visuals && source.voice_handle != 0 &&
+                (!voice_query_ || voice_query_(source.voice_handle)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FrameDirtyTracker::poll()
+    {
+        for (const entt::registry* registry : registries_)
+        {
+            if (hasActiveContent(*registry))
+            {
+                markDirty();
+                return;
+            }
+        }
+    }
+
+    void FrameDirtyTracker::frameRendered()
+    {
+        if (pending_frames_ > 0)
+        {
+            --pending_frames_;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Audio/IAudioEngine/IAudioEngine.h"
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Decides whether the main loop has to render and present a new frame.
+     * Connected registries mark the scene dirty when a TransformComponent, MaterialComponent, MeshComponent or
+     * CameraComponent is emplaced, patched, replaced or removed. Components edited in place through get<>()
+     * are not seen, call markDirty() after such edits. poll() keeps the scene dirty while sprite animations
+     * play, textures load or stream, and voices flagged drives_visuals are audible.
+     * Every dirty mark keeps rendering for a few settle frames, so ImGui hover and fade states can finish.
+     */
+    class FrameDirtyTracker
+    {
+    private:
+        std::vector<entt::registry*> registries_;
+        std::function<bool(audio::VoiceHandle)> voice_query_;
+        uint32_t settle_frames_;
+        uint32_t pending_frames_;
+        bool enabled_ = true;
+
+        void onComponentChanged(entt::registry& registry, entt::entity entity);
+        bool hasActiveContent(const entt::registry& registry) const;
+
+    public:
+        explicit FrameDirtyTracker(uint32_t settle_frames = 3);
+        ~FrameDirtyTracker();
+
+        FrameDirtyTracker(const FrameDirtyTracker&) = delete;
+        FrameDirtyTracker& operator=(const FrameDirtyTracker&) = delete;
+        FrameDirtyTracker(FrameDirtyTracker&&) = delete;
+        FrameDirtyTracker& operator=(FrameDirtyTracker&&) = delete;
+
+        // Each registry must outlive its connection, call disconnect() before destroying it
+        void connect(entt::registry& registry);
+        void disconnect(entt::registry& registry);
+        void disconnectAll();
+
+        // Tells whether a voice is still playing, without one drives_visuals voices count while their handle is set
+        void setVoiceQuery(std::function<bool(audio::VoiceHandle)> voice_query)
+        {
+            voice_query_ = std::move(voice_query);
+        }
+
+        // Disabled trackers render every frame
+        void setEnabled(bool enabled)
+        {
+            enabled_ = enabled;
+            markDirty();
+        }
+        bool isEnabled() const
+        {
+            return enabled_;
+        }
+
+        void markDirty();
+
+        // Checks the continuously changing content of the connected registries, call once per frame after the update
+        void poll();
+
+        bool shouldRender() const
+        {
+            return !enabled_ || pending_frames_ > 0;
+        }
+
+        // Call after a frame has been presented
+        void frameRendered();
+    };
+}
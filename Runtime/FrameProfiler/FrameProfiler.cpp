@@ -0,0 +1,138 @@
+#include "FrameProfiler.h"
+#include <bgfx/bgfx.h>
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    FrameProfiler::FrameProfiler(size_t history_capacity)
+        : history_capacity_(std::max<size_t>(1, history_capacity))
+    {
+        history_.reserve(history_capacity_);
+    }
+
+    void FrameProfiler::beginFrame()
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        current_.frame_ms = 0.0f;
+        current_.phase_ms.fill(0.0f);
+        current_.scopes.clear();
+        open_scopes_.clear();
+        frame_start_ = Clock::now();
+        in_frame_ = true;
+    }
+
+    void FrameProfiler::begin(Phase phase)
+    {
+        if (!in_frame_)
+        {
+            return;
+        }
+
+        const Clock::time_point now = Clock::now();
+        current_.scopes.push_back({ phase, static_cast<uint8_t>(std::min<size_t>(open_scopes_.size(), 0xff)),
+                                    milliseconds(now - frame_start_), 0.0f });
+        open_scopes_.push_back({ current_.scopes.size() - 1, now });
+    }
+
+    void FrameProfiler::end()
+    {
+        if (!in_frame_ || open_scopes_.empty())
+        {
+            return;
+        }
+
+        const OpenScope open = open_scopes_.back();
+        open_scopes_.pop_back();
+
+        ScopeRecord& record = current_.scopes[open.record];
+        record.duration_ms = milliseconds(Clock::now() - open.start);
+        current_.phase_ms[static_cast<size_t>(record.phase)] += record.duration_ms;
+    }
+
+    void FrameProfiler::captureGpuStats()
+    {
+        current_.has_gpu_stats = false;
+        const bgfx::Stats* stats = gpu_stats_enabled_ ? bgfx::getStats() : nullptr;
+        if (stats == nullptr)
+        {
+            return;
+        }
+
+        current_.has_gpu_stats = true;
+        current_.gpu_ms = stats->gpuTimerFreq > 0
+                          ? static_cast<float>(static_cast<double>(stats->gpuTimeEnd - stats->gpuTimeBegin) * 1000.0 / stats->gpuTimerFreq)
+                          : 0.0f;
+        current_.draw_calls = stats->numDraw;
+        current_.transient_vb_used = stats->transientVbUsed;
+        current_.transient_ib_used = stats->transientIbUsed;
+        current_.texture_memory = stats->textureMemoryUsed;
+    }
+
+    void FrameProfiler::endFrame(bool rendered)
+    {
+        if (!in_frame_)
+        {
+            return;
+        }
+
+        while (!open_scopes_.empty())
+        {
+            end();
+        }
+
+        current_.frame_ms = milliseconds(Clock::now() - frame_start_);
+        current_.rendered = rendered;
+        captureGpuStats();
+        in_frame_ = false;
+
+        // Ring buffer, slots are overwritten in place so their scope vectors keep their capacity
+        if (history_.size() < history_capacity_)
+        {
+            history_.push_back(current_);
+        }
+        else
+        {
+            history_[next_slot_] = current_;
+        }
+        next_slot_ = (next_slot_ + 1) % history_capacity_;
+    }
+
+    std::vector<const FrameProfiler::FrameSample*> FrameProfiler::getHistory() const
+    {
+        std::vector<const FrameSample*> samples;
+        samples.reserve(history_.size());
+
+        const size_t first = history_.size() < history_capacity_ ? 0 : next_slot_;
+        for (size_t i = 0; i < history_.size(); ++i)
+        {
+            samples.push_back(&history_[(first + i) % history_.size()]);
+        }
+        return samples;
+    }
+
+    const FrameProfiler::FrameSample* FrameProfiler::getLatest() const
+    {
+        if (history_.empty())
+        {
+            return nullptr;
+        }
+        return &history_[(next_slot_ + history_capacity_ - 1) % history_capacity_];
+    }
+
+    const char* FrameProfiler::getPhaseName(Phase phase)
+    {
+        switch (phase)
+        {
+            case Phase::EventPump:      return "Event pump";
+            case Phase::DispatchEvents: return "Dispatch events";
+            case Phase::StateUpdate:    return "State update";
+            case Phase::Render:         return "Render";
+            case Phase::Present:        return "Present";
+            default:                    return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Scoped CPU timings of the main loop phases, kept in a rolling history.
+     * Scopes may nest, each record keeps its depth so the debug overlay can draw a flame graph.
+     * bgfx::getStats() is only sampled after setGpuStatsEnabled(true), for loops that present through bgfx::frame().
+     * Those statistics describe the last frame bgfx finished, so they lag the CPU timings.
+     * Main thread only.
+     */
+    class FrameProfiler
+    {
+    public:
+        enum class Phase : uint8_t
+        {
+            EventPump,
+            DispatchEvents,
+            StateUpdate,
+            // The ECS systems are not run by any state yet, time them with their own phase once they are
+            Render,
+            Present,
+            Count
+        };
+
+        struct ScopeRecord
+        {
+            Phase phase;
+            uint8_t depth;
+            // Relative to the start of the frame
+            float start_ms;
+            float duration_ms;
+        };
+
+        struct FrameSample
+        {
+            float frame_ms = 0.0f;
+            // Summed per phase, nested scopes are also counted in their parents
+            std::array<float, static_cast<size_t>(Phase::Count)> phase_ms{};
+            std::vector<ScopeRecord> scopes;
+            // False when the frame was skipped as static
+            bool rendered = true;
+
+            // The fields below are only meaningful when has_gpu_stats is set
+            bool has_gpu_stats = false;
+            float gpu_ms = 0.0f;
+            uint32_t draw_calls = 0;
+            int32_t transient_vb_used = 0;
+            int32_t transient_ib_used = 0;
+            int64_t texture_memory = 0;
+        };
+
+        class Scope
+        {
+        private:
+            FrameProfiler* profiler_;
+
+        public:
+            Scope(FrameProfiler& profiler, Phase phase) : profiler_(&profiler)
+            {
+                profiler_->begin(phase);
+            }
+            ~Scope()
+            {
+                profiler_->end();
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope(Scope&&) = delete;
+            Scope& operator=(Scope&&) = delete;
+        };
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct OpenScope
+        {
+            size_t record;
+            Clock::time_point start;
+        };
+
+        std::vector<FrameSample> history_;
+        size_t history_capacity_;
+        size_t next_slot_ = 0;
+
+        FrameSample current_;
+        Clock::time_point frame_start_;
+        std::vector<OpenScope> open_scopes_;
+        bool in_frame_ = false;
+        bool enabled_ = true;
+        bool gpu_stats_enabled_ = false;
+
+        static float milliseconds(Clock::duration duration)
+        {
+            return std::chrono::duration<float, std::milli>(duration).count();
+        }
+
+        void captureGpuStats();
+
+    public:
+        explicit FrameProfiler(size_t history_capacity = 240);
+        ~FrameProfiler() = default;
+
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+        FrameProfiler(FrameProfiler&&) = delete;
+        FrameProfiler& operator=(FrameProfiler&&) = delete;
+
+        void setEnabled(bool enabled)
+        {
+            enabled_ = enabled;
+        }
+        bool isEnabled() const
+        {
+            return enabled_;
+        }
+
+        // Only enable when the main loop calls bgfx::frame(), otherwise bgfx's statistics are stale or zero
+        void setGpuStatsEnabled(bool enabled)
+        {
+            gpu_stats_enabled_ = enabled;
+        }
+        bool isGpuStatsEnabled() const
+        {
+            return gpu_stats_enabled_;
+        }
+
+        void beginFrame();
+        // Closes scopes left open and stores the sample
+        void endFrame(bool rendered = true);
+
+        void begin(Phase phase);
+        void end();
+
+        // Oldest first
+        std::vector<const FrameSample*> getHistory() const;
+        const FrameSample* getLatest() const;
+
+        static const char* getPhaseName(Phase phase);
+    };
+}
@@ -12,9 +12,21 @@ namespace cyanvne::runtime
               event_bus_(std::move(event_bus)),
               cache_manager_(std::move(cache_manager)),
               concurrency_manager_(std::move(concurrency_manager)),
-              audio_manager_(std::move(audio_manager))
+              audio_manager_(std::move(audio_manager)),
+              texture_upload_scheduler_(std::make_shared<resources::TextureUploadScheduler>()),
+              frame_dirty_tracker_(std::make_shared<FrameDirtyTracker>()),
+              frame_profiler_(std::make_shared<FrameProfiler>())
     {
         state_stack_.reserve(10);
+
+        if (audio_manager_)
+        {
+            frame_dirty_tracker_->setVoiceQuery([audio_manager = audio_manager_](audio::VoiceHandle handle)
+                                                {
+                                                    auto& engine = audio_manager->getEngine();
+                                                    return engine.isValidVoiceHandle(handle) && !engine.getPaused(handle);
+                                                });
+        }
     }
 
     GameStateManager::~GameStateManager()
@@ -42,6 +54,7 @@ namespace cyanvne::runtime
 
         new_state->init(shared_from_this());
         state_stack_.push_back(std::move(new_state));
+        frame_dirty_tracker_->markDirty();
     }
 
     void GameStateManager::popState()
@@ -55,6 +68,7 @@ namespace cyanvne::runtime
             {
                 state_stack_.back()->resume(shared_from_this());
             }
+            frame_dirty_tracker_->markDirty();
         }
     }
 
@@ -86,6 +100,11 @@ namespace cyanvne::runtime
         {
             state_stack_.back()->update(shared_from_this(), delta_time);
         }
+
+        // Runs after the states so uploads queued this frame can already start
+        texture_upload_scheduler_->processFrame();
+
+        frame_dirty_tracker_->poll();
     }
 
     void GameStateManager::render()
@@ -5,8 +5,11 @@
 #include "Platform/WindowContext/WindowContext.h"
 #include "Runtime/Components/Components.h"
 #include "Resources/UnifiedCacheManager/UnifiedCacheManager.h"
+#include "Resources/TextureUploadScheduler/TextureUploadScheduler.h"
 #include "Audio/AudioManager/AudioManager.h"
 #include "Audio/SoloudAudioEngine/SoloudAudioEngine.h"
+#include "Runtime/FrameDirtyTracker/FrameDirtyTracker.h"
+#include "Runtime/FrameProfiler/FrameProfiler.h"
 
 namespace cyanvne::runtime
 {
@@ -47,6 +50,9 @@ namespace cyanvne::runtime
         std::shared_ptr<resources::UnifiedCacheManager> cache_manager_;
         std::shared_ptr<platform::concurrency::UnifiedConcurrencyManager> concurrency_manager_;
         std::shared_ptr<audio::AudioManager<audio::SoloudAudioEngine>> audio_manager_;
+        std::shared_ptr<resources::TextureUploadScheduler> texture_upload_scheduler_;
+        std::shared_ptr<FrameDirtyTracker> frame_dirty_tracker_;
+        std::shared_ptr<FrameProfiler> frame_profiler_;
 
         bool running_ = true;
 
@@ -94,5 +100,17 @@ namespace cyanvne::runtime
         {
             return audio_manager_;
         }
+        std::shared_ptr<resources::TextureUploadScheduler> getTextureUploadScheduler()
+        {
+            return texture_upload_scheduler_;
+        }
+        std::shared_ptr<FrameDirtyTracker> getFrameDirtyTracker()
+        {
+            return frame_dirty_tracker_;
+        }
+        std::shared_ptr<FrameProfiler> getFrameProfiler()
+        {
+            return frame_profiler_;
+        }
     };
 }
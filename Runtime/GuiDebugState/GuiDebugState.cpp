@@ -0,0 +1,233 @@
+#include "GuiDebugState.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace cyanvne::runtime
+{
+    namespace
+    {
+        constexpr size_t PHASE_COUNT = static_cast<size_t>(FrameProfiler::Phase::Count);
+
+        ImU32 phase_color(FrameProfiler::Phase phase)
+        {
+            static const ImU32 colors[PHASE_COUNT] = {
+                    IM_COL32(86, 156, 214, 255),
+                    IM_COL32(78, 201, 176, 255),
+                    IM_COL32(220, 220, 170, 255),
+                    IM_COL32(197, 134, 192, 255),
+                    IM_COL32(206, 145, 120, 255),
+                    IM_COL32(181, 206, 168, 255)
+            };
+            return colors[static_cast<size_t>(phase) % PHASE_COUNT];
+        }
+    }
+
+    void GuiDebugState::init(std::shared_ptr<GameStateManager> manager)
+    {
+        profiler_ = manager->getFrameProfiler();
+
+        if (const std::shared_ptr<platform::EventBus> event_bus = manager->getEventBus())
+        {
+            toggle_subscription_ = event_bus->subscribeSDL(SDL_EVENT_KEY_DOWN, [this](const SDL_Event& event)
+            {
+                if (event.key.key != SDLK_F3 || event.key.repeat)
+                {
+                    return false;
+                }
+                show_profiler_ = !show_profiler_;
+                return true;
+            });
+        }
+    }
+
+    void GuiDebugState::shutdown(std::shared_ptr<GameStateManager> manager)
+    {
+        toggle_subscription_.release();
+        profiler_.reset();
+    }
+
+    void GuiDebugState::handle_events(std::shared_ptr<GameStateManager> manager)
+    {  }
+
+    void GuiDebugState::update(std::shared_ptr<GameStateManager> manager, float delta_time)
+    {  }
+
+    void GuiDebugState::drawGraphs(const std::vector<const FrameProfiler::FrameSample*>& history) const
+    {
+        std::vector<float> frame_ms;
+        std::vector<float> gpu_ms;
+        frame_ms.reserve(history.size());
+        gpu_ms.reserve(history.size());
+
+        float max_ms = 1.0f;
+        bool has_gpu_stats = false;
+        for (const FrameProfiler::FrameSample* sample : history)
+        {
+            frame_ms.push_back(sample->frame_ms);
+            gpu_ms.push_back(sample->gpu_ms);
+            max_ms = std::max({ max_ms, sample->frame_ms, sample->gpu_ms });
+            has_gpu_stats |= sample->has_gpu_stats;
+        }
+
+        const float width = ImGui::GetContentRegionAvail().x;
+        ImGui::PlotLines("##cpu", frame_ms.data(), static_cast<int>(frame_ms.size()), 0, "CPU frame (ms)", 0.0f, max_ms,
+                         ImVec2(width, 60.0f));
+        if (has_gpu_stats)
+        {
+            ImGui::PlotLines("##gpu", gpu_ms.data(), static_cast<int>(gpu_ms.size()), 0, "GPU (ms)", 0.0f, max_ms,
+                             ImVec2(width, 60.0f));
+        }
+    }
+
+    void GuiDebugState::drawPhaseTable(const std::vector<const FrameProfiler::FrameSample*>& history) const
+    {
+        std::array<float, PHASE_COUNT> average{};
+        std::array<float, PHASE_COUNT> peak{};
+        size_t rendered = 0;
+        for (const FrameProfiler::FrameSample* sample : history)
+        {
+            // Skipped frames never reach Render or Present and would drag every average down
+            if (!sample->rendered)
+            {
+                continue;
+            }
+            for (size_t p = 0; p < PHASE_COUNT; ++p)
+            {
+                average[p] += sample->phase_ms[p];
+                peak[p] = std::max(peak[p], sample->phase_ms[p]);
+            }
+            ++rendered;
+        }
+
+        ImGui::Text("Rendered %zu of the last %zu frames, averages cover rendered frames only", rendered, history.size());
+
+        if (ImGui::BeginTable("phases", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Phase");
+            ImGui::TableSetupColumn("Average (ms)");
+            ImGui::TableSetupColumn("Peak (ms)");
+            ImGui::TableHeadersRow();
+
+            for (size_t p = 0; p < PHASE_COUNT; ++p)
+            {
+                const auto phase = static_cast<FrameProfiler::Phase>(p);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(phase_color(phase)), "%s", FrameProfiler::getPhaseName(phase));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", rendered == 0 ? 0.0f : average[p] / static_cast<float>(rendered));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", peak[p]);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    void GuiDebugState::drawFlame(const FrameProfiler::FrameSample& sample) const
+    {
+        constexpr float ROW_HEIGHT = 20.0f;
+
+        uint8_t max_depth = 0;
+        for (const auto& scope : sample.scopes)
+        {
+            max_depth = std::max(max_depth, scope.depth);
+        }
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+        const float height = ROW_HEIGHT * (max_depth + 1);
+        const float scale = sample.frame_ms > 0.0f ? width / sample.frame_ms : 0.0f;
+
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        draw_list->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+        for (const auto& scope : sample.scopes)
+        {
+            const ImVec2 min(origin.x + scope.start_ms * scale, origin.y + scope.depth * ROW_HEIGHT);
+            const ImVec2 max(std::max(min.x + 1.0f, min.x + scope.duration_ms * scale), min.y + ROW_HEIGHT - 1.0f);
+            draw_list->AddRectFilled(min, max, phase_color(scope.phase));
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "%s %.2f ms", FrameProfiler::getPhaseName(scope.phase), scope.duration_ms);
+            if (ImGui::CalcTextSize(label).x < max.x - min.x - 4.0f)
+            {
+                draw_list->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), label);
+            }
+        }
+
+        ImGui::Dummy(ImVec2(width, height));
+        if (ImGui::IsItemHovered())
+        {
+            const float hovered_ms = scale > 0.0f ? (ImGui::GetMousePos().x - origin.x) / scale : 0.0f;
+            const int hovered_depth = static_cast<int>((ImGui::GetMousePos().y - origin.y) / ROW_HEIGHT);
+            for (const auto& scope : sample.scopes)
+            {
+                if (scope.depth == hovered_depth && hovered_ms >= scope.start_ms && hovered_ms <= scope.start_ms + scope.duration_ms)
+                {
+                    ImGui::SetTooltip("%s\n%.3f ms at +%.3f ms", FrameProfiler::getPhaseName(scope.phase), scope.duration_ms, scope.start_ms);
+                    break;
+                }
+            }
+        }
+    }
+
+    void GuiDebugState::render(std::shared_ptr<GameStateManager> manager)
+    {
+        if (!profiler_ || !show_profiler_)
+        {
+            return;
+        }
+
+        if (!ImGui::Begin("Frame profiler", &show_profiler_))
+        {
+            ImGui::End();
+            return;
+        }
+
+        const std::vector<const FrameProfiler::FrameSample*> history = profiler_->getHistory();
+        if (!pause_flame_)
+        {
+            // The last rendered frame, skipped frames would show an almost empty flame
+            for (auto it = history.rbegin(); it != history.rend(); ++it)
+            {
+                if ((*it)->rendered)
+                {
+                    flame_sample_ = **it;
+                    break;
+                }
+            }
+        }
+
+        if (const FrameProfiler::FrameSample* latest = profiler_->getLatest())
+        {
+            ImGui::Text("CPU %.2f ms (%.0f fps)", latest->frame_ms, latest->frame_ms > 0.0f ? 1000.0f / latest->frame_ms : 0.0f);
+            if (latest->has_gpu_stats)
+            {
+                ImGui::Text("GPU %.2f ms   %u draws   Transient VB %.1f KiB   IB %.1f KiB   Textures %.1f MiB",
+                            latest->gpu_ms, latest->draw_calls,
+                            latest->transient_vb_used / 1024.0f, latest->transient_ib_used / 1024.0f,
+                            static_cast<double>(latest->texture_memory) / (1024.0 * 1024.0));
+            }
+            else
+            {
+                ImGui::TextDisabled("bgfx statistics off, this loop presents without bgfx::frame()");
+            }
+        }
+
+        drawGraphs(history);
+
+        if (ImGui::CollapsingHeader("Phases", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            drawPhaseTable(history);
+        }
+
+        if (ImGui::CollapsingHeader("Flame", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Checkbox("Pause", &pause_flame_);
+            drawFlame(flame_sample_);
+        }
+
+        ImGui::End();
+    }
+}
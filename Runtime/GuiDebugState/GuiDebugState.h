@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Runtime/GameStateManager/GameStateManager.h"
+#include "Runtime/FrameProfiler/FrameProfiler.h"
+#include "Platform/EventBus/EventBus.h"
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief ImGui overlay with the FrameProfiler's panels: frame time graphs, per phase averages over the
+     * rendered frames, and a flame graph of the latest rendered frame. GPU time and bgfx statistics are shown
+     * only when the profiler samples them. Hidden by default, F3 toggles it.
+     */
+    class GuiDebugState : public IGameState
+    {
+    private:
+        std::shared_ptr<FrameProfiler> profiler_;
+        platform::Subscription toggle_subscription_;
+        bool show_profiler_ = false;
+        bool pause_flame_ = false;
+        FrameProfiler::FrameSample flame_sample_;
+
+        void drawGraphs(const std::vector<const FrameProfiler::FrameSample*>& history) const;
+        void drawPhaseTable(const std::vector<const FrameProfiler::FrameSample*>& history) const;
+        void drawFlame(const FrameProfiler::FrameSample& sample) const;
+
+    public:
+        explicit GuiDebugState(bool show_profiler = false) : show_profiler_(show_profiler)
+        {  }
+
+        void init(std::shared_ptr<GameStateManager> manager) override;
+        void shutdown(std::shared_ptr<GameStateManager> manager) override;
+
+        void handle_events(std::shared_ptr<GameStateManager> manager) override;
+        void update(std::shared_ptr<GameStateManager> manager, float delta_time) override;
+        void render(std::shared_ptr<GameStateManager> manager) override;
+    };
+}
@@ -0,0 +1,246 @@
+#include "DynamicAtlas.h"
+#include "Resources/ResourceTypes/ResourceTypes.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    DynamicAtlas::DynamicAtlas(Config config) : config_(config)
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        supported_ = caps != nullptr &&
+                     (caps->supported & BGFX_CAPS_TEXTURE_BLIT) != 0 &&
+                     (caps->formats[bgfx::TextureFormat::RGBA8] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0;
+
+        if (caps != nullptr)
+        {
+            config_.page_size = static_cast<uint16_t>(std::min<uint32_t>(config_.page_size, caps->limits.maxTextureSize));
+        }
+
+        if (!supported_)
+        {
+            core::GlobalLogger::getCoreLogger()->info("DynamicAtlas: Texture blits are not supported, sprites will not be atlased.");
+            return;
+        }
+
+        destroy_listener_ = resources::TextureResource::addDestroyListener([this](uint64_t unique_id)
+        {
+            std::lock_guard<std::mutex> lock(destroyed_mutex_);
+            destroyed_.push_back(unique_id);
+        });
+    }
+
+    DynamicAtlas::~DynamicAtlas()
+    {
+        if (destroy_listener_ != 0)
+        {
+            resources::TextureResource::removeDestroyListener(destroy_listener_);
+        }
+
+        for (auto& page : pages_)
+        {
+            if (bgfx::isValid(page.texture))
+            {
+                bgfx::destroy(page.texture);
+            }
+        }
+    }
+
+    void DynamicAtlas::beginFrame()
+    {
+        ++frame_;
+        pruneDestroyed();
+    }
+
+    void DynamicAtlas::pruneDestroyed()
+    {
+        std::vector<uint64_t> destroyed;
+        {
+            std::lock_guard<std::mutex> lock(destroyed_mutex_);
+            destroyed.swap(destroyed_);
+        }
+
+        for (uint64_t key : destroyed)
+        {
+            rejected_.erase(key);
+
+            auto it = entries_.find(key);
+            if (it == entries_.end())
+            {
+                continue;
+            }
+
+            Page& page = pages_[it->second.page];
+            std::erase(page.keys, key);
+            entries_.erase(it);
+
+            // The packer cannot free single rects, an emptied page starts over instead
+            if (page.keys.empty())
+            {
+                page.packer.reset();
+            }
+        }
+    }
+
+    bool DynamicAtlas::isEligible(const resources::TextureResource& texture) const
+    {
+        // Blits cannot convert, so only textures already in the page format qualify
+        return texture.getFormat() == bgfx::TextureFormat::RGBA8 &&
+               texture.getNumLayers() == 1 &&
+               texture.getWidth() > 0 && texture.getHeight() > 0 &&
+               texture.getWidth() <= config_.max_entry_size &&
+               texture.getHeight() <= config_.max_entry_size &&
+               texture.getWidth() + 2u * config_.padding <= config_.page_size &&
+               texture.getHeight() + 2u * config_.padding <= config_.page_size;
+    }
+
+    std::optional<DynamicAtlas::Region> DynamicAtlas::acquire(const resources::TextureResource& texture)
+    {
+        if (!supported_)
+        {
+            return std::nullopt;
+        }
+
+        const uint64_t key = texture.getUniqueId();
+        if (auto it = entries_.find(key); it != entries_.end())
+        {
+            Page& page = pages_[it->second.page];
+            page.last_used_frame = frame_;
+            return Region{ page.texture, it->second.uv_rect };
+        }
+
+        if (!texture.isUploaded())
+        {
+            return std::nullopt;
+        }
+        if (rejected_.contains(key) || !isEligible(texture))
+        {
+            rejected_.insert(key);
+            return std::nullopt;
+        }
+
+        std::optional<Entry> entry = insert(texture);
+        if (!entry)
+        {
+            return std::nullopt;
+        }
+        return Region{ pages_[entry->page].texture, entry->uv_rect };
+    }
+
+    std::optional<DynamicAtlas::Entry> DynamicAtlas::insert(const resources::TextureResource& texture)
+    {
+        const bgfx::ViewId blit_view = config_.blit_view;
+        const uint16_t width = texture.getWidth();
+        const uint16_t height = texture.getHeight();
+        const uint16_t padding = config_.padding;
+
+        std::optional<platform::algorithm::rectpacking::PackedRect> rect;
+        std::optional<uint16_t> page_index;
+
+        for (uint16_t i = 0; i < pages_.size() && !rect; ++i)
+        {
+            rect = pages_[i].packer.insert(width + 2u * padding, height + 2u * padding);
+            if (rect)
+            {
+                page_index = i;
+            }
+        }
+
+        if (!rect)
+        {
+            if (pages_.size() < config_.max_pages)
+            {
+                Page& page = pages_.emplace_back(config_.page_size);
+                page.texture = bgfx::createTexture2D(config_.page_size, config_.page_size, false, 1,
+                                                     bgfx::TextureFormat::RGBA8,
+                                                     BGFX_TEXTURE_BLIT_DST | BGFX_SAMPLER_NONE);
+                if (!bgfx::isValid(page.texture))
+                {
+                    pages_.pop_back();
+                    core::GlobalLogger::getCoreLogger()->warn("DynamicAtlas: Failed to create atlas page.");
+                    return std::nullopt;
+                }
+                page_index = static_cast<uint16_t>(pages_.size() - 1);
+            }
+            else
+            {
+                page_index = evictLeastRecentlyUsedPage();
+                if (!page_index)
+                {
+                    // Every page is in use this frame
+                    return std::nullopt;
+                }
+            }
+            rect = pages_[*page_index].packer.insert(width + 2u * padding, height + 2u * padding);
+            if (!rect)
+            {
+                return std::nullopt;
+            }
+        }
+
+        Page& page = pages_[*page_index];
+        const uint16_t dst_x = static_cast<uint16_t>(rect->x + padding);
+        const uint16_t dst_y = static_cast<uint16_t>(rect->y + padding);
+
+        const bgfx::TextureHandle source = texture.texture_handle;
+        bgfx::blit(blit_view, page.texture, dst_x, dst_y, source, 0, 0, width, height);
+
+        // The whole gutter is refilled, an evicted page still holds the texels of its old entries
+        for (uint16_t i = 1; i <= padding; ++i)
+        {
+            bgfx::blit(blit_view, page.texture, dst_x - i, dst_y, source, 0, 0, 1, height);
+            bgfx::blit(blit_view, page.texture, dst_x + width - 1 + i, dst_y, source, width - 1, 0, 1, height);
+            bgfx::blit(blit_view, page.texture, dst_x, dst_y - i, source, 0, 0, width, 1);
+            bgfx::blit(blit_view, page.texture, dst_x, dst_y + height - 1 + i, source, 0, height - 1, width, 1);
+
+            // Corners too, bilinear taps at a corner read the diagonal texels
+            for (uint16_t j = 1; j <= padding; ++j)
+            {
+                bgfx::blit(blit_view, page.texture, dst_x - i, dst_y - j, source, 0, 0, 1, 1);
+                bgfx::blit(blit_view, page.texture, dst_x + width - 1 + i, dst_y - j, source, width - 1, 0, 1, 1);
+                bgfx::blit(blit_view, page.texture, dst_x - i, dst_y + height - 1 + j, source, 0, height - 1, 1, 1);
+                bgfx::blit(blit_view, page.texture, dst_x + width - 1 + i, dst_y + height - 1 + j, source,
+                           width - 1, height - 1, 1, 1);
+            }
+        }
+
+        const float inv_size = 1.0f / static_cast<float>(config_.page_size);
+        Entry entry{ *page_index, glm::vec4(dst_x * inv_size, dst_y * inv_size, width * inv_size, height * inv_size) };
+
+        const uint64_t key = texture.getUniqueId();
+        entries_.emplace(key, entry);
+        page.keys.push_back(key);
+        page.last_used_frame = frame_;
+        return entry;
+    }
+
+    std::optional<uint16_t> DynamicAtlas::evictLeastRecentlyUsedPage()
+    {
+        std::optional<uint16_t> victim;
+        for (uint16_t i = 0; i < pages_.size(); ++i)
+        {
+            if (pages_[i].last_used_frame >= frame_)
+            {
+                continue;
+            }
+            if (!victim || pages_[i].last_used_frame < pages_[*victim].last_used_frame)
+            {
+                victim = i;
+            }
+        }
+
+        if (!victim)
+        {
+            return std::nullopt;
+        }
+
+        Page& page = pages_[*victim];
+        for (uint64_t key : page.keys)
+        {
+            entries_.erase(key);
+        }
+        page.keys.clear();
+        page.packer.reset();
+        return victim;
+    }
+}
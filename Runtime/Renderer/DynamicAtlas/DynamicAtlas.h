@@ -0,0 +1,117 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Platform/Algorithm/RectPacking/RectPacking.h"
+
+namespace cyanvne::resources
+{
+    class TextureResource;
+}
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Packs small cached textures into shared pages so sprites using them can share a batch.
+     * Textures are copied into the pages with GPU blits, the source TextureResource stays untouched.
+     * Pages are evicted whole in LRU order once the page limit is reached. Entries of destroyed textures are
+     * dropped at the next beginFrame(), a page whose entries are all gone is reused.
+     */
+    class DynamicAtlas
+    {
+    public:
+        struct Config
+        {
+            uint16_t page_size = 2048;
+            uint16_t max_pages = 4;
+            // Textures larger than this on either side are drawn on their own
+            uint16_t max_entry_size = 256;
+            // Edge texels are extruded across the whole padding to keep filtering from bleeding neighbours in.
+            // A corner takes padding * padding single texel blits, so keep it small
+            uint16_t padding = 1;
+            // View whose blit pass copies new entries, keep it ahead of every view that samples the pages
+            bgfx::ViewId blit_view = 0;
+        };
+
+        struct Region
+        {
+            bgfx::TextureHandle texture;
+            // x, y, w, h in page UV space
+            glm::vec4 uv_rect;
+        };
+
+    private:
+        struct Entry
+        {
+            uint16_t page;
+            glm::vec4 uv_rect;
+        };
+
+        struct Page
+        {
+            bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+            platform::algorithm::rectpacking::SkylinePacker packer;
+            uint64_t last_used_frame = 0;
+            std::vector<uint64_t> keys;
+
+            explicit Page(uint16_t size) : packer(size, size)
+            {  }
+        };
+
+        Config config_;
+        std::vector<Page> pages_;
+        std::unordered_map<uint64_t, Entry> entries_;
+        std::unordered_set<uint64_t> rejected_;
+        uint64_t frame_ = 1;
+        bool supported_ = false;
+
+        // Filled by the texture destroy listener, which may run on any thread
+        std::mutex destroyed_mutex_;
+        std::vector<uint64_t> destroyed_;
+        uint64_t destroy_listener_ = 0;
+
+        // Only checks permanent properties, textures still uploading are retried later
+        bool isEligible(const resources::TextureResource& texture) const;
+        void pruneDestroyed();
+        std::optional<Entry> insert(const resources::TextureResource& texture);
+        std::optional<uint16_t> evictLeastRecentlyUsedPage();
+
+    public:
+        explicit DynamicAtlas(Config config = Config());
+        ~DynamicAtlas();
+
+        DynamicAtlas(const DynamicAtlas&) = delete;
+        DynamicAtlas& operator=(const DynamicAtlas&) = delete;
+        DynamicAtlas(DynamicAtlas&&) = delete;
+        DynamicAtlas& operator=(DynamicAtlas&&) = delete;
+
+        // Pages touched in the current frame are never evicted, entries of destroyed textures are dropped here
+        void beginFrame();
+
+        /**
+         * @brief Looks up or packs a texture, the copy goes through Config::blit_view.
+         * @param texture An uploaded texture.
+         * @return The region to sample, or nullopt if the texture should be bound directly.
+         */
+        std::optional<Region> acquire(const resources::TextureResource& texture);
+
+        bool isSupported() const
+        {
+            return supported_;
+        }
+        size_t getPageCount() const
+        {
+            return pages_.size();
+        }
+        size_t getEntryCount() const
+        {
+            return entries_.size();
+        }
+    };
+}
@@ -0,0 +1,181 @@
+#include "LayerCache.h"
+#include "Runtime/Components/Components.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    LayerCache::LayerCache(Config config) : config_(config)
+    {  }
+
+    LayerCache::~LayerCache()
+    {
+        disconnect();
+        clear();
+    }
+
+    void LayerCache::init()
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        const uint32_t max_views = caps != nullptr ? caps->limits.maxViews : BGFX_CONFIG_MAX_VIEWS;
+        const uint32_t first = config_.first_view_id;
+        const uint32_t last = std::min<uint32_t>(first + config_.max_layers, max_views);
+
+        free_views_.clear();
+        for (uint32_t view = last; view > first; --view)
+        {
+            free_views_.push_back(static_cast<bgfx::ViewId>(view - 1));
+        }
+
+        core::GlobalLogger::getCoreLogger()->info("LayerCache: Reserved views {} to {} for cached layers.", first, last - 1);
+    }
+
+    void LayerCache::connect(entt::registry& registry)
+    {
+        disconnect();
+
+        registry_ = &registry;
+        registry_->on_construct<MeshComponent>().connect<&LayerCache::onMeshChanged>(*this);
+        registry_->on_update<MeshComponent>().connect<&LayerCache::onMeshChanged>(*this);
+        registry_->on_destroy<MeshComponent>().connect<&LayerCache::onMeshDestroyed>(*this);
+    }
+
+    void LayerCache::disconnect()
+    {
+        if (registry_ == nullptr)
+        {
+            return;
+        }
+
+        registry_->on_construct<MeshComponent>().disconnect<&LayerCache::onMeshChanged>(*this);
+        registry_->on_update<MeshComponent>().disconnect<&LayerCache::onMeshChanged>(*this);
+        registry_->on_destroy<MeshComponent>().disconnect<&LayerCache::onMeshDestroyed>(*this);
+        registry_ = nullptr;
+
+        // Versions from another registry would be meaningless, cached targets redraw once
+        mesh_versions_.clear();
+        invalidateAll();
+    }
+
+    void LayerCache::onMeshChanged(entt::registry& registry, entt::entity entity)
+    {
+        mesh_versions_[entity] = next_version_++;
+    }
+
+    void LayerCache::onMeshDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        mesh_versions_.erase(entity);
+    }
+
+    void LayerCache::destroyTarget(Entry& entry)
+    {
+        if (bgfx::isValid(entry.frame_buffer))
+        {
+            bgfx::destroy(entry.frame_buffer);
+            entry.frame_buffer = BGFX_INVALID_HANDLE;
+        }
+        entry.valid = false;
+    }
+
+    std::optional<LayerCache::Target> LayerCache::acquire(entt::entity camera, uint16_t width, uint16_t height, uint64_t signature)
+    {
+        if (width == 0 || height == 0)
+        {
+            return std::nullopt;
+        }
+
+        auto it = entries_.find(camera);
+        if (it == entries_.end())
+        {
+            if (free_views_.empty())
+            {
+                return std::nullopt;
+            }
+
+            Entry entry;
+            entry.view_id = free_views_.back();
+            free_views_.pop_back();
+            it = entries_.emplace(camera, entry).first;
+        }
+
+        Entry& entry = it->second;
+        entry.used = true;
+
+        if (!bgfx::isValid(entry.frame_buffer) || entry.width != width || entry.height != height)
+        {
+            destroyTarget(entry);
+
+            const bgfx::TextureHandle textures[2] = {
+                    bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::RGBA8,
+                                          BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP),
+                    bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::D24S8, BGFX_TEXTURE_RT_WRITE_ONLY)
+            };
+            entry.frame_buffer = bgfx::createFrameBuffer(2, textures, true);
+            entry.width = width;
+            entry.height = height;
+
+            if (!bgfx::isValid(entry.frame_buffer))
+            {
+                core::GlobalLogger::getCoreLogger()->warn("LayerCache: Failed to create a {}x{} layer target.", width, height);
+                for (const bgfx::TextureHandle texture : textures)
+                {
+                    if (bgfx::isValid(texture))
+                    {
+                        bgfx::destroy(texture);
+                    }
+                }
+                return std::nullopt;
+            }
+        }
+
+        const bool needs_redraw = !entry.valid || entry.signature != signature;
+        entry.signature = signature;
+        entry.valid = true;
+
+        return Target{ entry.view_id, entry.frame_buffer, bgfx::getTexture(entry.frame_buffer, 0), needs_redraw };
+    }
+
+    void LayerCache::invalidate(entt::entity camera)
+    {
+        auto it = entries_.find(camera);
+        if (it != entries_.end())
+        {
+            it->second.valid = false;
+        }
+    }
+
+    void LayerCache::invalidateAll()
+    {
+        for (auto& [camera, entry] : entries_)
+        {
+            entry.valid = false;
+        }
+    }
+
+    void LayerCache::collect()
+    {
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (it->second.used)
+            {
+                it->second.used = false;
+                ++it;
+                continue;
+            }
+
+            destroyTarget(it->second);
+            free_views_.push_back(it->second.view_id);
+            it = entries_.erase(it);
+        }
+    }
+
+    void LayerCache::clear()
+    {
+        for (auto& [camera, entry] : entries_)
+        {
+            destroyTarget(entry);
+            free_views_.push_back(entry.view_id);
+        }
+        entries_.clear();
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <entt/entt.hpp>
+#include "Core/Hash/Fnv1a.h"
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Offscreen targets for cameras flagged is_cached, so stationary layers render once and are
+     * composited as a single quad afterwards. Each cached camera owns a view in [first_view_id,
+     * first_view_id + max_layers). Those views have to be drawn before the views of the cached cameras,
+     * so a refreshed target is ready before it is composited in the same frame. The default range sits
+     * below every RenderLayer except Skybox, otherwise order the views with bgfx::setViewOrder().
+     * Targets are refreshed whenever the content signature supplied by the caller changes.
+     * A connected registry bumps an entity's mesh version when its MeshComponent is emplaced, patched or
+     * replaced, so signatures never have to hash the geometry. Meshes edited in place through get<>() are
+     * not seen, call invalidate() after such edits.
+     */
+    class LayerCache
+    {
+    public:
+        struct Config
+        {
+            bgfx::ViewId first_view_id = 1;
+            uint16_t max_layers = 8;
+        };
+
+        struct Target
+        {
+            bgfx::ViewId view_id;
+            bgfx::FrameBufferHandle frame_buffer;
+            // Premultiplied color, composite with MeshBatchRenderer::submitFullscreenQuad(texture, true)
+            bgfx::TextureHandle texture;
+            bool needs_redraw;
+        };
+
+        // FNV-1a over the raw bytes of whatever describes a layer's content
+        class Signature
+        {
+        private:
+            uint64_t hash_ = core::FNV1A_OFFSET_BASIS;
+
+        public:
+            void addBytes(const void* data, size_t size)
+            {
+                hash_ = core::fnv1a(hash_, data, size);
+            }
+
+            template <typename T>
+            void add(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>, "Signature::add expects plain data");
+                addBytes(&value, sizeof(T));
+            }
+
+            uint64_t value() const
+            {
+                return hash_;
+            }
+        };
+
+    private:
+        struct Entry
+        {
+            bgfx::ViewId view_id;
+            bgfx::FrameBufferHandle frame_buffer = BGFX_INVALID_HANDLE;
+            uint16_t width = 0;
+            uint16_t height = 0;
+            uint64_t signature = 0;
+            bool valid = false;
+            bool used = false;
+        };
+
+        Config config_;
+        std::unordered_map<entt::entity, Entry> entries_;
+        std::vector<bgfx::ViewId> free_views_;
+
+        entt::registry* registry_ = nullptr;
+        std::unordered_map<entt::entity, uint64_t> mesh_versions_;
+        uint64_t next_version_ = 1;
+
+        static void destroyTarget(Entry& entry);
+        void onMeshChanged(entt::registry& registry, entt::entity entity);
+        void onMeshDestroyed(entt::registry& registry, entt::entity entity);
+
+    public:
+        explicit LayerCache(Config config = Config());
+        ~LayerCache();
+
+        LayerCache(const LayerCache&) = delete;
+        LayerCache& operator=(const LayerCache&) = delete;
+        LayerCache(LayerCache&&) = delete;
+        LayerCache& operator=(LayerCache&&) = delete;
+
+        // Reserves the cache views, call after bgfx::init(). The global view order is left alone
+        void init();
+
+        // Bumps mesh versions from MeshComponent signals until disconnect(), which has to run while the registry is alive
+        void connect(entt::registry& registry);
+        void disconnect();
+
+        bool isConnected(const entt::registry& registry) const
+        {
+            return registry_ == &registry;
+        }
+
+        // Changes whenever the entity's MeshComponent is emplaced, patched or replaced, 0 when it has none
+        uint64_t getMeshVersion(entt::entity entity) const
+        {
+            const auto it = mesh_versions_.find(entity);
+            return it != mesh_versions_.end() ? it->second : 0;
+        }
+
+        /**
+         * @brief Returns the camera's target, (re)created at the given size.
+         * needs_redraw is set when the target is new, resized, invalidated or the signature changed,
+         * the caller then renders the layer into view_id. nullopt when no view or frame buffer is left.
+         */
+        std::optional<Target> acquire(entt::entity camera, uint16_t width, uint16_t height, uint64_t signature);
+
+        // Forces a redraw on the next acquire()
+        void invalidate(entt::entity camera);
+        void invalidateAll();
+
+        // Frees the targets of cameras that were not acquired since the last call, call once per frame
+        void collect();
+        void clear();
+
+        size_t getLayerCount() const
+        {
+            return entries_.size();
+        }
+    };
+}
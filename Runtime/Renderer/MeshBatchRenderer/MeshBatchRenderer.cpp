@@ -4,25 +4,52 @@
 
 #include "MeshBatchRenderer.h"
 #include "Runtime/Components/Components.h"
+#include "Resources/UnifiedCacheManager/UnifiedCacheManager.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
 #include <vector>
 
 #include <bgfx/embedded_shader.h>
 #include <variant>
 
 #include "Shaders/original_sprite/bin/glsl/vs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/vs_sprite_instanced.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/vs_sprite_compact.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/vs_sprite_static.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/vs_sprite_instanced_array.glsl.bin.h"
 #include "Shaders/original_sprite/bin/glsl/fs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/fs_sprite_array.glsl.bin.h"
+#include "Shaders/original_sprite/bin/glsl/fs_sprite_sdf.glsl.bin.h"
 #include "Shaders/original_sprite/bin/essl/vs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/vs_sprite_instanced.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/vs_sprite_compact.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/vs_sprite_static.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/vs_sprite_instanced_array.glsl.bin.h"
 #include "Shaders/original_sprite/bin/essl/fs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/fs_sprite_array.glsl.bin.h"
+#include "Shaders/original_sprite/bin/essl/fs_sprite_sdf.glsl.bin.h"
 #include "Shaders/original_sprite/bin/spirv/vs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/vs_sprite_instanced.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/vs_sprite_compact.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/vs_sprite_static.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/vs_sprite_instanced_array.glsl.bin.h"
 #include "Shaders/original_sprite/bin/spirv/fs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/fs_sprite_array.glsl.bin.h"
+#include "Shaders/original_sprite/bin/spirv/fs_sprite_sdf.glsl.bin.h"
 
 #if defined(_WIN32)
 #include "Shaders/original_sprite/bin/dx11/vs_sprite.glsl.bin.h"
+#include "Shaders/original_sprite/bin/dx11/vs_sprite_instanced.glsl.bin.h"
+#include "Shaders/original_sprite/bin/dx11/vs_sprite_compact.glsl.bin.h"
+#include "Shaders/original_sprite/bin/dx11/vs_sprite_static.glsl.bin.h"
+#include "Shaders/original_sprite/bin/dx11/vs_sprite_instanced_array.glsl.bin.h"
 #include "Shaders/original_sprite/bin/dx11/fs_sprite.glsl.bin.h"
-#include "Resources/UnifiedCacheManager/UnifiedCacheManager.h"
-
+#include "Shaders/original_sprite/bin/dx11/fs_sprite_array.glsl.bin.h"
+#include "Shaders/original_sprite/bin/dx11/fs_sprite_sdf.glsl.bin.h"
 #endif
 
 // Since bgfx does not support Metal on Windows, we exclude these headers on non-Apple platforms
@@ -34,12 +61,130 @@
 static const bgfx::EmbeddedShader s_embeddedShaders[] =
         {
                 BGFX_EMBEDDED_SHADER(vs_sprite),
+                BGFX_EMBEDDED_SHADER(vs_sprite_instanced),
+                BGFX_EMBEDDED_SHADER(vs_sprite_instanced_array),
+                BGFX_EMBEDDED_SHADER(vs_sprite_compact),
+                BGFX_EMBEDDED_SHADER(vs_sprite_static),
                 BGFX_EMBEDDED_SHADER(fs_sprite),
+                BGFX_EMBEDDED_SHADER(fs_sprite_array),
+                BGFX_EMBEDDED_SHADER(fs_sprite_sdf),
                 BGFX_EMBEDDED_SHADER_END()
         };
 
 namespace cyanvne::runtime
 {
+    namespace
+    {
+        bool is_unit_uv_rect(const glm::vec4& uv_rect)
+        {
+            return uv_rect.x >= 0.0f && uv_rect.y >= 0.0f &&
+                   uv_rect.x + uv_rect.z <= 1.0f && uv_rect.y + uv_rect.w <= 1.0f;
+        }
+
+        constexpr uint64_t IMMEDIATE_STATE = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
+                                             BGFX_STATE_DEPTH_TEST_LESS |
+                                             BGFX_STATE_BLEND_ALPHA;
+        constexpr uint64_t OPAQUE_STATE = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
+                                          BGFX_STATE_DEPTH_TEST_LESS;
+        // Sorted back-to-front, so translucent geometry tests depth but does not write it
+        constexpr uint64_t TRANSLUCENT_STATE = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                                               BGFX_STATE_DEPTH_TEST_LESS |
+                                               BGFX_STATE_BLEND_ALPHA;
+        constexpr uint64_t COMPOSITE_STATE = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
+                                             BGFX_STATE_DEPTH_TEST_LESS |
+                                             BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_INV_SRC_ALPHA);
+        // Color is blended as usual, coverage accumulates as src + dst * (1 - src)
+        constexpr uint64_t PREMULTIPLIED_OUTPUT_BLEND = BGFX_STATE_BLEND_FUNC_SEPARATE(BGFX_STATE_BLEND_SRC_ALPHA,
+                                                                                       BGFX_STATE_BLEND_INV_SRC_ALPHA,
+                                                                                       BGFX_STATE_BLEND_ONE,
+                                                                                       BGFX_STATE_BLEND_INV_SRC_ALPHA);
+
+        constexpr uint32_t SPRITE_INDICES[6] = { 0, 3, 2, 0, 2, 1 };
+        constexpr uint16_t INSTANCE_STRIDE = sizeof(MeshBatchRenderer::SpriteInstance);
+        constexpr float COMPACT_RANGE = 32767.0f;
+
+        // Maps a float to an unsigned integer with the same ordering
+        uint32_t sortable_float_bits(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+        }
+
+        // Stable LSD radix sort, byte passes where every key agrees are skipped
+        template <typename Entry>
+        void radix_sort_by_key(std::vector<Entry>& entries, std::vector<Entry>& scratch)
+        {
+            if (entries.size() < 2)
+            {
+                return;
+            }
+            scratch.resize(entries.size());
+
+            for (uint32_t shift = 0; shift < 64; shift += 8)
+            {
+                size_t counts[256] = {};
+                for (const auto& entry : entries)
+                {
+                    ++counts[(entry.key >> shift) & 0xff];
+                }
+                if (counts[(entries.front().key >> shift) & 0xff] == entries.size())
+                {
+                    continue;
+                }
+
+                size_t offset = 0;
+                for (size_t& count : counts)
+                {
+                    const size_t bucket = count;
+                    count = offset;
+                    offset += bucket;
+                }
+                for (const auto& entry : entries)
+                {
+                    scratch[counts[(entry.key >> shift) & 0xff]++] = entry;
+                }
+                entries.swap(scratch);
+            }
+        }
+
+        // Both colors are ABGR packed, channels are multiplied
+        uint32_t modulate_color(uint32_t abgr, const glm::vec4& tint)
+        {
+            const float channels[4] = { tint.r, tint.g, tint.b, tint.a };
+            uint32_t result = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const float value = static_cast<float>((abgr >> (i * 8)) & 0xff) * glm::clamp(channels[i], 0.0f, 1.0f);
+                result |= static_cast<uint32_t>(value + 0.5f) << (i * 8);
+            }
+            return result;
+        }
+
+        MeshBatchRenderer::SpriteInstance make_sprite_instance(const glm::vec3& pos, const glm::vec2& size,
+                                                               const glm::vec4& uv_rect, uint32_t color, uint16_t layer)
+        {
+            MeshBatchRenderer::SpriteInstance instance;
+            instance.axis_x[0] = size.x;
+            instance.axis_x[1] = 0.0f;
+            instance.axis_y[0] = 0.0f;
+            instance.axis_y[1] = size.y;
+            instance.translation[0] = pos.x;
+            instance.translation[1] = pos.y;
+            instance.translation[2] = pos.z;
+            instance.layer = static_cast<float>(layer);
+            instance.uv_rect[0] = uv_rect.x;
+            instance.uv_rect[1] = uv_rect.y;
+            instance.uv_rect[2] = uv_rect.z;
+            instance.uv_rect[3] = uv_rect.w;
+            for (int c = 0; c < 4; ++c)
+            {
+                instance.color[c] = static_cast<float>((color >> (c * 8)) & 0xff) / 255.0f;
+            }
+            return instance;
+        }
+    }
+
     bgfx::VertexLayout MeshBatchRenderer::PosTexColorVertex::ms_layout;
 
     void MeshBatchRenderer::PosTexColorVertex::init()
@@ -52,14 +197,71 @@ namespace cyanvne::runtime
                 .end();
     }
 
+    bgfx::VertexLayout MeshBatchRenderer::CompactVertex::ms_layout;
+
+    void MeshBatchRenderer::CompactVertex::init()
+    {
+        ms_layout
+                .begin()
+                .add(bgfx::Attrib::Position,  4, bgfx::AttribType::Int16, true)
+                .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Int16, true)
+                .add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Uint8, true)
+                .end();
+    }
+
     MeshBatchRenderer::MeshBatchRenderer()
             : m_program(BGFX_INVALID_HANDLE),
-              m_texColorUniform(BGFX_INVALID_HANDLE)
+              m_texColorUniform(BGFX_INVALID_HANDLE),
+              m_instancedProgram(BGFX_INVALID_HANDLE),
+              m_quadVbh(BGFX_INVALID_HANDLE),
+              m_quadIbh(BGFX_INVALID_HANDLE),
+              m_arrayProgram(BGFX_INVALID_HANDLE),
+              m_compactProgram(BGFX_INVALID_HANDLE),
+              m_compactOriginUniform(BGFX_INVALID_HANDLE),
+              m_sdfProgram(BGFX_INVALID_HANDLE),
+              m_staticProgram(BGFX_INVALID_HANDLE),
+              m_tintUniform(BGFX_INVALID_HANDLE)
     {
     }
 
     MeshBatchRenderer::~MeshBatchRenderer()
     {
+        if (bgfx::isValid(m_tintUniform))
+        {
+            bgfx::destroy(m_tintUniform);
+        }
+        if (bgfx::isValid(m_staticProgram))
+        {
+            bgfx::destroy(m_staticProgram);
+        }
+        if (bgfx::isValid(m_sdfProgram))
+        {
+            bgfx::destroy(m_sdfProgram);
+        }
+        if (bgfx::isValid(m_compactOriginUniform))
+        {
+            bgfx::destroy(m_compactOriginUniform);
+        }
+        if (bgfx::isValid(m_compactProgram))
+        {
+            bgfx::destroy(m_compactProgram);
+        }
+        if (bgfx::isValid(m_arrayProgram))
+        {
+            bgfx::destroy(m_arrayProgram);
+        }
+        if (bgfx::isValid(m_quadIbh))
+        {
+            bgfx::destroy(m_quadIbh);
+        }
+        if (bgfx::isValid(m_quadVbh))
+        {
+            bgfx::destroy(m_quadVbh);
+        }
+        if (bgfx::isValid(m_instancedProgram))
+        {
+            bgfx::destroy(m_instancedProgram);
+        }
         if (bgfx::isValid(m_texColorUniform))
         {
             bgfx::destroy(m_texColorUniform);
@@ -73,8 +275,10 @@ namespace cyanvne::runtime
     void MeshBatchRenderer::init()
     {
         PosTexColorVertex::init();
+        CompactVertex::init();
 
         m_texColorUniform = bgfx::createUniform("s_texColor", bgfx::UniformType::Sampler);
+        m_compactOriginUniform = bgfx::createUniform("u_compactOrigin", bgfx::UniformType::Vec4);
 
         bgfx::RendererType::Enum type = bgfx::getRendererType();
 
@@ -83,46 +287,518 @@ namespace cyanvne::runtime
 
         m_program = bgfx::createProgram(vs, fs, true);
 
+        bgfx::ShaderHandle compact_vs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_sprite_compact");
+        bgfx::ShaderHandle compact_fs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_sprite");
+        m_compactProgram = bgfx::createProgram(compact_vs, compact_fs, true);
+        if (!bgfx::isValid(m_compactProgram))
+        {
+            core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Compact vertex program unavailable, batches keep the full format.");
+        }
+
+        bgfx::ShaderHandle sdf_vs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_sprite");
+        bgfx::ShaderHandle sdf_fs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_sprite_sdf");
+        m_sdfProgram = bgfx::createProgram(sdf_vs, sdf_fs, true);
+        if (!bgfx::isValid(m_sdfProgram))
+        {
+            core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: SDF text program unavailable, glyph quads are dropped.");
+        }
+
+        m_tintUniform = bgfx::createUniform("u_tint", bgfx::UniformType::Vec4);
+        bgfx::ShaderHandle static_vs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_sprite_static");
+        bgfx::ShaderHandle static_fs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_sprite");
+        m_staticProgram = bgfx::createProgram(static_vs, static_fs, true);
+        if (!bgfx::isValid(m_staticProgram))
+        {
+            core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Static mesh program unavailable, static meshes use the vertex path.");
+        }
+
+        const bgfx::Caps* caps = bgfx::getCaps();
+        m_index32 = caps != nullptr && (caps->supported & BGFX_CAPS_INDEX32) != 0;
+        m_maxBatchVertices = m_index32 ? MAX_BATCH_VERTICES_32 : MAX_BATCH_VERTICES_16;
+
+        if (caps != nullptr && (caps->supported & BGFX_CAPS_INSTANCING) != 0)
+        {
+            bgfx::ShaderHandle instanced_vs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_sprite_instanced");
+            bgfx::ShaderHandle instanced_fs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_sprite");
+            m_instancedProgram = bgfx::createProgram(instanced_vs, instanced_fs, true);
+
+            // Corners in [0, 1], the instance transform places and sizes them
+            static const PosTexColorVertex quad_vertices[4] = {
+                    {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0xffffffff},
+                    {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0xffffffff},
+                    {1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0xffffffff},
+                    {0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0xffffffff}
+            };
+            static const uint16_t quad_indices[6] = { 0, 3, 2, 0, 2, 1 };
+            m_quadVbh = bgfx::createVertexBuffer(bgfx::makeRef(quad_vertices, sizeof(quad_vertices)), PosTexColorVertex::ms_layout);
+            m_quadIbh = bgfx::createIndexBuffer(bgfx::makeRef(quad_indices, sizeof(quad_indices)));
+
+            m_instancingSupported = bgfx::isValid(m_instancedProgram) && bgfx::isValid(m_quadVbh) && bgfx::isValid(m_quadIbh);
+
+            // The GLSL and ESSL profiles the shaders are compiled with have no array samplers
+            const bool array_shaders = type != bgfx::RendererType::OpenGL && type != bgfx::RendererType::OpenGLES;
+            if (m_instancingSupported && array_shaders && (caps->supported & BGFX_CAPS_TEXTURE_2D_ARRAY) != 0)
+            {
+                bgfx::ShaderHandle array_vs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_sprite_instanced_array");
+                bgfx::ShaderHandle array_fs = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_sprite_array");
+                m_arrayProgram = bgfx::createProgram(array_vs, array_fs, true);
+            }
+        }
+
+        if (!m_instancingSupported)
+        {
+            core::GlobalLogger::getCoreLogger()->info("MeshBatchRenderer: Instancing unavailable, sprites use the vertex path.");
+        }
+
         if (!bgfx::isValid(m_program))
         {
             core::GlobalLogger::getCoreLogger()->critical("MeshBatchRenderer: Failed to create shader program!");
         }
     }
 
-    void MeshBatchRenderer::beginFrame()
+    void MeshBatchRenderer::enableDynamicAtlas(const DynamicAtlas::Config& config)
     {
-        m_vertices.clear();
-        m_indices.clear();
-        m_batches.clear();
+        m_atlas = std::make_unique<DynamicAtlas>(config);
     }
 
-    void MeshBatchRenderer::submitSprite(bgfx::TextureHandle texture,
-                                         const glm::vec3& pos,
-                                         const glm::vec2& size,
-                                         const glm::vec4& uv_rect,
-                                         uint32_t color)
+    void MeshBatchRenderer::enableTextureArrays(const TextureArrayPool::Config& config)
     {
-        if (!bgfx::isValid(texture))
+        if (!bgfx::isValid(m_arrayProgram))
         {
+            core::GlobalLogger::getCoreLogger()->info("MeshBatchRenderer: Texture arrays unavailable on this renderer.");
             return;
         }
+        m_arrays = std::make_unique<TextureArrayPool>(config);
+    }
 
-        // Check if a new batch is needed (texture change or buffer overflow)
+    void MeshBatchRenderer::enableStaticMeshCache(entt::registry& registry)
+    {
+        m_staticMeshes = std::make_shared<StaticMeshCache>();
+        m_staticMeshes->connect(registry);
+    }
+
+    void MeshBatchRenderer::beginFrame()
+    {
+        clearPass();
+
+        if (m_atlas)
+        {
+            m_atlas->beginFrame();
+        }
+        if (m_arrays)
+        {
+            m_arrays->beginFrame();
+        }
+    }
+
+    void MeshBatchRenderer::clearPass()
+    {
+        m_vertices.clear();
+        m_compactVertices.clear();
+        m_indices.clear();
+        m_batches.clear();
+
+        m_stagedVertices.clear();
+        m_stagedIndices.clear();
+        m_commands.clear();
+        m_sortEntries.clear();
+
+        m_instances.clear();
+        m_stagedInstances.clear();
+        m_instanceSources.clear();
+        m_stagedInstanceSources.clear();
+
+        m_staticDraws.clear();
+        m_stagedStatic.clear();
+    }
+
+    void MeshBatchRenderer::prepareBatch(bgfx::TextureHandle texture, uint64_t state, uint32_t vertex_count, BatchKind kind)
+    {
+        // Check if a new batch is needed (texture, state or path change, or buffer overflow)
         bool needsNewBatch = m_batches.empty() ||
                              m_batches.back().texture.idx != texture.idx ||
-                             m_vertices.size() + 4 > MAX_VERTICES;
+                             m_batches.back().state != state ||
+                             m_batches.back().kind != kind ||
+                             kind == BatchKind::Static ||
+                             m_batches.back().numVertices + vertex_count > m_maxBatchVertices;
 
         if (needsNewBatch)
         {
             BatchInfo newBatch;
             newBatch.texture = texture;
+            newBatch.state = state;
+            newBatch.startVertex = static_cast<uint32_t>(m_vertices.size());
+            newBatch.numVertices = 0;
             newBatch.startIndex = static_cast<uint32_t>(m_indices.size());
             newBatch.numIndices = 0;
+            newBatch.kind = kind;
+            newBatch.startInstance = static_cast<uint32_t>(kind == BatchKind::Static ? m_staticDraws.size() : m_instances.size());
+            newBatch.numInstances = 0;
+            newBatch.origin = glm::vec4(0.0f);
             m_batches.push_back(newBatch);
         }
+    }
+
+    void MeshBatchRenderer::appendInstance(bgfx::TextureHandle texture, uint64_t state, const SpriteInstance& instance,
+                                           bgfx::TextureHandle source, BatchKind kind)
+    {
+        prepareBatch(texture, state, 0, kind);
+        m_instances.push_back(instance);
+        m_instanceSources.push_back(source);
+        ++m_batches.back().numInstances;
+    }
+
+    void MeshBatchRenderer::appendStatic(bgfx::TextureHandle texture, uint64_t state, const StaticDraw& draw)
+    {
+        prepareBatch(texture, state, 0, BatchKind::Static);
+        m_staticDraws.push_back(draw);
+        m_batches.back().numInstances = 1;
+    }
+
+    void MeshBatchRenderer::appendGeometry(bgfx::TextureHandle texture, uint64_t state,
+                                           const PosTexColorVertex* vertices, uint32_t vertex_count,
+                                           const uint32_t* indices, uint32_t index_count, BatchKind kind)
+    {
+        // The compact program only pairs with fs_sprite, SDF glyphs keep the full format
+        if (m_vertexFormat == VertexFormat::Compact && kind == BatchKind::Vertices &&
+            appendCompactGeometry(texture, state, vertices, vertex_count, indices, index_count))
+        {
+            return;
+        }
+
+        prepareBatch(texture, state, vertex_count, kind);
 
         BatchInfo& currentBatch = m_batches.back();
-        uint16_t startVtx = static_cast<uint16_t>(m_vertices.size());
+        const uint32_t baseVertex = currentBatch.numVertices;
+
+        m_vertices.insert(m_vertices.end(), vertices, vertices + vertex_count);
+
+        m_indices.reserve(m_indices.size() + index_count);
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            m_indices.push_back(baseVertex + indices[i]);
+        }
+
+        currentBatch.numVertices += vertex_count;
+        currentBatch.numIndices += index_count;
+    }
+
+    bool MeshBatchRenderer::appendCompactGeometry(bgfx::TextureHandle texture, uint64_t state,
+                                                  const PosTexColorVertex* vertices, uint32_t vertex_count,
+                                                  const uint32_t* indices, uint32_t index_count)
+    {
+        if (!bgfx::isValid(m_compactProgram) || vertex_count == 0)
+        {
+            return false;
+        }
+
+        const auto fits = [&](const glm::vec4& origin)
+        {
+            for (uint32_t i = 0; i < vertex_count; ++i)
+            {
+                const PosTexColorVertex& vertex = vertices[i];
+                const glm::vec3 steps = (glm::vec3(vertex.x, vertex.y, vertex.z) - glm::vec3(origin)) / origin.w;
+                if (glm::any(glm::greaterThan(glm::abs(steps), glm::vec3(COMPACT_RANGE))) ||
+                    vertex.u < 0.0f || vertex.u > 1.0f || vertex.v < 0.0f || vertex.v > 1.0f)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        const bool reuse = !m_batches.empty() &&
+                           m_batches.back().kind == BatchKind::Compact &&
+                           m_batches.back().texture.idx == texture.idx &&
+                           m_batches.back().state == state &&
+                           m_batches.back().numVertices + vertex_count <= m_maxBatchVertices &&
+                           fits(m_batches.back().origin);
+        if (!reuse)
+        {
+            // The first vertex anchors the batch, so nearby geometry keeps the full step precision
+            const glm::vec4 origin(vertices[0].x, vertices[0].y, vertices[0].z, m_compactStep);
+            if (!fits(origin))
+            {
+                return false;
+            }
+
+            BatchInfo newBatch{};
+            newBatch.texture = texture;
+            newBatch.state = state;
+            newBatch.startVertex = static_cast<uint32_t>(m_compactVertices.size());
+            newBatch.startIndex = static_cast<uint32_t>(m_indices.size());
+            newBatch.kind = BatchKind::Compact;
+            newBatch.origin = origin;
+            m_batches.push_back(newBatch);
+        }
+
+        BatchInfo& currentBatch = m_batches.back();
+        const uint32_t baseVertex = currentBatch.numVertices;
+        const glm::vec3 origin(currentBatch.origin);
+        const float step = currentBatch.origin.w;
+
+        m_compactVertices.reserve(m_compactVertices.size() + vertex_count);
+        for (uint32_t i = 0; i < vertex_count; ++i)
+        {
+            const PosTexColorVertex& vertex = vertices[i];
+            const glm::vec3 steps = glm::round((glm::vec3(vertex.x, vertex.y, vertex.z) - origin) / step);
+
+            CompactVertex compact;
+            compact.x = static_cast<int16_t>(steps.x);
+            compact.y = static_cast<int16_t>(steps.y);
+            compact.z = static_cast<int16_t>(steps.z);
+            compact.w = 0;
+            compact.u = static_cast<int16_t>(std::lround(vertex.u * COMPACT_RANGE));
+            compact.v = static_cast<int16_t>(std::lround(vertex.v * COMPACT_RANGE));
+            compact.rgba = vertex.rgba;
+            m_compactVertices.push_back(compact);
+        }
+
+        m_indices.reserve(m_indices.size() + index_count);
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            m_indices.push_back(baseVertex + indices[i]);
+        }
+
+        currentBatch.numVertices += vertex_count;
+        currentBatch.numIndices += index_count;
+        return true;
+    }
+
+    uint64_t MeshBatchRenderer::makeSortKey(uint8_t sort_layer, bool translucent, SpriteProgram program,
+                                            const glm::vec3& anchor, uint32_t sequence) const
+    {
+        // View space distance, the camera looks down -Z
+        const float depth = -(m_viewMatrix[0][2] * anchor.x + m_viewMatrix[1][2] * anchor.y +
+                              m_viewMatrix[2][2] * anchor.z + m_viewMatrix[3][2]);
+        const uint64_t depth_bits = sortable_float_bits(depth) >> 8;                 // 24 bits
+        const uint64_t program_bits = static_cast<uint64_t>(program) & 0xf;          // 4 bits
+
+        uint64_t key = static_cast<uint64_t>(sort_layer) << 56;
+        if (!translucent)
+        {
+            // layer | 0 | program | depth (front-to-back) | sequence. Opaque draws test LESS, so among coplanar
+            // sprites the first one drawn wins, ties must keep submission order to match Immediate mode.
+            // The texture is left to the batch merge, like for translucent draws
+            key |= program_bits << 51 | depth_bits << 27 | (static_cast<uint64_t>(sequence) & 0x7ffffff);
+        }
+        else
+        {
+            // layer | 1 | inverted depth (back-to-front) | sequence. Blending needs the order, and coplanar
+            // sprites (every VN sprite sits at z = 0) must keep their submission order, not their texture order.
+            // Neighbours that still share program and texture merge into one batch afterwards
+            key |= 1ull << 55 | (~depth_bits & 0xffffff) << 31 | (static_cast<uint64_t>(sequence) & 0x7fffffff);
+        }
+        return key;
+    }
+
+    void MeshBatchRenderer::record(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                                   const PosTexColorVertex* vertices, uint32_t vertex_count,
+                                   const uint32_t* indices, uint32_t index_count, BatchKind kind)
+    {
+        if (m_mode == SubmissionMode::Immediate)
+        {
+            appendGeometry(texture, IMMEDIATE_STATE, vertices, vertex_count, indices, index_count, kind);
+            return;
+        }
+
+        DrawCommand command{};
+        command.texture = texture;
+        command.translucent = !opaque;
+        command.kind = kind;
+        command.firstVertex = static_cast<uint32_t>(m_stagedVertices.size());
+        command.vertexCount = vertex_count;
+        command.firstIndex = static_cast<uint32_t>(m_stagedIndices.size());
+        command.indexCount = index_count;
+
+        m_stagedVertices.insert(m_stagedVertices.end(), vertices, vertices + vertex_count);
+        m_stagedIndices.insert(m_stagedIndices.end(), indices, indices + index_count);
+
+        const SpriteProgram program = kind == BatchKind::SdfText ? SpriteProgram::SpriteSdf : SpriteProgram::Sprite;
+        m_sortEntries.push_back({ makeSortKey(sort_layer, command.translucent, program, anchor,
+                                              static_cast<uint32_t>(m_commands.size())),
+                                  static_cast<uint32_t>(m_commands.size()) });
+        m_commands.push_back(command);
+    }
+
+    void MeshBatchRenderer::recordSplit(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                                        const PosTexColorVertex* vertices, uint32_t vertex_count,
+                                        const uint32_t* indices, uint32_t index_count)
+    {
+        constexpr uint32_t UNMAPPED = std::numeric_limits<uint32_t>::max();
+
+        // Each piece copies the vertices its triangles use, shared vertices are duplicated across pieces
+        m_splitRemap.assign(vertex_count, UNMAPPED);
+        m_splitVertices.clear();
+        m_splitIndices.clear();
+
+        uint32_t pieceBegin = 0;
+        const auto emit = [&](uint32_t piece_end)
+        {
+            if (m_splitIndices.empty())
+            {
+                return;
+            }
+            record(texture, anchor, opaque, sort_layer,
+                   m_splitVertices.data(), static_cast<uint32_t>(m_splitVertices.size()),
+                   m_splitIndices.data(), static_cast<uint32_t>(m_splitIndices.size()));
+
+            // Only the vertices this piece touched are reset, not the whole remap table
+            for (uint32_t i = pieceBegin; i < piece_end; ++i)
+            {
+                if (indices[i] < vertex_count)
+                {
+                    m_splitRemap[indices[i]] = UNMAPPED;
+                }
+            }
+            pieceBegin = piece_end;
+            m_splitVertices.clear();
+            m_splitIndices.clear();
+        };
+
+        for (uint32_t i = 0; i + 2 < index_count; i += 3)
+        {
+            uint32_t missing = 0;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t index = indices[i + corner];
+                if (index >= vertex_count)
+                {
+                    core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Mesh index {} is out of range, triangle skipped.", index);
+                    missing = UNMAPPED;
+                    break;
+                }
+                missing += m_splitRemap[index] == UNMAPPED ? 1 : 0;
+            }
+            if (missing == UNMAPPED)
+            {
+                continue;
+            }
+
+            if (m_splitVertices.size() + missing > m_maxBatchVertices)
+            {
+                emit(i);
+            }
+
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t index = indices[i + corner];
+                if (m_splitRemap[index] == UNMAPPED)
+                {
+                    m_splitRemap[index] = static_cast<uint32_t>(m_splitVertices.size());
+                    m_splitVertices.push_back(vertices[index]);
+                }
+                m_splitIndices.push_back(m_splitRemap[index]);
+            }
+        }
+        emit(index_count);
+    }
+
+    void MeshBatchRenderer::recordInstance(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                                           const SpriteInstance& instance, bgfx::TextureHandle source, bool array_layer)
+    {
+        const BatchKind kind = array_layer ? BatchKind::InstancedArray : BatchKind::Instanced;
+        if (m_mode == SubmissionMode::Immediate)
+        {
+            appendInstance(texture, IMMEDIATE_STATE, instance, source, kind);
+            return;
+        }
+
+        DrawCommand command{};
+        command.texture = texture;
+        command.translucent = !opaque;
+        command.kind = kind;
+        command.instance = static_cast<uint32_t>(m_stagedInstances.size());
+        m_stagedInstances.push_back(instance);
+        m_stagedInstanceSources.push_back(source);
+
+        const SpriteProgram program = array_layer ? SpriteProgram::SpriteInstancedArray : SpriteProgram::SpriteInstanced;
+        m_sortEntries.push_back({ makeSortKey(sort_layer, command.translucent, program, anchor,
+                                              static_cast<uint32_t>(m_commands.size())),
+                                  static_cast<uint32_t>(m_commands.size()) });
+        m_commands.push_back(command);
+    }
+
+    void MeshBatchRenderer::recordStatic(bgfx::TextureHandle texture, bool opaque, uint8_t sort_layer, const StaticDraw& draw)
+    {
+        if (m_mode == SubmissionMode::Immediate)
+        {
+            appendStatic(texture, IMMEDIATE_STATE, draw);
+            return;
+        }
+
+        DrawCommand command{};
+        command.texture = texture;
+        command.translucent = !opaque;
+        command.kind = BatchKind::Static;
+        command.instance = static_cast<uint32_t>(m_stagedStatic.size());
+        m_stagedStatic.push_back(draw);
+
+        const glm::vec3 anchor = glm::vec3(draw.transform[3]);
+        m_sortEntries.push_back({ makeSortKey(sort_layer, command.translucent, SpriteProgram::Sprite, anchor,
+                                              static_cast<uint32_t>(m_commands.size())),
+                                  static_cast<uint32_t>(m_commands.size()) });
+        m_commands.push_back(command);
+    }
+
+    void MeshBatchRenderer::resolveDeferred()
+    {
+        if (m_commands.empty())
+        {
+            return;
+        }
+
+        radix_sort_by_key(m_sortEntries, m_sortScratch);
+
+        for (const auto& entry : m_sortEntries)
+        {
+            const DrawCommand& command = m_commands[entry.command];
+            const uint64_t state = command.translucent ? TRANSLUCENT_STATE : OPAQUE_STATE;
+            if (command.kind == BatchKind::Instanced || command.kind == BatchKind::InstancedArray)
+            {
+                appendInstance(command.texture, state, m_stagedInstances[command.instance],
+                               m_stagedInstanceSources[command.instance], command.kind);
+                continue;
+            }
+            if (command.kind == BatchKind::Static)
+            {
+                appendStatic(command.texture, state, m_stagedStatic[command.instance]);
+                continue;
+            }
+            appendGeometry(command.texture, state,
+                           m_stagedVertices.data() + command.firstVertex, command.vertexCount,
+                           m_stagedIndices.data() + command.firstIndex, command.indexCount, command.kind);
+        }
+
+        m_sortEntries.clear();
+        m_stagedVertices.clear();
+        m_stagedIndices.clear();
+        m_stagedInstances.clear();
+        m_stagedInstanceSources.clear();
+        m_stagedStatic.clear();
+        m_commands.clear();
+    }
+
+    void MeshBatchRenderer::submitSprite(bgfx::TextureHandle texture,
+                                         const glm::vec3& pos,
+                                         const glm::vec2& size,
+                                         const glm::vec4& uv_rect,
+                                         uint32_t color,
+                                         bool opaque,
+                                         uint8_t sort_layer)
+    {
+        if (!bgfx::isValid(texture))
+        {
+            return;
+        }
+
+        const bool color_opaque = (color >> 24) == 0xff;
+
+        if (m_spritePath == SpritePath::Instanced && m_instancingSupported)
+        {
+            recordInstance(texture, pos, opaque && color_opaque, sort_layer, make_sprite_instance(pos, size, uv_rect, color, 0), texture);
+            return;
+        }
 
         float u0 = uv_rect.x;
         float v0 = uv_rect.y;
@@ -130,68 +806,626 @@ namespace cyanvne::runtime
         float v1 = uv_rect.y + uv_rect.w; // y + h
 
         // 0: TL, 1: TR, 2: BR, 3: BL
-        m_vertices.push_back({pos.x,          pos.y,          pos.z, u0, v0, color}); // 0
-        m_vertices.push_back({pos.x + size.x, pos.y,          pos.z, u1, v0, color}); // 1
-        m_vertices.push_back({pos.x + size.x, pos.y + size.y, pos.z, u1, v1, color}); // 2
-        m_vertices.push_back({pos.x,          pos.y + size.y, pos.z, u0, v1, color}); // 3
+        const PosTexColorVertex vertices[4] = {
+                {pos.x,          pos.y,          pos.z, u0, v0, color},
+                {pos.x + size.x, pos.y,          pos.z, u1, v0, color},
+                {pos.x + size.x, pos.y + size.y, pos.z, u1, v1, color},
+                {pos.x,          pos.y + size.y, pos.z, u0, v1, color}
+        };
+
+        record(texture, pos, opaque && color_opaque, sort_layer, vertices, 4, SPRITE_INDICES, 6);
+    }
+
+    void MeshBatchRenderer::submitSdfQuad(bgfx::TextureHandle texture,
+                                          const glm::vec3& pos,
+                                          const glm::vec2& size,
+                                          const glm::vec4& uv_rect,
+                                          uint32_t color,
+                                          uint8_t sort_layer)
+    {
+        if (!bgfx::isValid(texture) || !bgfx::isValid(m_sdfProgram))
+        {
+            return;
+        }
+
+        const float u0 = uv_rect.x;
+        const float v0 = uv_rect.y;
+        const float u1 = uv_rect.x + uv_rect.z;
+        const float v1 = uv_rect.y + uv_rect.w;
+
+        const PosTexColorVertex vertices[4] = {
+                {pos.x,          pos.y,          pos.z, u0, v0, color},
+                {pos.x + size.x, pos.y,          pos.z, u1, v0, color},
+                {pos.x + size.x, pos.y + size.y, pos.z, u1, v1, color},
+                {pos.x,          pos.y + size.y, pos.z, u0, v1, color}
+        };
+
+        // Glyph edges are always blended
+        record(texture, pos, false, sort_layer, vertices, 4, SPRITE_INDICES, 6, BatchKind::SdfText);
+    }
+
+    void MeshBatchRenderer::submitFullscreenQuad(bgfx::TextureHandle texture, bool premultiplied)
+    {
+        if (!bgfx::isValid(texture))
+        {
+            return;
+        }
+
+        // Render targets are stored bottom-up where the clip space origin is at the bottom
+        const bgfx::Caps* caps = bgfx::getCaps();
+        const bool flip = caps != nullptr && caps->originBottomLeft;
+        const float top = flip ? 1.0f : 0.0f;
+        const float bottom = flip ? 0.0f : 1.0f;
+
+        const PosTexColorVertex vertices[4] = {
+                {-1.0f,  1.0f, 0.0f, 0.0f, top,    0xffffffff},
+                { 1.0f,  1.0f, 0.0f, 1.0f, top,    0xffffffff},
+                { 1.0f, -1.0f, 0.0f, 1.0f, bottom, 0xffffffff},
+                {-1.0f, -1.0f, 0.0f, 0.0f, bottom, 0xffffffff}
+        };
+        appendGeometry(texture, premultiplied ? COMPOSITE_STATE : IMMEDIATE_STATE, vertices, 4, SPRITE_INDICES, 6);
+    }
+
+    void MeshBatchRenderer::submitSprite(const resources::TextureResource& texture,
+                                         const glm::vec3& pos,
+                                         const glm::vec2& size,
+                                         const glm::vec4& uv_rect,
+                                         uint32_t color,
+                                         bool opaque,
+                                         uint8_t sort_layer)
+    {
+        // The atlas records its copies on the current view, which only exists between begin() and end()
+        if (m_atlas && m_inPass && is_unit_uv_rect(uv_rect))
+        {
+            if (auto region = m_atlas->acquire(texture))
+            {
+                const glm::vec4 remapped = {
+                        region->uv_rect.x + uv_rect.x * region->uv_rect.z,
+                        region->uv_rect.y + uv_rect.y * region->uv_rect.w,
+                        uv_rect.z * region->uv_rect.z,
+                        uv_rect.w * region->uv_rect.w
+                };
+                submitSprite(region->texture, pos, size, remapped, color, opaque, sort_layer);
+                return;
+            }
+        }
+
+        if (m_arrays && m_inPass && m_spritePath == SpritePath::Instanced && m_instancingSupported)
+        {
+            if (auto slot = m_arrays->acquire(texture))
+            {
+                recordInstance(slot->texture, pos, opaque && (color >> 24) == 0xff, sort_layer,
+                               make_sprite_instance(pos, size, uv_rect, color, slot->layer), texture.texture_handle, true);
+                return;
+            }
+        }
+
+        submitSprite(texture.texture_handle, pos, size, uv_rect, color, opaque, sort_layer);
+    }
+
+    void MeshBatchRenderer::begin(bgfx::ViewId view_id, const glm::mat4& view_matrix, bgfx::Encoder* encoder)
+    {
+        m_ownsEncoder = encoder == nullptr;
+        m_encoder = m_ownsEncoder ? bgfx::begin() : encoder;
+        m_viewId = view_id;
+        m_viewMatrix = view_matrix;
+        m_inPass = true;
+        clearPass();
+    }
+
+    void MeshBatchRenderer::submit(const glm::mat4& world_transform, const MeshComponent& mesh, const MaterialComponent& material,
+                                   entt::entity entity)
+    {
+        if (mesh.vertices.empty() || mesh.indices.empty())
+        {
+            return;
+        }
+
+        const bool tinted = material.color != glm::vec4(1.0f);
+        const bool opaque = material.is_opaque && material.color.a >= 1.0f;
+        // Resident buffers hold the authored vertices, the static program applies the tint and atlas remapping needs the CPU path
+        const bool use_static = mesh.is_static && m_staticMeshes && entity != entt::null && bgfx::isValid(m_staticProgram);
+
+        bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+        glm::vec4 uv_region = { 0.0f, 0.0f, 1.0f, 1.0f };
+        bool remap_uv = false;
+
+        if (const auto* pinned = std::get_if<PinnedTexture>(&material.resource_handle))
+        {
+            texture = pinned->texture_handle;
+        }
+        else if (const auto* streamed = std::get_if<resources::ResourceHandle<resources::StreamingTextureResource>>(&material.resource_handle))
+        {
+            // The handle changes as finer levels arrive, and those are too large for the atlas anyway
+            if (const resources::StreamingTextureResource* resource = streamed->get())
+            {
+                texture = resource->texture_handle;
+            }
+        }
+        else if (const auto* handle = std::get_if<resources::ResourceHandle<resources::TextureResource>>(&material.resource_handle))
+        {
+            const resources::TextureResource* resource = handle->get();
+            if (resource == nullptr)
+            {
+                return;
+            }
+            texture = resource->texture_handle;
 
-        m_indices.push_back(startVtx + 0);
-        m_indices.push_back(startVtx + 3);
-        m_indices.push_back(startVtx + 2);
+            if (m_atlas && !use_static)
+            {
+                bool unit_uvs = true;
+                for (const auto& vertex : mesh.vertices)
+                {
+                    if (vertex.u < 0.0f || vertex.u > 1.0f || vertex.v < 0.0f || vertex.v > 1.0f)
+                    {
+                        unit_uvs = false;
+                        break;
+                    }
+                }
 
-        m_indices.push_back(startVtx + 0);
-        m_indices.push_back(startVtx + 2);
-        m_indices.push_back(startVtx + 1);
+                if (unit_uvs)
+                {
+                    if (auto region = m_atlas->acquire(*resource))
+                    {
+                        texture = region->texture;
+                        uv_region = region->uv_rect;
+                        remap_uv = true;
+                    }
+                }
+            }
+        }
+
+        if (!bgfx::isValid(texture))
+        {
+            return;
+        }
 
-        currentBatch.numIndices += 6;
+        if (use_static)
+        {
+            if (const auto resident = m_staticMeshes->acquire(entity, mesh))
+            {
+                recordStatic(texture, opaque, mesh.sort_layer, { resident->vbh, resident->ibh, resident->num_indices, world_transform,
+                                                                  glm::clamp(material.color, 0.0f, 1.0f) });
+                return;
+            }
+        }
+
+        m_meshScratch.clear();
+        m_meshScratch.reserve(mesh.vertices.size());
+        for (const auto& vertex : mesh.vertices)
+        {
+            const glm::vec4 position = world_transform * glm::vec4(vertex.x, vertex.y, vertex.z, 1.0f);
+
+            PosTexColorVertex out;
+            out.x = position.x;
+            out.y = position.y;
+            out.z = position.z;
+            out.u = remap_uv ? uv_region.x + vertex.u * uv_region.z : vertex.u;
+            out.v = remap_uv ? uv_region.y + vertex.v * uv_region.w : vertex.v;
+            out.rgba = tinted ? modulate_color(vertex.rgba, material.color) : vertex.rgba;
+            m_meshScratch.push_back(out);
+        }
+
+        const glm::vec3 anchor = glm::vec3(world_transform[3]);
+        if (m_meshScratch.size() > m_maxBatchVertices)
+        {
+            recordSplit(texture, anchor, opaque, mesh.sort_layer,
+                        m_meshScratch.data(), static_cast<uint32_t>(m_meshScratch.size()),
+                        mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()));
+            return;
+        }
+
+        record(texture, anchor, opaque, mesh.sort_layer,
+               m_meshScratch.data(), static_cast<uint32_t>(m_meshScratch.size()),
+               mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()));
     }
 
-    void MeshBatchRenderer::flush(core::RenderLayer layer)
+    void MeshBatchRenderer::end()
     {
-        if (m_vertices.empty() || m_batches.empty())
+        flush(m_viewId);
+        m_inPass = false;
+
+        if (m_ownsEncoder)
+        {
+            bgfx::end(m_encoder);
+        }
+        m_encoder = nullptr;
+    }
+
+    void MeshBatchRenderer::flush(bgfx::ViewId view_id)
+    {
+        m_lastDrawCalls = 0;
+
+        if (m_mode == SubmissionMode::Deferred)
+        {
+            resolveDeferred();
+        }
+
+        if (m_batches.empty())
         {
             return;
         }
 
-        uint32_t numVertices = static_cast<uint32_t>(m_vertices.size());
-        uint32_t numIndices = static_cast<uint32_t>(m_indices.size());
+        // Pack as many whole batches as the transient buffers still hold into each allocation
+        size_t first = 0;
+        bool transient = true;
+        while (first < m_batches.size())
+        {
+            const size_t last = chunkEnd(first, transient);
+            const size_t submitted = last == first ? first : submitBatches(view_id, first, last, transient);
+            if (submitted == first)
+            {
+                // Transient space ran out, the rest goes through buffers that live for this frame only
+                core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Transient buffers exhausted, {} batches use one-shot buffers. "
+                                                          "Consider raising bgfx transient buffer sizes.", m_batches.size() - first);
+                transient = false;
+                continue;
+            }
+
+            first = submitted;
+        }
+    }
+
+    uint64_t MeshBatchRenderer::resolveState(uint64_t state) const
+    {
+        if (!m_premultipliedOutput || (state & BGFX_STATE_BLEND_MASK) != BGFX_STATE_BLEND_ALPHA)
+        {
+            return state;
+        }
+        return (state & ~BGFX_STATE_BLEND_MASK) | PREMULTIPLIED_OUTPUT_BLEND;
+    }
 
-        if (bgfx::getAvailTransientVertexBuffer(numVertices, PosTexColorVertex::ms_layout) < numVertices ||
-            bgfx::getAvailTransientIndexBuffer(numIndices) < numIndices)
+    void MeshBatchRenderer::copyIndices(void* dst, uint32_t first_index, uint32_t index_count) const
+    {
+        if (m_index32)
         {
-            core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Transient buffer overflow!");
+            std::memcpy(dst, m_indices.data() + first_index, index_count * sizeof(uint32_t));
             return;
         }
 
+        // Batches never exceed 65536 vertices in 16-bit mode, so the relative indices always fit
+        auto* out = static_cast<uint16_t*>(dst);
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            out[i] = static_cast<uint16_t>(m_indices[first_index + i]);
+        }
+    }
+
+    size_t MeshBatchRenderer::chunkEnd(size_t first_batch, bool transient) const
+    {
+        // A chunk is drawn from one vertex allocation, so it never mixes full and compact vertices
+        const uint32_t unlimited = std::numeric_limits<uint32_t>::max();
+        const uint32_t remainingIndices = static_cast<uint32_t>(m_indices.size()) - m_batches[first_batch].startIndex;
+        const uint32_t availIndices = transient ? bgfx::getAvailTransientIndexBuffer(remainingIndices, m_index32) : unlimited;
+        uint32_t availVertices = unlimited;
+        std::optional<bool> compact;
+
+        size_t last = first_batch;
+        uint32_t chunkVertices = 0;
+        uint32_t chunkIndices = 0;
+        while (last < m_batches.size())
+        {
+            const BatchInfo& batch = m_batches[last];
+            if (batch.numVertices > 0)
+            {
+                const bool batchCompact = batch.kind == BatchKind::Compact;
+                if (!compact)
+                {
+                    compact = batchCompact;
+                    if (transient)
+                    {
+                        const uint32_t remainingVertices = static_cast<uint32_t>(batchCompact ? m_compactVertices.size() : m_vertices.size()) -
+                                                           batch.startVertex;
+                        availVertices = bgfx::getAvailTransientVertexBuffer(remainingVertices, batchCompact ? CompactVertex::ms_layout
+                                                                                                           : PosTexColorVertex::ms_layout);
+                    }
+                }
+                else if (*compact != batchCompact)
+                {
+                    break;
+                }
+            }
+
+            if (chunkVertices + batch.numVertices > availVertices || chunkIndices + batch.numIndices > availIndices)
+            {
+                break;
+            }
+            chunkVertices += batch.numVertices;
+            chunkIndices += batch.numIndices;
+            ++last;
+        }
+        return last;
+    }
+
+    size_t MeshBatchRenderer::submitBatches(bgfx::ViewId view_id, size_t first_batch, size_t last_batch, bool transient)
+    {
+        const BatchInfo& first = m_batches[first_batch];
+        const BatchInfo& last = m_batches[last_batch - 1];
+        const uint32_t numIndices = last.startIndex + last.numIndices - first.startIndex;
+
+        // Instanced and static batches own no vertices, their startVertex does not belong to the chunk's stream
+        const BatchInfo* firstGeometry = nullptr;
+        const BatchInfo* lastGeometry = nullptr;
+        for (size_t i = first_batch; i < last_batch; ++i)
+        {
+            if (m_batches[i].numVertices > 0)
+            {
+                firstGeometry = firstGeometry != nullptr ? firstGeometry : &m_batches[i];
+                lastGeometry = &m_batches[i];
+            }
+        }
+
+        const bool compact = firstGeometry != nullptr && firstGeometry->kind == BatchKind::Compact;
+        const uint32_t firstVertex = firstGeometry != nullptr ? firstGeometry->startVertex : 0;
+        const uint32_t numVertices = firstGeometry != nullptr ? lastGeometry->startVertex + lastGeometry->numVertices - firstVertex : 0;
+        const bgfx::VertexLayout& layout = compact ? CompactVertex::ms_layout : PosTexColorVertex::ms_layout;
+        const void* vertexData = compact ? static_cast<const void*>(m_compactVertices.data() + firstVertex)
+                                         : static_cast<const void*>(m_vertices.data() + firstVertex);
+        const uint32_t vertexBytes = numVertices * layout.getStride();
+
         bgfx::TransientVertexBuffer tvb;
         bgfx::TransientIndexBuffer tib;
+        bgfx::VertexBufferHandle vbh = BGFX_INVALID_HANDLE;
+        bgfx::IndexBufferHandle ibh = BGFX_INVALID_HANDLE;
+
+        // Chunks made only of instanced and static batches carry no vertices of their own
+        const bool hasGeometry = numVertices > 0 && numIndices > 0;
+        if (hasGeometry && transient)
+        {
+            // chunkEnd() only saw what was free at the time, worker encoders share the transient buffers,
+            // so bgfx may hand back less. Only the whole batches that fit are drawn, the caller re-chunks the rest
+            bgfx::allocTransientVertexBuffer(&tvb, numVertices, layout);
+            bgfx::allocTransientIndexBuffer(&tib, numIndices, m_index32);
 
-        bgfx::allocTransientVertexBuffer(&tvb, numVertices, PosTexColorVertex::ms_layout);
-        bgfx::allocTransientIndexBuffer(&tib, numIndices);
+            const uint32_t gotVertices = tvb.size / layout.getStride();
+            const uint32_t gotIndices = tib.size / (m_index32 ? sizeof(uint32_t) : sizeof(uint16_t));
+            if (gotVertices < numVertices || gotIndices < numIndices)
+            {
+                size_t fitted = first_batch;
+                uint32_t usedVertices = 0;
+                uint32_t usedIndices = 0;
+                while (fitted < last_batch)
+                {
+                    const BatchInfo& batch = m_batches[fitted];
+                    if (batch.numVertices > 0 &&
+                        (batch.startVertex + batch.numVertices - firstVertex > gotVertices ||
+                         batch.startIndex + batch.numIndices - first.startIndex > gotIndices))
+                    {
+                        break;
+                    }
+                    if (batch.numVertices > 0)
+                    {
+                        usedVertices = batch.startVertex + batch.numVertices - firstVertex;
+                        usedIndices = batch.startIndex + batch.numIndices - first.startIndex;
+                    }
+                    ++fitted;
+                }
 
-        std::memcpy(tvb.data, m_vertices.data(), numVertices * sizeof(PosTexColorVertex));
-        std::memcpy(tib.data, m_indices.data(), numIndices * sizeof(uint16_t));
+                if (fitted == first_batch)
+                {
+                    return first_batch;
+                }
+                last_batch = fitted;
+                std::memcpy(tvb.data, vertexData, usedVertices * layout.getStride());
+                copyIndices(tib.data, first.startIndex, usedIndices);
+            }
+            else
+            {
+                std::memcpy(tvb.data, vertexData, vertexBytes);
+                copyIndices(tib.data, first.startIndex, numIndices);
+            }
+        }
+        else if (hasGeometry)
+        {
+            const bgfx::Memory* indexMem = bgfx::alloc(numIndices * (m_index32 ? sizeof(uint32_t) : sizeof(uint16_t)));
+            copyIndices(indexMem->data, first.startIndex, numIndices);
+
+            vbh = bgfx::createVertexBuffer(bgfx::copy(vertexData, vertexBytes), layout);
+            ibh = bgfx::createIndexBuffer(indexMem, m_index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
 
-        for (const auto& batch : m_batches)
+            if (!bgfx::isValid(vbh) || !bgfx::isValid(ibh))
+            {
+                core::GlobalLogger::getCoreLogger()->error("MeshBatchRenderer: Failed to create overflow buffers, {} batches dropped.",
+                                                           last_batch - first_batch);
+                if (bgfx::isValid(vbh)) bgfx::destroy(vbh);
+                if (bgfx::isValid(ibh)) bgfx::destroy(ibh);
+                return last_batch;
+            }
+        }
+
+        for (size_t i = first_batch; i < last_batch; ++i)
         {
+            const BatchInfo& batch = m_batches[i];
+            if (batch.kind == BatchKind::Instanced || batch.kind == BatchKind::InstancedArray)
+            {
+                drawInstancedBatch(view_id, batch);
+                continue;
+            }
+            if (batch.kind == BatchKind::Static)
+            {
+                drawStaticBatch(view_id, batch);
+                continue;
+            }
             if (batch.numIndices == 0) continue;
 
-            uint64_t state = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
-                             BGFX_STATE_DEPTH_TEST_LESS |
-                             BGFX_STATE_BLEND_ALPHA;
+            m_encoder->setState(resolveState(batch.state));
+
+            m_encoder->setTexture(0, m_texColorUniform, batch.texture);
+            if (transient)
+            {
+                m_encoder->setVertexBuffer(0, &tvb, batch.startVertex - firstVertex, batch.numVertices);
+                m_encoder->setIndexBuffer(&tib, batch.startIndex - first.startIndex, batch.numIndices);
+            }
+            else
+            {
+                m_encoder->setVertexBuffer(0, vbh, batch.startVertex - firstVertex, batch.numVertices);
+                m_encoder->setIndexBuffer(ibh, batch.startIndex - first.startIndex, batch.numIndices);
+            }
+
+            if (batch.kind == BatchKind::Compact)
+            {
+                m_encoder->setUniform(m_compactOriginUniform, &batch.origin);
+            }
+            bgfx::ProgramHandle program = m_program;
+            if (batch.kind == BatchKind::Compact)
+            {
+                program = m_compactProgram;
+            }
+            else if (batch.kind == BatchKind::SdfText)
+            {
+                program = m_sdfProgram;
+            }
+            m_encoder->submit(view_id, program);
+            ++m_lastDrawCalls;
+        }
+
+        // Destruction is deferred by bgfx until the frame that uses them has been rendered
+        if (bgfx::isValid(vbh)) bgfx::destroy(vbh);
+        if (bgfx::isValid(ibh)) bgfx::destroy(ibh);
+        return last_batch;
+    }
+
+    void MeshBatchRenderer::drawInstancedBatch(bgfx::ViewId view_id, const BatchInfo& batch)
+    {
+        uint32_t submitted = 0;
+        while (submitted < batch.numInstances)
+        {
+            const uint32_t wanted = batch.numInstances - submitted;
+            const uint32_t count = bgfx::getAvailInstanceDataBuffer(wanted, INSTANCE_STRIDE);
+            if (count == 0)
+            {
+                drawInstancesAsVertices(view_id, batch, submitted, wanted);
+                return;
+            }
+
+            // Other encoders may have taken the space since the query, bgfx then allocates fewer instances
+            bgfx::InstanceDataBuffer idb;
+            bgfx::allocInstanceDataBuffer(&idb, count, INSTANCE_STRIDE);
+            if (idb.num == 0)
+            {
+                drawInstancesAsVertices(view_id, batch, submitted, wanted);
+                return;
+            }
+            std::memcpy(idb.data, m_instances.data() + batch.startInstance + submitted, idb.num * sizeof(SpriteInstance));
+
+            m_encoder->setState(resolveState(batch.state));
+            m_encoder->setTexture(0, m_texColorUniform, batch.texture);
+            m_encoder->setVertexBuffer(0, m_quadVbh);
+            m_encoder->setIndexBuffer(m_quadIbh);
+            m_encoder->setInstanceDataBuffer(&idb);
+
+            m_encoder->submit(view_id, batch.kind == BatchKind::InstancedArray ? m_arrayProgram : m_instancedProgram);
+            ++m_lastDrawCalls;
+            submitted += idb.num;
+        }
+    }
+
+    void MeshBatchRenderer::drawInstancesAsVertices(bgfx::ViewId view_id, const BatchInfo& batch, uint32_t first, uint32_t count)
+    {
+        core::GlobalLogger::getCoreLogger()->warn("MeshBatchRenderer: Instance data buffer exhausted, {} sprites drawn as vertices. "
+                                                  "Consider raising the bgfx instance buffer size.", count);
+
+        // 16-bit indices cover 16384 quads per draw
+        constexpr uint32_t MAX_RUN_SPRITES = 65536 / 4;
+
+        const auto drawRun = [&](bgfx::TextureHandle texture)
+        {
+            const uint32_t sprites = static_cast<uint32_t>(m_fallbackVertices.size() / 4);
+            if (sprites == 0 || !bgfx::isValid(texture))
+            {
+                m_fallbackVertices.clear();
+                return;
+            }
+
+            const bgfx::Memory* indexMem = bgfx::alloc(sprites * 6 * sizeof(uint16_t));
+            auto* indices = reinterpret_cast<uint16_t*>(indexMem->data);
+            for (uint32_t sprite = 0; sprite < sprites; ++sprite)
+            {
+                for (uint32_t i = 0; i < 6; ++i)
+                {
+                    indices[sprite * 6 + i] = static_cast<uint16_t>(sprite * 4 + SPRITE_INDICES[i]);
+                }
+            }
+
+            const bgfx::VertexBufferHandle vbh = bgfx::createVertexBuffer(
+                    bgfx::copy(m_fallbackVertices.data(), static_cast<uint32_t>(m_fallbackVertices.size() * sizeof(PosTexColorVertex))),
+                    PosTexColorVertex::ms_layout);
+            const bgfx::IndexBufferHandle ibh = bgfx::createIndexBuffer(indexMem);
+            if (bgfx::isValid(vbh) && bgfx::isValid(ibh))
+            {
+                m_encoder->setState(resolveState(batch.state));
+                m_encoder->setTexture(0, m_texColorUniform, texture);
+                m_encoder->setVertexBuffer(0, vbh);
+                m_encoder->setIndexBuffer(ibh);
+                m_encoder->submit(view_id, m_program);
+                ++m_lastDrawCalls;
+            }
+            else
+            {
+                core::GlobalLogger::getCoreLogger()->error("MeshBatchRenderer: Failed to create fallback buffers, {} sprites dropped.", sprites);
+            }
 
-            bgfx::setState(state);
+            // Destruction is deferred by bgfx until the frame that uses them has been rendered
+            if (bgfx::isValid(vbh)) bgfx::destroy(vbh);
+            if (bgfx::isValid(ibh)) bgfx::destroy(ibh);
+            m_fallbackVertices.clear();
+        };
+
+        // Expands each instance the same way vs_sprite_instanced does, array layers use their source texture
+        constexpr float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+        m_fallbackVertices.clear();
+        bgfx::TextureHandle runTexture = BGFX_INVALID_HANDLE;
+        for (uint32_t i = batch.startInstance + first; i < batch.startInstance + first + count; ++i)
+        {
+            const bgfx::TextureHandle texture = batch.kind == BatchKind::InstancedArray ? m_instanceSources[i] : batch.texture;
+            if (texture.idx != runTexture.idx || m_fallbackVertices.size() / 4 == MAX_RUN_SPRITES)
+            {
+                drawRun(runTexture);
+                runTexture = texture;
+            }
 
-            bgfx::setTexture(0, m_texColorUniform, batch.texture);
-            bgfx::setVertexBuffer(0, &tvb);
-            bgfx::setIndexBuffer(&tib, batch.startIndex, batch.numIndices);
+            const SpriteInstance& instance = m_instances[i];
+            uint32_t rgba = 0;
+            for (int c = 0; c < 4; ++c)
+            {
+                rgba |= static_cast<uint32_t>(glm::clamp(instance.color[c], 0.0f, 1.0f) * 255.0f + 0.5f) << (c * 8);
+            }
 
-            bgfx::submit(static_cast<bgfx::ViewId>(layer), m_program);
+            for (const auto& corner : corners)
+            {
+                PosTexColorVertex vertex;
+                vertex.x = instance.axis_x[0] * corner[0] + instance.axis_y[0] * corner[1] + instance.translation[0];
+                vertex.y = instance.axis_x[1] * corner[0] + instance.axis_y[1] * corner[1] + instance.translation[1];
+                vertex.z = instance.translation[2];
+                vertex.u = instance.uv_rect[0] + instance.uv_rect[2] * corner[0];
+                vertex.v = instance.uv_rect[1] + instance.uv_rect[3] * corner[1];
+                vertex.rgba = rgba;
+                m_fallbackVertices.push_back(vertex);
+            }
         }
+        drawRun(runTexture);
+    }
+
+    void MeshBatchRenderer::drawStaticBatch(bgfx::ViewId view_id, const BatchInfo& batch)
+    {
+        const StaticDraw& draw = m_staticDraws[batch.startInstance];
+
+        m_encoder->setTransform(glm::value_ptr(draw.transform));
+        m_encoder->setUniform(m_tintUniform, glm::value_ptr(draw.color));
+        m_encoder->setState(resolveState(batch.state));
+        m_encoder->setTexture(0, m_texColorUniform, batch.texture);
+        m_encoder->setVertexBuffer(0, draw.vbh);
+        m_encoder->setIndexBuffer(draw.ibh, 0, draw.numIndices);
+
+        m_encoder->submit(view_id, m_staticProgram);
+        ++m_lastDrawCalls;
     }
 
     void MeshBatchRenderer::endFrame(core::RenderLayer layer)
     {
-        flush(layer);
+        m_encoder = bgfx::begin();
+        flush(static_cast<bgfx::ViewId>(layer));
+        bgfx::end(m_encoder);
+        m_encoder = nullptr;
     }
 }
\ No newline at end of file
@@ -2,11 +2,23 @@
 
 #include <bgfx/bgfx.h>
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
 #include "Core/ViewID/ViewID.h"
+#include "Runtime/Renderer/DynamicAtlas/DynamicAtlas.h"
+#include "Runtime/Renderer/StaticMeshCache/StaticMeshCache.h"
+#include "Runtime/Renderer/TextureArrayPool/TextureArrayPool.h"
+
+namespace cyanvne::resources
+{
+    class TextureResource;
+}
 
 namespace cyanvne::runtime
 {
+    struct MeshComponent;
+    struct MaterialComponent;
+
     class MeshBatchRenderer
     {
     public:
@@ -21,6 +33,63 @@ namespace cyanvne::runtime
             static bgfx::VertexLayout ms_layout;
         };
 
+        // 16 bytes, positions are quantized against a per batch origin and step (u_compactOrigin in vs_sprite_compact.glsl)
+        struct CompactVertex
+        {
+            int16_t x, y, z, w;   // a_position (normalized), w pads as not every backend has 3 component int16 attributes
+            int16_t u, v;         // a_texcoord0 (normalized, [0, 1] only)
+            uint32_t rgba;        // a_color0 (normalized)
+
+            static void init();
+            static bgfx::VertexLayout ms_layout;
+        };
+
+        enum class VertexFormat
+        {
+            // PosTexColorVertex, 24 bytes
+            Full,
+            // CompactVertex where the geometry fits, Full batches otherwise
+            Compact
+        };
+
+        // Matches i_data0..i_data3 in vs_sprite_instanced.glsl
+        struct SpriteInstance
+        {
+            float axis_x[2];       // i_data0.xy
+            float axis_y[2];       // i_data0.zw
+            float translation[3];  // i_data1.xyz
+            float layer;           // i_data1.w, texture array layer
+            float uv_rect[4];      // i_data2
+            float color[4];        // i_data3
+        };
+        static_assert(sizeof(SpriteInstance) == 64, "SpriteInstance must match the instance data stride");
+
+        enum class SpritePath
+        {
+            // 4 vertices and 6 indices per sprite, generated on the CPU
+            Vertices,
+            // One static unit quad plus 64 bytes of instance data per sprite
+            Instanced
+        };
+
+        enum class SubmissionMode
+        {
+            // Batches follow submission order, a texture change always starts a new draw call
+            Immediate,
+            // Submissions are recorded with a sort key and merged into batches when flushed
+            Deferred
+        };
+
+        // Program slot encoded in sort keys
+        enum class SpriteProgram : uint8_t
+        {
+            Sprite = 0,
+            SpriteInstanced = 1,
+            SpriteInstancedArray = 2,
+            SpriteSdf = 3,
+            Count
+        };
+
         MeshBatchRenderer();
         ~MeshBatchRenderer();
 
@@ -30,7 +99,88 @@ namespace cyanvne::runtime
         // Initialize shader program and uniforms
         void init();
 
-        // Clears internal buffers for a new frame
+        // Packs small cached textures into shared pages, call after init()
+        void enableDynamicAtlas(const DynamicAtlas::Config& config = DynamicAtlas::Config());
+        DynamicAtlas* getDynamicAtlas() const
+        {
+            return m_atlas.get();
+        }
+
+        /**
+         * @brief Groups same-size cached textures into texture arrays, call after init().
+         * Only the instanced sprite path samples arrays, so this takes effect after
+         * setSpritePath(SpritePath::Instanced), and only on renderers whose embedded
+         * shaders support them (not OpenGL or OpenGL ES).
+         */
+        void enableTextureArrays(const TextureArrayPool::Config& config = TextureArrayPool::Config());
+        TextureArrayPool* getTextureArrayPool() const
+        {
+            return m_arrays.get();
+        }
+
+        // Keeps MeshComponents flagged is_static in GPU buffers, invalidated through the registry signals
+        void enableStaticMeshCache(entt::registry& registry);
+        // Lets several batchers, e.g. per worker ones, draw from one set of resident meshes
+        void shareStaticMeshCache(std::shared_ptr<StaticMeshCache> cache)
+        {
+            m_staticMeshes = std::move(cache);
+        }
+        const std::shared_ptr<StaticMeshCache>& getStaticMeshCache() const
+        {
+            return m_staticMeshes;
+        }
+
+        void setSubmissionMode(SubmissionMode mode)
+        {
+            m_mode = mode;
+        }
+        SubmissionMode getSubmissionMode() const
+        {
+            return m_mode;
+        }
+
+        /**
+         * @brief Selects the vertex layout for CPU generated batches.
+         * @param compact_step World units per quantization step of compact positions. Each compact batch
+         * covers +-32767 steps around its first vertex, geometry outside that range or with UVs outside
+         * [0, 1] starts a Full batch instead.
+         */
+        void setVertexFormat(VertexFormat format, float compact_step = 1.0f / 16.0f)
+        {
+            m_vertexFormat = format;
+            m_compactStep = compact_step > 0.0f ? compact_step : 1.0f / 16.0f;
+        }
+        VertexFormat getVertexFormat() const
+        {
+            return m_vertexFormat;
+        }
+
+        // Vertices by default. Instanced requests fall back to Vertices when the renderer lacks instancing,
+        // and sprites that no longer fit the frame's instance data buffer are drawn as vertices too
+        void setSpritePath(SpritePath path)
+        {
+            m_spritePath = path;
+        }
+        SpritePath getSpritePath() const
+        {
+            return m_spritePath;
+        }
+        bool isInstancingSupported() const
+        {
+            return m_instancingSupported;
+        }
+
+        /**
+         * @brief Blends alpha separately so the target ends up holding premultiplied color and correct coverage.
+         * Used when rendering into a transparent offscreen target that is composited later with
+         * submitFullscreenQuad(texture, true).
+         */
+        void setPremultipliedOutput(bool premultiplied)
+        {
+            m_premultipliedOutput = premultiplied;
+        }
+
+        // Clears internal buffers for a new frame, call once per frame before any begin()
         void beginFrame();
 
         /**
@@ -41,34 +191,236 @@ namespace cyanvne::runtime
          * @param size Sprite size (width, height)
          * @param uv_rect UV coordinates (x, y, w, h), default is full texture
          * @param color Tint color (Hex ABGR), default is white
+         * @param opaque Deferred mode only, draws without blending and sorts front-to-back. Ignored if color is translucent
+         * @param sort_layer Deferred mode only, lower layers are drawn first regardless of depth
          */
         void submitSprite(bgfx::TextureHandle texture,
                           const glm::vec3& pos,
                           const glm::vec2& size,
                           const glm::vec4& uv_rect = {0.0f, 0.0f, 1.0f, 1.0f},
-                          uint32_t color = 0xffffffff);
+                          uint32_t color = 0xffffffff,
+                          bool opaque = false,
+                          uint8_t sort_layer = 0);
+
+        /**
+         * @brief Submits a sprite backed by a cached texture.
+         * Small textures are redirected into the dynamic atlas when it is enabled, so consecutive
+         * sprites keep sharing a batch. Larger ones go to a texture array layer when arrays are
+         * enabled and the instanced path is active. Outside a begin()/end() pass the texture is
+         * bound directly, and repeating UV rects (outside [0, 1]) skip the atlas.
+         */
+        void submitSprite(const resources::TextureResource& texture,
+                          const glm::vec3& pos,
+                          const glm::vec2& size,
+                          const glm::vec4& uv_rect = {0.0f, 0.0f, 1.0f, 1.0f},
+                          uint32_t color = 0xffffffff,
+                          bool opaque = false,
+                          uint8_t sort_layer = 0);
+
+        /**
+         * @brief Submits a quad whose texture holds a signed distance field in its red channel, e.g. a glyph.
+         * The edge is reconstructed per pixel, so the quad can be scaled freely without blurring.
+         * Always blended, in deferred mode it sorts back-to-front with the other translucent submissions.
+         * @param color Fill color (Hex ABGR)
+         */
+        void submitSdfQuad(bgfx::TextureHandle texture,
+                           const glm::vec3& pos,
+                           const glm::vec2& size,
+                           const glm::vec4& uv_rect,
+                           uint32_t color = 0xffffffff,
+                           uint8_t sort_layer = 0);
+
+        /**
+         * @brief Covers the whole view with the texture, e.g. a cached layer render target.
+         * Positions are in clip space, so the view needs identity view and projection transforms.
+         * Bypasses deferred sorting and is drawn before the pass's deferred submissions.
+         * @param premultiplied Blends as premultiplied alpha, for targets rendered with setPremultipliedOutput()
+         */
+        void submitFullscreenQuad(bgfx::TextureHandle texture, bool premultiplied);
 
         // Flushes all batches to the GPU
         void endFrame(core::RenderLayer layer);
 
+        /**
+         * @brief Starts a per camera pass, used by the ECS RenderSystem.
+         * @param view_matrix Used by deferred mode to sort by view space depth.
+         * @param encoder Encoder the pass is recorded into, owned by the caller. When null the
+         * calling thread's encoder is taken from bgfx::begin() and returned in end().
+         */
+        void begin(bgfx::ViewId view_id, const glm::mat4& view_matrix = glm::mat4(1.0f), bgfx::Encoder* encoder = nullptr);
+        /**
+         * @param entity Required for static meshes, which are cached per entity. Tinted or atlased
+         * static meshes and submissions without an entity take the per-frame vertex path.
+         */
+        void submit(const glm::mat4& world_transform, const MeshComponent& mesh, const MaterialComponent& material,
+                    entt::entity entity = entt::null);
+        void end();
+
+        // Draw calls issued by the last flush
+        uint32_t getLastDrawCallCount() const
+        {
+            return m_lastDrawCalls;
+        }
+
     private:
-        void flush(core::RenderLayer layer);
+        enum class BatchKind : uint8_t
+        {
+            Vertices,
+            // CompactVertex geometry, startVertex indexes m_compactVertices
+            Compact,
+            Instanced,
+            // Instanced, sampling a texture array layer per instance
+            InstancedArray,
+            // One draw from StaticMeshCache buffers with its own transform
+            Static,
+            // Full vertices sampling a single channel distance field through fs_sprite_sdf
+            SdfText
+        };
 
-        bgfx::ProgramHandle m_program;
-        bgfx::UniformHandle m_texColorUniform;
+        struct StaticDraw
+        {
+            bgfx::VertexBufferHandle vbh;
+            bgfx::IndexBufferHandle ibh;
+            uint32_t numIndices;
+            glm::mat4 transform;
+            // Material color, applied by vs_sprite_static
+            glm::vec4 color;
+        };
 
         struct BatchInfo
         {
             bgfx::TextureHandle texture;
+            uint64_t state;
+            // Indices of a batch are relative to its first vertex, which becomes the base vertex at draw time
+            uint32_t startVertex;
+            uint32_t numVertices;
             uint32_t startIndex;
             uint32_t numIndices;
+            BatchKind kind;
+            // Instanced: range in m_instances, Static: index in m_staticDraws
+            uint32_t startInstance;
+            uint32_t numInstances;
+            // Compact: origin xyz and quantization step
+            glm::vec4 origin;
+        };
+
+        // A deferred submission, geometry lives in the staging arrays until the commands are sorted
+        struct DrawCommand
+        {
+            bgfx::TextureHandle texture;
+            bool translucent;
+            uint32_t firstVertex;
+            uint32_t vertexCount;
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            BatchKind kind;
+            // Index in m_stagedInstances or m_stagedStatic
+            uint32_t instance;
+        };
+
+        struct SortEntry
+        {
+            uint64_t key;
+            uint32_t command;
         };
 
+        void flush(bgfx::ViewId view_id);
+        uint64_t resolveState(uint64_t state) const;
+        size_t chunkEnd(size_t first_batch, bool transient) const;
+        // Returns the end of the batches actually drawn, short of last_batch when other encoders took the transient space
+        size_t submitBatches(bgfx::ViewId view_id, size_t first_batch, size_t last_batch, bool transient);
+        void copyIndices(void* dst, uint32_t first_index, uint32_t index_count) const;
+        void drawInstancedBatch(bgfx::ViewId view_id, const BatchInfo& batch);
+        void drawInstancesAsVertices(bgfx::ViewId view_id, const BatchInfo& batch, uint32_t first, uint32_t count);
+        void drawStaticBatch(bgfx::ViewId view_id, const BatchInfo& batch);
+        void prepareBatch(bgfx::TextureHandle texture, uint64_t state, uint32_t vertex_count, BatchKind kind = BatchKind::Vertices);
+        void appendInstance(bgfx::TextureHandle texture, uint64_t state, const SpriteInstance& instance,
+                            bgfx::TextureHandle source, BatchKind kind = BatchKind::Instanced);
+        void appendStatic(bgfx::TextureHandle texture, uint64_t state, const StaticDraw& draw);
+        void recordStatic(bgfx::TextureHandle texture, bool opaque, uint8_t sort_layer, const StaticDraw& draw);
+        void recordInstance(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                            const SpriteInstance& instance, bgfx::TextureHandle source, bool array_layer = false);
+        void appendGeometry(bgfx::TextureHandle texture, uint64_t state,
+                            const PosTexColorVertex* vertices, uint32_t vertex_count,
+                            const uint32_t* indices, uint32_t index_count, BatchKind kind = BatchKind::Vertices);
+        bool appendCompactGeometry(bgfx::TextureHandle texture, uint64_t state,
+                                   const PosTexColorVertex* vertices, uint32_t vertex_count,
+                                   const uint32_t* indices, uint32_t index_count);
+        void record(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                    const PosTexColorVertex* vertices, uint32_t vertex_count,
+                    const uint32_t* indices, uint32_t index_count, BatchKind kind = BatchKind::Vertices);
+        // Records a mesh above the batch vertex limit as several pieces, split on triangle boundaries
+        void recordSplit(bgfx::TextureHandle texture, const glm::vec3& anchor, bool opaque, uint8_t sort_layer,
+                         const PosTexColorVertex* vertices, uint32_t vertex_count,
+                         const uint32_t* indices, uint32_t index_count);
+        void resolveDeferred();
+        void clearPass();
+
+        // sequence is the submission index, it orders draws at equal depth
+        uint64_t makeSortKey(uint8_t sort_layer, bool translucent, SpriteProgram program,
+                             const glm::vec3& anchor, uint32_t sequence) const;
+
+        bgfx::ProgramHandle m_program;
+        bgfx::UniformHandle m_texColorUniform;
+
+        bgfx::ProgramHandle m_instancedProgram;
+        bgfx::VertexBufferHandle m_quadVbh;
+        bgfx::IndexBufferHandle m_quadIbh;
+        bool m_instancingSupported = false;
+        SpritePath m_spritePath = SpritePath::Vertices;
+        std::vector<SpriteInstance> m_instances;
+        std::vector<SpriteInstance> m_stagedInstances;
+        // 2D texture of each instance, array layers are drawn from it when instance data runs out
+        std::vector<bgfx::TextureHandle> m_instanceSources;
+        std::vector<bgfx::TextureHandle> m_stagedInstanceSources;
+        std::vector<PosTexColorVertex> m_fallbackVertices;
+
+        bgfx::ProgramHandle m_arrayProgram;
+        std::unique_ptr<TextureArrayPool> m_arrays;
+
+        std::shared_ptr<StaticMeshCache> m_staticMeshes;
+        std::vector<StaticDraw> m_staticDraws;
+        std::vector<StaticDraw> m_stagedStatic;
+
         std::vector<PosTexColorVertex> m_vertices;
-        std::vector<uint16_t> m_indices;
+        std::vector<uint32_t> m_indices;
+
+        bgfx::ProgramHandle m_compactProgram;
+        bgfx::UniformHandle m_compactOriginUniform;
+        VertexFormat m_vertexFormat = VertexFormat::Full;
+        bool m_premultipliedOutput = false;
+        float m_compactStep = 1.0f / 16.0f;
+        std::vector<CompactVertex> m_compactVertices;
+
+        bgfx::ProgramHandle m_sdfProgram;
+        bgfx::ProgramHandle m_staticProgram;
+        bgfx::UniformHandle m_tintUniform;
         std::vector<BatchInfo> m_batches;
 
-        // 16-bit index limit
-        static constexpr uint32_t MAX_VERTICES = 65536;
+        SubmissionMode m_mode = SubmissionMode::Immediate;
+        glm::mat4 m_viewMatrix = glm::mat4(1.0f);
+        std::vector<PosTexColorVertex> m_stagedVertices;
+        std::vector<uint32_t> m_stagedIndices;
+        std::vector<DrawCommand> m_commands;
+        std::vector<SortEntry> m_sortEntries;
+        std::vector<SortEntry> m_sortScratch;
+        std::vector<PosTexColorVertex> m_meshScratch;
+        std::vector<PosTexColorVertex> m_splitVertices;
+        std::vector<uint32_t> m_splitIndices;
+        std::vector<uint32_t> m_splitRemap;
+
+        std::unique_ptr<DynamicAtlas> m_atlas;
+        bgfx::ViewId m_viewId = 0;
+        bool m_inPass = false;
+        bgfx::Encoder* m_encoder = nullptr;
+        bool m_ownsEncoder = false;
+        uint32_t m_lastDrawCalls = 0;
+
+        // Per batch vertex limits, batches are small enough to pack several into one transient allocation
+        static constexpr uint32_t MAX_BATCH_VERTICES_16 = 65536;
+        static constexpr uint32_t MAX_BATCH_VERTICES_32 = 1u << 18;
+
+        bool m_index32 = false;
+        uint32_t m_maxBatchVertices = MAX_BATCH_VERTICES_16;
     };
 }
\ No newline at end of file
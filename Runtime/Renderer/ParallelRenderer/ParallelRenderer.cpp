@@ -0,0 +1,223 @@
+#include "ParallelRenderer.h"
+#include "Runtime/Components/Components.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+#include <future>
+#include <optional>
+#include <thread>
+
+namespace cyanvne::runtime
+{
+    ParallelRenderer::ParallelRenderer(Config config) : config_(config)
+    {  }
+
+    void ParallelRenderer::init()
+    {
+        uint32_t workers = config_.max_workers > 0 ? config_.max_workers : std::max(1u, std::thread::hardware_concurrency());
+
+        // The main thread keeps one encoder for itself
+        if (const bgfx::Caps* caps = bgfx::getCaps())
+        {
+            workers = std::min<uint32_t>(workers, std::max<uint32_t>(1, caps->limits.maxEncoders - 1));
+        }
+
+        batchers_.clear();
+        for (uint32_t i = 0; i < workers; ++i)
+        {
+            auto batcher = std::make_unique<MeshBatchRenderer>();
+            batcher->init();
+            batchers_.push_back(std::move(batcher));
+        }
+
+        core::GlobalLogger::getCoreLogger()->info("ParallelRenderer: Initialized with {} worker batchers.", workers);
+    }
+
+    void ParallelRenderer::enableStaticMeshCache(entt::registry& registry)
+    {
+        if (batchers_.empty())
+        {
+            core::GlobalLogger::getCoreLogger()->warn("ParallelRenderer: enableStaticMeshCache called before init(), ignored.");
+            return;
+        }
+
+        batchers_.front()->enableStaticMeshCache(registry);
+        for (size_t i = 1; i < batchers_.size(); ++i)
+        {
+            batchers_[i]->shareStaticMeshCache(batchers_.front()->getStaticMeshCache());
+        }
+    }
+
+    void ParallelRenderer::setSubmissionMode(MeshBatchRenderer::SubmissionMode mode)
+    {
+        for (auto& batcher : batchers_)
+        {
+            batcher->setSubmissionMode(mode);
+        }
+    }
+
+    void ParallelRenderer::setSpritePath(MeshBatchRenderer::SpritePath path)
+    {
+        for (auto& batcher : batchers_)
+        {
+            batcher->setSpritePath(path);
+        }
+    }
+
+    void ParallelRenderer::setVertexFormat(MeshBatchRenderer::VertexFormat format, float compact_step)
+    {
+        for (auto& batcher : batchers_)
+        {
+            batcher->setVertexFormat(format, compact_step);
+        }
+    }
+
+    uint32_t ParallelRenderer::recordGroup(MeshBatchRenderer& batcher, entt::registry& registry, const std::vector<Pass>& passes,
+                                           size_t first_task, size_t last_task, bgfx::Encoder* encoder)
+    {
+        // Workers only read components through the const registry, which never creates pools
+        const entt::registry& components = registry;
+
+        batcher.beginFrame();
+
+        uint32_t draw_calls = 0;
+        for (size_t t = first_task; t < last_task; ++t)
+        {
+            const Task& task = tasks_[t];
+            const Pass& pass = passes[task.pass];
+
+            batcher.setPremultipliedOutput(pass.premultiplied_output);
+            batcher.begin(pass.view_id, pass.view_matrix, encoder);
+            const std::vector<entt::entity>& entities = entity_lists_[task.list];
+            for (uint32_t i = task.first_entity; i < task.last_entity; ++i)
+            {
+                const entt::entity entity = entities[i];
+                const auto [world_transform, mesh, material] =
+                        components.try_get<WorldTransformComponent, MeshComponent, MaterialComponent>(entity);
+
+                if (world_transform == nullptr || mesh == nullptr || material == nullptr ||
+                    (pass.culling_mask & mesh->layer_mask) == 0)
+                {
+                    continue;
+                }
+
+                if (material->load_state == MaterialComponent::LoadState::Loaded)
+                {
+                    batcher.submit(world_transform->transform, *mesh, *material, entity);
+                }
+            }
+            batcher.end();
+            batcher.setPremultipliedOutput(false);
+
+            draw_calls += batcher.getLastDrawCallCount();
+        }
+        return draw_calls;
+    }
+
+    void ParallelRenderer::render(entt::registry& registry, const std::vector<Pass>& passes,
+                                  platform::concurrency::UnifiedConcurrencyManager& concurrency_manager,
+                                  SpatialIndex* spatial_index)
+    {
+        last_draw_calls_ = 0;
+        if (passes.empty() || batchers_.empty())
+        {
+            return;
+        }
+
+        // Lists are built on the main thread, the index is not safe to query from the workers
+        const size_t list_count = spatial_index != nullptr ? passes.size() : 1;
+        entity_lists_.resize(std::max(entity_lists_.size(), list_count));
+        for (size_t l = 0; l < list_count; ++l)
+        {
+            entity_lists_[l].clear();
+        }
+
+        if (spatial_index != nullptr)
+        {
+            for (size_t p = 0; p < passes.size(); ++p)
+            {
+                spatial_index->query(passes[p].view_rect, entity_lists_[p]);
+            }
+        }
+        else
+        {
+            // Led by the mesh storage, the order SpatialIndex::query() reproduces
+            for (auto entity : registry.view<MeshComponent>())
+            {
+                if (registry.all_of<WorldTransformComponent, MaterialComponent>(entity))
+                {
+                    entity_lists_[0].push_back(entity);
+                }
+            }
+        }
+
+        tasks_.clear();
+        for (uint32_t p = 0; p < passes.size(); ++p)
+        {
+            const uint32_t list = spatial_index != nullptr ? p : 0;
+            const uint32_t entity_count = static_cast<uint32_t>(entity_lists_[list].size());
+            const uint32_t chunk = config_.entities_per_task > 0 ? config_.entities_per_task : std::max(entity_count, 1u);
+
+            for (uint32_t first = 0; first < entity_count; first += chunk)
+            {
+                tasks_.push_back({ p, list, first, std::min(first + chunk, entity_count) });
+            }
+        }
+        if (tasks_.empty())
+        {
+            return;
+        }
+
+        const size_t groups = std::min(batchers_.size(), tasks_.size());
+        std::vector<std::future<std::optional<uint32_t>>> results;
+        results.reserve(groups);
+
+        for (size_t g = 0; g < groups; ++g)
+        {
+            const size_t first_task = tasks_.size() * g / groups;
+            const size_t last_task = tasks_.size() * (g + 1) / groups;
+
+            results.push_back(concurrency_manager.submit_worker(
+                    [this, &registry, &passes, g, first_task, last_task]() -> std::optional<uint32_t>
+                    {
+                        bgfx::Encoder* encoder = bgfx::begin(true);
+                        if (encoder == nullptr)
+                        {
+                            return std::nullopt;
+                        }
+
+                        const uint32_t draw_calls = recordGroup(*batchers_[g], registry, passes, first_task, last_task, encoder);
+                        bgfx::end(encoder);
+                        return draw_calls;
+                    }));
+        }
+
+        // Every encoder has to be ended before bgfx::frame(), so wait for all groups
+        for (size_t g = 0; g < groups; ++g)
+        {
+            if (const std::optional<uint32_t> draw_calls = results[g].get())
+            {
+                last_draw_calls_ += *draw_calls;
+                continue;
+            }
+
+            core::GlobalLogger::getCoreLogger()->warn("ParallelRenderer: No encoder available for worker group {}, recorded on the main thread.", g);
+            last_draw_calls_ += recordGroup(*batchers_[g], registry, passes,
+                                            tasks_.size() * g / groups, tasks_.size() * (g + 1) / groups, nullptr);
+        }
+    }
+
+    void ParallelRenderer::composite(bgfx::ViewId view_id, bgfx::TextureHandle texture)
+    {
+        if (batchers_.empty())
+        {
+            return;
+        }
+
+        // Every worker encoder has ended, so the first batcher is free to record on the main thread's encoder
+        MeshBatchRenderer& batcher = *batchers_.front();
+        batcher.begin(view_id);
+        batcher.submitFullscreenQuad(texture, true);
+        batcher.end();
+        last_draw_calls_ += batcher.getLastDrawCallCount();
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Runtime/Renderer/MeshBatchRenderer/MeshBatchRenderer.h"
+#include "Runtime/SpatialIndex/SpatialIndex.h"
+#include "Platform/Thread/UnifiedConcurrencyManager.h"
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Records camera passes on UnifiedConcurrencyManager workers, each through its own batcher and bgfx::Encoder.
+     * View setup (rects, transforms, clears) stays on the main thread, only draw submission is distributed.
+     * Passes are split into tasks by camera and optionally by entity chunk, the tasks are then divided
+     * into contiguous groups, one per worker, so the chunks of a camera stay in order inside a group.
+     * Worker batchers do not use a DynamicAtlas or a TextureArrayPool, both record blits through the main thread
+     * API and are not thread safe. Every distinct texture therefore breaks a batch, and the same scene usually
+     * takes more draw calls here than through a serial MeshBatchRenderer with those enabled.
+     */
+    class ParallelRenderer
+    {
+    public:
+        struct Config
+        {
+            // 0 picks hardware_concurrency, always capped by the bgfx encoder limit
+            uint32_t max_workers = 0;
+            // 0 keeps each camera in one task. Smaller chunks balance better but lose submission order
+            // between chunks, so only split cameras whose content is opaque or depth tested
+            uint32_t entities_per_task = 0;
+        };
+
+        struct Pass
+        {
+            bgfx::ViewId view_id;
+            glm::mat4 view_matrix;
+            uint32_t culling_mask;
+            // World space min x, min y, max x, max y, used to query the SpatialIndex
+            glm::vec4 view_rect;
+            // Viewport size in pixels
+            uint16_t width;
+            uint16_t height;
+            // Set for LayerCache targets, see MeshBatchRenderer::setPremultipliedOutput()
+            bool premultiplied_output = false;
+        };
+
+    private:
+        struct Task
+        {
+            uint32_t pass;
+            uint32_t list;
+            uint32_t first_entity;
+            uint32_t last_entity;
+        };
+
+        Config config_;
+        std::vector<std::unique_ptr<MeshBatchRenderer>> batchers_;
+        // One list per pass with a SpatialIndex, a single shared list without
+        std::vector<std::vector<entt::entity>> entity_lists_;
+        std::vector<Task> tasks_;
+        uint32_t last_draw_calls_ = 0;
+
+        uint32_t recordGroup(MeshBatchRenderer& batcher, entt::registry& registry, const std::vector<Pass>& passes,
+                             size_t first_task, size_t last_task, bgfx::Encoder* encoder);
+
+    public:
+        explicit ParallelRenderer(Config config = Config());
+        ~ParallelRenderer() = default;
+
+        ParallelRenderer(const ParallelRenderer&) = delete;
+        ParallelRenderer& operator=(const ParallelRenderer&) = delete;
+        ParallelRenderer(ParallelRenderer&&) = delete;
+        ParallelRenderer& operator=(ParallelRenderer&&) = delete;
+
+        // Creates the per worker batchers, call after bgfx::init()
+        void init();
+
+        void enableStaticMeshCache(entt::registry& registry);
+        void setSubmissionMode(MeshBatchRenderer::SubmissionMode mode);
+        void setSpritePath(MeshBatchRenderer::SpritePath path);
+        void setVertexFormat(MeshBatchRenderer::VertexFormat format, float compact_step = 1.0f / 16.0f);
+
+        /**
+         * @brief Records all passes and returns once every worker has ended its encoder.
+         * Must be called from the main thread, before bgfx::frame(). Groups that cannot get an
+         * encoder are recorded on the main thread instead.
+         * @param spatial_index When set, each pass only visits the entities intersecting its view_rect.
+         */
+        void render(entt::registry& registry, const std::vector<Pass>& passes,
+                    platform::concurrency::UnifiedConcurrencyManager& concurrency_manager,
+                    SpatialIndex* spatial_index = nullptr);
+
+        // Draws a premultiplied layer target over view_id on the main thread, call after render() has returned
+        void composite(bgfx::ViewId view_id, bgfx::TextureHandle texture);
+
+        size_t getWorkerCount() const
+        {
+            return batchers_.size();
+        }
+
+        uint32_t getLastDrawCallCount() const
+        {
+            return last_draw_calls_;
+        }
+    };
+}
@@ -0,0 +1,424 @@
+#include "SdfTextRenderer.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace cyanvne::runtime
+{
+    namespace
+    {
+        uint64_t glyph_key(platform::FontManager::FontId font, uint32_t codepoint)
+        {
+            return static_cast<uint64_t>(font) << 32 | codepoint;
+        }
+
+        // Decodes one code point and advances offset, malformed sequences yield U+FFFD and skip one byte
+        uint32_t decode_utf8(std::string_view text, size_t& offset)
+        {
+            constexpr uint32_t REPLACEMENT = 0xfffd;
+            const auto lead = static_cast<uint8_t>(text[offset]);
+
+            uint32_t length;
+            uint32_t codepoint;
+            if (lead < 0x80)
+            {
+                ++offset;
+                return lead;
+            }
+            if ((lead & 0xe0) == 0xc0)
+            {
+                length = 2;
+                codepoint = lead & 0x1f;
+            }
+            else if ((lead & 0xf0) == 0xe0)
+            {
+                length = 3;
+                codepoint = lead & 0x0f;
+            }
+            else if ((lead & 0xf8) == 0xf0)
+            {
+                length = 4;
+                codepoint = lead & 0x07;
+            }
+            else
+            {
+                ++offset;
+                return REPLACEMENT;
+            }
+
+            if (offset + length > text.size())
+            {
+                ++offset;
+                return REPLACEMENT;
+            }
+            for (uint32_t i = 1; i < length; ++i)
+            {
+                const auto continuation = static_cast<uint8_t>(text[offset + i]);
+                if ((continuation & 0xc0) != 0x80)
+                {
+                    ++offset;
+                    return REPLACEMENT;
+                }
+                codepoint = codepoint << 6 | (continuation & 0x3f);
+            }
+
+            offset += length;
+            return codepoint;
+        }
+    }
+
+    SdfTextRenderer::SdfTextRenderer(platform::FontManager& fonts, Config config) : fonts_(fonts), config_(config)
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        supported_ = caps != nullptr && (caps->formats[bgfx::TextureFormat::R8] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0;
+
+        if (caps != nullptr)
+        {
+            config_.page_size = static_cast<uint16_t>(std::min<uint32_t>(config_.page_size, caps->limits.maxTextureSize));
+        }
+
+        if (!supported_)
+        {
+            core::GlobalLogger::getCoreLogger()->warn("SdfTextRenderer: R8 textures are not supported, text will only be measured.");
+        }
+    }
+
+    SdfTextRenderer::~SdfTextRenderer()
+    {
+        for (auto& page : pages_)
+        {
+            if (bgfx::isValid(page.texture))
+            {
+                bgfx::destroy(page.texture);
+            }
+        }
+    }
+
+    void SdfTextRenderer::beginFrame()
+    {
+        ++frame_;
+    }
+
+    const SdfTextRenderer::Glyph* SdfTextRenderer::acquire(platform::FontManager::FontId font, uint32_t codepoint)
+    {
+        const uint64_t key = glyph_key(font, codepoint);
+        if (auto it = glyphs_.find(key); it != glyphs_.end())
+        {
+            if (it->second.page != NO_PAGE)
+            {
+                pages_[it->second.page].last_used_frame = frame_;
+            }
+            return &it->second;
+        }
+
+        if (rejected_.contains(key))
+        {
+            return nullptr;
+        }
+
+        const std::optional<platform::FontManager::GlyphBitmap> bitmap = fonts_.rasterizeGlyph(font, codepoint);
+        if (!bitmap)
+        {
+            rejected_.insert(key);
+            return nullptr;
+        }
+
+        std::optional<Glyph> glyph = insert(*bitmap);
+        if (!glyph)
+        {
+            // Not rejected, the pages may have room again in a later frame
+            return nullptr;
+        }
+
+        if (glyph->page != NO_PAGE)
+        {
+            pages_[glyph->page].keys.push_back(key);
+        }
+        return &glyphs_.emplace(key, *glyph).first->second;
+    }
+
+    const platform::FontManager::GlyphMetrics* SdfTextRenderer::measure(platform::FontManager::FontId font, uint32_t codepoint)
+    {
+        const uint64_t key = glyph_key(font, codepoint);
+        auto it = metrics_.find(key);
+        if (it == metrics_.end())
+        {
+            it = metrics_.emplace(key, fonts_.getGlyphMetrics(font, codepoint)).first;
+        }
+        return it->second ? &*it->second : nullptr;
+    }
+
+    std::optional<SdfTextRenderer::Glyph> SdfTextRenderer::insert(const platform::FontManager::GlyphBitmap& bitmap)
+    {
+        Glyph glyph{};
+        glyph.page = NO_PAGE;
+        glyph.offset_x = bitmap.offset_x;
+        glyph.offset_y = bitmap.offset_y;
+        glyph.width = static_cast<float>(bitmap.width);
+        glyph.height = static_cast<float>(bitmap.height);
+        glyph.advance = bitmap.advance;
+
+        // Blank glyphs only advance the pen
+        if (bitmap.width == 0 || bitmap.height == 0 || !supported_)
+        {
+            return glyph;
+        }
+
+        const uint32_t padding = config_.padding;
+        const uint32_t slot_width = bitmap.width + 2u * padding;
+        const uint32_t slot_height = bitmap.height + 2u * padding;
+        if (slot_width > config_.page_size || slot_height > config_.page_size)
+        {
+            core::GlobalLogger::getCoreLogger()->warn("SdfTextRenderer: Glyph U+{:04X} does not fit a {} px page.",
+                                                      bitmap.codepoint, config_.page_size);
+            return std::nullopt;
+        }
+
+        std::optional<platform::algorithm::rectpacking::PackedRect> rect;
+        std::optional<uint16_t> page_index;
+
+        for (uint16_t i = 0; i < pages_.size() && !rect; ++i)
+        {
+            rect = pages_[i].packer.insert(slot_width, slot_height);
+            if (rect)
+            {
+                page_index = i;
+            }
+        }
+
+        if (!rect)
+        {
+            if (pages_.size() < config_.max_pages)
+            {
+                Page& page = pages_.emplace_back(config_.page_size);
+                page.texture = bgfx::createTexture2D(config_.page_size, config_.page_size, false, 1,
+                                                     bgfx::TextureFormat::R8,
+                                                     BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+                if (!bgfx::isValid(page.texture))
+                {
+                    pages_.pop_back();
+                    core::GlobalLogger::getCoreLogger()->warn("SdfTextRenderer: Failed to create glyph page.");
+                    return std::nullopt;
+                }
+                page_index = static_cast<uint16_t>(pages_.size() - 1);
+            }
+            else
+            {
+                page_index = evictLeastRecentlyUsedPage();
+                if (!page_index)
+                {
+                    // Every page is in use this frame
+                    return std::nullopt;
+                }
+            }
+            rect = pages_[*page_index].packer.insert(slot_width, slot_height);
+            if (!rect)
+            {
+                return std::nullopt;
+            }
+        }
+
+        // The padding is uploaded too, evicted pages still hold the texels of their old glyphs
+        upload_scratch_.assign(static_cast<size_t>(slot_width) * slot_height, 0);
+        for (uint32_t y = 0; y < bitmap.height; ++y)
+        {
+            std::memcpy(upload_scratch_.data() + (y + padding) * slot_width + padding,
+                        bitmap.pixels.data() + static_cast<size_t>(y) * bitmap.width, bitmap.width);
+        }
+
+        Page& page = pages_[*page_index];
+        bgfx::updateTexture2D(page.texture, 0, 0,
+                              static_cast<uint16_t>(rect->x), static_cast<uint16_t>(rect->y),
+                              static_cast<uint16_t>(slot_width), static_cast<uint16_t>(slot_height),
+                              bgfx::copy(upload_scratch_.data(), static_cast<uint32_t>(upload_scratch_.size())),
+                              static_cast<uint16_t>(slot_width));
+        page.last_used_frame = frame_;
+
+        const float inv_size = 1.0f / static_cast<float>(config_.page_size);
+        glyph.page = *page_index;
+        glyph.uv_rect = glm::vec4(static_cast<float>(rect->x + padding) * inv_size,
+                                  static_cast<float>(rect->y + padding) * inv_size,
+                                  glyph.width * inv_size,
+                                  glyph.height * inv_size);
+        return glyph;
+    }
+
+    std::optional<uint16_t> SdfTextRenderer::evictLeastRecentlyUsedPage()
+    {
+        std::optional<uint16_t> victim;
+        for (uint16_t i = 0; i < pages_.size(); ++i)
+        {
+            if (pages_[i].last_used_frame >= frame_)
+            {
+                continue;
+            }
+            if (!victim || pages_[i].last_used_frame < pages_[*victim].last_used_frame)
+            {
+                victim = i;
+            }
+        }
+
+        if (!victim)
+        {
+            return std::nullopt;
+        }
+
+        Page& page = pages_[*victim];
+        for (uint64_t key : page.keys)
+        {
+            glyphs_.erase(key);
+        }
+        page.keys.clear();
+        page.packer.reset();
+        return victim;
+    }
+
+    void SdfTextRenderer::forgetFont(platform::FontManager::FontId font)
+    {
+        const auto of_font = [font](uint64_t key)
+        {
+            return static_cast<platform::FontManager::FontId>(key >> 32) == font;
+        };
+
+        std::erase_if(glyphs_, [&](const auto& entry) { return of_font(entry.first); });
+        std::erase_if(rejected_, of_font);
+        std::erase_if(metrics_, [&](const auto& entry) { return of_font(entry.first); });
+        // The atlas space stays allocated until the page is evicted
+        for (auto& page : pages_)
+        {
+            std::erase_if(page.keys, of_font);
+        }
+    }
+
+    float SdfTextRenderer::getLineAdvance(platform::FontManager::FontId font, const TextStyle& style) const
+    {
+        const std::optional<platform::FontManager::FontMetrics> metrics = fonts_.getMetrics(font);
+        if (!metrics)
+        {
+            return 0.0f;
+        }
+        return metrics->line_height * style.size / fonts_.getRasterSize() * style.line_spacing;
+    }
+
+    void SdfTextRenderer::layoutText(platform::FontManager::FontId font, std::string_view utf8, const TextStyle& style,
+                                     TextLayout& out)
+    {
+        out.font = font;
+        out.scale = 0.0f;
+        out.glyphs.clear();
+        out.character_count = 0;
+        out.line_count = 0;
+        out.extent = glm::vec2(0.0f);
+
+        const std::optional<platform::FontManager::FontMetrics> metrics = fonts_.getMetrics(font);
+        if (!metrics || utf8.empty())
+        {
+            return;
+        }
+
+        const float scale = style.size / fonts_.getRasterSize();
+        out.scale = scale;
+        const float line_advance = metrics->line_height * scale * style.line_spacing;
+
+        float pen_x = 0.0f;
+        float baseline = metrics->ascent * scale;
+        float widest = 0.0f;
+        uint32_t lines = 1;
+        uint32_t previous = 0;
+        uint32_t character = 0;
+
+        size_t offset = 0;
+        while (offset < utf8.size())
+        {
+            const uint32_t codepoint = decode_utf8(utf8, offset);
+            const uint32_t index = character++;
+            if (codepoint == '\r')
+            {
+                continue;
+            }
+            if (codepoint == '\n')
+            {
+                widest = std::max(widest, pen_x);
+                pen_x = 0.0f;
+                baseline += line_advance;
+                ++lines;
+                previous = 0;
+                continue;
+            }
+
+            const platform::FontManager::GlyphMetrics* glyph = measure(font, codepoint);
+            if (glyph == nullptr)
+            {
+                previous = 0;
+                continue;
+            }
+
+            if (previous != 0)
+            {
+                pen_x += fonts_.getKerning(font, previous, codepoint) * scale;
+            }
+
+            const float advance = glyph->advance * scale;
+            if (style.max_width > 0.0f && pen_x > 0.0f && pen_x + advance > style.max_width)
+            {
+                widest = std::max(widest, pen_x);
+                pen_x = 0.0f;
+                baseline += line_advance;
+                ++lines;
+            }
+
+            if (glyph->width > 0.0f && glyph->height > 0.0f)
+            {
+                out.glyphs.push_back({ codepoint, index, glm::vec2(pen_x, baseline) });
+            }
+
+            pen_x += advance;
+            previous = codepoint;
+        }
+
+        out.character_count = character;
+        out.line_count = lines;
+        out.extent = glm::vec2(std::max(widest, pen_x), static_cast<float>(lines) * line_advance);
+    }
+
+    void SdfTextRenderer::drawLayout(MeshBatchRenderer& renderer, const TextLayout& layout, const glm::vec3& pos,
+                                     uint32_t color, uint8_t sort_layer, uint32_t visible_characters)
+    {
+        for (const LaidOutGlyph& laid_out : layout.glyphs)
+        {
+            // Glyphs are stored in string order
+            if (laid_out.character >= visible_characters)
+            {
+                break;
+            }
+
+            // A hash lookup, unless the glyph is new or its page was evicted since it was last drawn
+            const Glyph* glyph = acquire(layout.font, laid_out.codepoint);
+            if (glyph == nullptr || glyph->page == NO_PAGE)
+            {
+                continue;
+            }
+
+            // The box of the rasterized field, the layout's metrics only decided the pen positions
+            renderer.submitSdfQuad(pages_[glyph->page].texture,
+                                   glm::vec3(pos.x + laid_out.pen.x + glyph->offset_x * layout.scale,
+                                             pos.y + laid_out.pen.y + glyph->offset_y * layout.scale, pos.z),
+                                   glm::vec2(glyph->width, glyph->height) * layout.scale,
+                                   glyph->uv_rect, color, sort_layer);
+        }
+    }
+
+    glm::vec2 SdfTextRenderer::drawText(MeshBatchRenderer& renderer, platform::FontManager::FontId font, std::string_view utf8,
+                                        const glm::vec3& pos, const TextStyle& style)
+    {
+        layoutText(font, utf8, style, scratch_layout_);
+        drawLayout(renderer, scratch_layout_, pos, style.color, style.sort_layer);
+        return scratch_layout_.extent;
+    }
+
+    glm::vec2 SdfTextRenderer::measureText(platform::FontManager::FontId font, std::string_view utf8, const TextStyle& style)
+    {
+        layoutText(font, utf8, style, scratch_layout_);
+        return scratch_layout_.extent;
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Platform/Algorithm/RectPacking/RectPacking.h"
+#include "Platform/FontManager/FontManager.h"
+#include "Runtime/Renderer/MeshBatchRenderer/MeshBatchRenderer.h"
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Draws UTF-8 text as signed distance field glyph quads through MeshBatchRenderer.
+     * Glyphs are rasterized on first use by FontManager and packed into R8 atlas pages. A glyph is
+     * rasterized once per font and drawn at any size, kerning and metrics are scaled from the raster size.
+     * Pages are evicted whole in LRU order once the page limit is reached, pages used in the current
+     * frame are never evicted.
+     * Text is laid out with y growing downwards, matching submitSprite's top left origin.
+     */
+    class SdfTextRenderer
+    {
+    public:
+        struct Config
+        {
+            uint16_t page_size = 1024;
+            uint16_t max_pages = 4;
+            // Empty texels around each glyph, the field is 0 there so filtering never picks up a neighbour
+            uint16_t padding = 1;
+        };
+
+        struct TextStyle
+        {
+            // Line height in world units is size * the font's line height / raster size
+            float size = 32.0f;
+            uint32_t color = 0xffffffff;
+            float line_spacing = 1.0f;
+            // Breaks lines between characters once they exceed this width, 0 disables wrapping
+            float max_width = 0.0f;
+            uint8_t sort_layer = 0;
+        };
+
+        struct LaidOutGlyph
+        {
+            uint32_t codepoint;
+            // Index of the code point in the source string, drawLayout reveals glyphs below a character count
+            uint32_t character;
+            // Pen position on the baseline relative to the text origin, in world units
+            glm::vec2 pen;
+        };
+
+        /**
+         * @brief Shaped and line broken text, independent of where and how far it is drawn.
+         * Built from FontManager metrics alone, so it does not depend on what the atlas holds.
+         */
+        struct TextLayout
+        {
+            platform::FontManager::FontId font = platform::FontManager::INVALID_FONT;
+            // World units per raster pixel
+            float scale = 0.0f;
+            // Visible glyphs only, blank glyphs and line breaks take no entry
+            std::vector<LaidOutGlyph> glyphs;
+            // Code points in the source string
+            uint32_t character_count = 0;
+            uint32_t line_count = 0;
+            glm::vec2 extent = glm::vec2(0.0f);
+        };
+
+    private:
+        static constexpr uint16_t NO_PAGE = 0xffff;
+
+        // Metrics are in raster pixels
+        struct Glyph
+        {
+            uint16_t page;
+            glm::vec4 uv_rect;
+            float offset_x;
+            float offset_y;
+            float width;
+            float height;
+            float advance;
+        };
+
+        struct Page
+        {
+            bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+            platform::algorithm::rectpacking::SkylinePacker packer;
+            uint64_t last_used_frame = 0;
+            std::vector<uint64_t> keys;
+
+            explicit Page(uint16_t size) : packer(size, size)
+            {  }
+        };
+
+        platform::FontManager& fonts_;
+        Config config_;
+        std::vector<Page> pages_;
+        std::unordered_map<uint64_t, Glyph> glyphs_;
+        std::unordered_set<uint64_t> rejected_;
+        // Layout metrics per glyph, nullopt for glyphs the font cannot measure
+        std::unordered_map<uint64_t, std::optional<platform::FontManager::GlyphMetrics>> metrics_;
+        std::vector<uint8_t> upload_scratch_;
+        TextLayout scratch_layout_;
+        uint64_t frame_ = 1;
+        bool supported_ = false;
+
+        const Glyph* acquire(platform::FontManager::FontId font, uint32_t codepoint);
+        const platform::FontManager::GlyphMetrics* measure(platform::FontManager::FontId font, uint32_t codepoint);
+        std::optional<Glyph> insert(const platform::FontManager::GlyphBitmap& bitmap);
+        std::optional<uint16_t> evictLeastRecentlyUsedPage();
+
+    public:
+        // The font manager must outlive the renderer
+        explicit SdfTextRenderer(platform::FontManager& fonts, Config config = Config());
+        ~SdfTextRenderer();
+
+        SdfTextRenderer(const SdfTextRenderer&) = delete;
+        SdfTextRenderer& operator=(const SdfTextRenderer&) = delete;
+        SdfTextRenderer(SdfTextRenderer&&) = delete;
+        SdfTextRenderer& operator=(SdfTextRenderer&&) = delete;
+
+        // Pages touched in the current frame are never evicted
+        void beginFrame();
+
+        /**
+         * @brief Shapes and line breaks text from the font metrics, the atlas is only filled by drawLayout().
+         * Only size, line_spacing and max_width of the style affect the result.
+         * @param out Overwritten, its storage is reused.
+         */
+        void layoutText(platform::FontManager::FontId font, std::string_view utf8, const TextStyle& style, TextLayout& out);
+
+        /**
+         * @brief Submits a laid out text, one quad per visible glyph, rasterizing glyphs that are not in the atlas yet.
+         * A glyph that finds no room this frame is skipped for the frame, the layout itself stays correct.
+         * @param pos Top left corner of the first line.
+         * @param visible_characters Only glyphs of the first visible_characters code points are drawn.
+         */
+        void drawLayout(MeshBatchRenderer& renderer, const TextLayout& layout, const glm::vec3& pos,
+                        uint32_t color = 0xffffffff, uint8_t sort_layer = 0,
+                        uint32_t visible_characters = std::numeric_limits<uint32_t>::max());
+
+        /**
+         * @brief Lays out and submits text in one go, for text that changes every frame.
+         * Repeated text is better served by a TextLayoutCache and drawLayout().
+         * @param pos Top left corner of the first line.
+         * @return Width and height of the laid out text.
+         */
+        glm::vec2 drawText(MeshBatchRenderer& renderer, platform::FontManager::FontId font, std::string_view utf8,
+                           const glm::vec3& pos, const TextStyle& style = TextStyle());
+
+        // Same layout as drawText without submitting or rasterizing
+        glm::vec2 measureText(platform::FontManager::FontId font, std::string_view utf8, const TextStyle& style = TextStyle());
+
+        // Distance between two baselines for the style, 0 for unknown fonts
+        float getLineAdvance(platform::FontManager::FontId font, const TextStyle& style) const;
+
+        // Drops every glyph of a font, call before unloading it from the FontManager
+        void forgetFont(platform::FontManager::FontId font);
+
+        bool isSupported() const
+        {
+            return supported_;
+        }
+        size_t getPageCount() const
+        {
+            return pages_.size();
+        }
+        size_t getGlyphCount() const
+        {
+            return glyphs_.size();
+        }
+    };
+}
@@ -0,0 +1,229 @@
+#include "StaticMeshCache.h"
+#include "Runtime/Components/Components.h"
+#include "Core/Logger/Logger.h"
+#include "Core/Hash/Fnv1a.h"
+#include <algorithm>
+#include <cstring>
+
+namespace cyanvne::runtime
+{
+    StaticMeshCache::StaticMeshCache()
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        index32_ = caps != nullptr && (caps->supported & BGFX_CAPS_INDEX32) != 0;
+    }
+
+    StaticMeshCache::~StaticMeshCache()
+    {
+        disconnect();
+        clear();
+    }
+
+    void StaticMeshCache::connect(entt::registry& registry)
+    {
+        disconnect();
+
+        registry_ = &registry;
+        registry_->on_update<MeshComponent>().connect<&StaticMeshCache::onMeshChanged>(*this);
+        registry_->on_destroy<MeshComponent>().connect<&StaticMeshCache::onMeshChanged>(*this);
+    }
+
+    void StaticMeshCache::disconnect()
+    {
+        if (registry_ == nullptr)
+        {
+            return;
+        }
+
+        registry_->on_update<MeshComponent>().disconnect<&StaticMeshCache::onMeshChanged>(*this);
+        registry_->on_destroy<MeshComponent>().disconnect<&StaticMeshCache::onMeshChanged>(*this);
+        registry_ = nullptr;
+
+        // Bindings can no longer be invalidated, the next acquire() hashes the content again
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!bindings_.empty())
+        {
+            releaseLocked(bindings_.begin()->first);
+        }
+    }
+
+    void StaticMeshCache::onMeshChanged(entt::registry& registry, entt::entity entity)
+    {
+        release(entity);
+    }
+
+    uint64_t StaticMeshCache::hashContent(const MeshComponent& mesh)
+    {
+        const uint64_t counts[2] = { mesh.vertices.size(), mesh.indices.size() };
+
+        uint64_t hash = core::fnv1a(core::FNV1A_OFFSET_BASIS, counts, sizeof(counts));
+        hash = core::fnv1a(hash, mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshBatchRenderer::PosTexColorVertex));
+        hash = core::fnv1a(hash, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+        return hash;
+    }
+
+    bool StaticMeshCache::sameContent(const Entry& entry, const MeshComponent& mesh)
+    {
+        const size_t vertex_bytes = mesh.vertices.size() * sizeof(MeshBatchRenderer::PosTexColorVertex);
+        return entry.vertex_bytes.size() == vertex_bytes &&
+               entry.indices.size() == mesh.indices.size() &&
+               std::memcmp(entry.vertex_bytes.data(), mesh.vertices.data(), vertex_bytes) == 0 &&
+               std::equal(entry.indices.begin(), entry.indices.end(), mesh.indices.begin());
+    }
+
+    bool StaticMeshCache::upload(const MeshComponent& mesh, Entry& entry) const
+    {
+        const uint32_t max_index = *std::max_element(mesh.indices.begin(), mesh.indices.end());
+        if (max_index >= mesh.vertices.size())
+        {
+            core::GlobalLogger::getCoreLogger()->error("StaticMeshCache: Index {} out of range for {} vertices.",
+                                                       max_index, mesh.vertices.size());
+            return false;
+        }
+
+        // 16-bit indices whenever they fit, they are half the size and supported everywhere
+        const bool wide = max_index > 0xffff;
+        if (wide && !index32_)
+        {
+            core::GlobalLogger::getCoreLogger()->warn("StaticMeshCache: Mesh with {} vertices needs 32-bit indices, which are not supported.",
+                                                      mesh.vertices.size());
+            return false;
+        }
+
+        const uint32_t vertex_bytes = static_cast<uint32_t>(mesh.vertices.size() * sizeof(MeshBatchRenderer::PosTexColorVertex));
+        const bgfx::Memory* vertex_mem = bgfx::copy(mesh.vertices.data(), vertex_bytes);
+
+        const bgfx::Memory* index_mem = nullptr;
+        if (wide)
+        {
+            index_mem = bgfx::copy(mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size() * sizeof(uint32_t)));
+        }
+        else
+        {
+            index_mem = bgfx::alloc(static_cast<uint32_t>(mesh.indices.size() * sizeof(uint16_t)));
+            auto* out = reinterpret_cast<uint16_t*>(index_mem->data);
+            for (size_t i = 0; i < mesh.indices.size(); ++i)
+            {
+                out[i] = static_cast<uint16_t>(mesh.indices[i]);
+            }
+        }
+
+        entry.mesh.vbh = bgfx::createVertexBuffer(vertex_mem, MeshBatchRenderer::PosTexColorVertex::ms_layout);
+        entry.mesh.ibh = bgfx::createIndexBuffer(index_mem, wide ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
+        entry.mesh.num_indices = static_cast<uint32_t>(mesh.indices.size());
+        entry.bytes = vertex_bytes + index_mem->size;
+
+        const auto* vertex_data = reinterpret_cast<const uint8_t*>(mesh.vertices.data());
+        entry.vertex_bytes.assign(vertex_data, vertex_data + vertex_bytes);
+        entry.indices = mesh.indices;
+
+        if (!bgfx::isValid(entry.mesh.vbh) || !bgfx::isValid(entry.mesh.ibh))
+        {
+            if (bgfx::isValid(entry.mesh.vbh)) bgfx::destroy(entry.mesh.vbh);
+            if (bgfx::isValid(entry.mesh.ibh)) bgfx::destroy(entry.mesh.ibh);
+            core::GlobalLogger::getCoreLogger()->error("StaticMeshCache: Failed to create buffers for a mesh with {} vertices.",
+                                                       mesh.vertices.size());
+            return false;
+        }
+
+        return true;
+    }
+
+    std::optional<StaticMeshCache::Mesh> StaticMeshCache::acquire(entt::entity entity, const MeshComponent& mesh)
+    {
+        if (entity == entt::null || mesh.vertices.empty() || mesh.indices.empty())
+        {
+            return std::nullopt;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto binding = bindings_.find(entity); binding != bindings_.end())
+        {
+            return entries_.at(binding->second).mesh;
+        }
+
+        const uint64_t hash = hashContent(mesh);
+        auto it = entries_.end();
+        const auto [first, last] = ids_by_hash_.equal_range(hash);
+        for (auto candidate = first; candidate != last; ++candidate)
+        {
+            auto entry = entries_.find(candidate->second);
+            if (entry != entries_.end() && sameContent(entry->second, mesh))
+            {
+                it = entry;
+                break;
+            }
+        }
+
+        if (it == entries_.end())
+        {
+            Entry entry;
+            if (!upload(mesh, entry))
+            {
+                return std::nullopt;
+            }
+
+            entry.hash = hash;
+            resident_bytes_ += entry.bytes;
+            const uint64_t id = next_id_++;
+            it = entries_.emplace(id, std::move(entry)).first;
+            ids_by_hash_.emplace(hash, id);
+        }
+
+        ++it->second.ref_count;
+        bindings_.emplace(entity, it->first);
+        return it->second.mesh;
+    }
+
+    void StaticMeshCache::release(entt::entity entity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        releaseLocked(entity);
+    }
+
+    void StaticMeshCache::releaseLocked(entt::entity entity)
+    {
+        auto binding = bindings_.find(entity);
+        if (binding == bindings_.end())
+        {
+            return;
+        }
+
+        auto it = entries_.find(binding->second);
+        bindings_.erase(binding);
+        if (it == entries_.end() || --it->second.ref_count > 0)
+        {
+            return;
+        }
+
+        // Destruction is deferred by bgfx until frames already submitted with the buffers are done
+        bgfx::destroy(it->second.mesh.vbh);
+        bgfx::destroy(it->second.mesh.ibh);
+        resident_bytes_ -= it->second.bytes;
+
+        const auto [first, last] = ids_by_hash_.equal_range(it->second.hash);
+        for (auto candidate = first; candidate != last; ++candidate)
+        {
+            if (candidate->second == it->first)
+            {
+                ids_by_hash_.erase(candidate);
+                break;
+            }
+        }
+        entries_.erase(it);
+    }
+
+    void StaticMeshCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [key, entry] : entries_)
+        {
+            bgfx::destroy(entry.mesh.vbh);
+            bgfx::destroy(entry.mesh.ibh);
+        }
+        entries_.clear();
+        ids_by_hash_.clear();
+        bindings_.clear();
+        resident_bytes_ = 0;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace cyanvne::runtime
+{
+    struct MeshComponent;
+
+    /**
+     * @brief Keeps MeshComponents flagged is_static resident in GPU buffers.
+     * Buffers are looked up by a hash of the geometry, so entities sharing a mesh share one upload.
+     * A hash hit is only shared after the sizes and bytes match a CPU copy kept with the buffers.
+     * An entity's binding is dropped when its MeshComponent is patched, replaced or removed through
+     * the registry it is connected to, the next acquire() then uploads the new content.
+     * acquire() and release() may be called from several render workers at once.
+     */
+    class StaticMeshCache
+    {
+    public:
+        struct Mesh
+        {
+            bgfx::VertexBufferHandle vbh = BGFX_INVALID_HANDLE;
+            bgfx::IndexBufferHandle ibh = BGFX_INVALID_HANDLE;
+            uint32_t num_indices = 0;
+        };
+
+    private:
+        struct Entry
+        {
+            Mesh mesh;
+            uint32_t ref_count = 0;
+            size_t bytes = 0;
+            uint64_t hash = 0;
+            // Compared on hash hits, so colliding meshes never share buffers
+            std::vector<uint8_t> vertex_bytes;
+            std::vector<uint32_t> indices;
+        };
+
+        entt::registry* registry_ = nullptr;
+        // Keyed by entry id, several entries may share a content hash
+        std::unordered_map<uint64_t, Entry> entries_;
+        std::unordered_multimap<uint64_t, uint64_t> ids_by_hash_;
+        std::unordered_map<entt::entity, uint64_t> bindings_;
+        uint64_t next_id_ = 0;
+        size_t resident_bytes_ = 0;
+        bool index32_ = false;
+        mutable std::mutex mutex_;
+
+        void onMeshChanged(entt::registry& registry, entt::entity entity);
+        void releaseLocked(entt::entity entity);
+        static uint64_t hashContent(const MeshComponent& mesh);
+        static bool sameContent(const Entry& entry, const MeshComponent& mesh);
+        bool upload(const MeshComponent& mesh, Entry& entry) const;
+
+    public:
+        StaticMeshCache();
+        ~StaticMeshCache();
+
+        StaticMeshCache(const StaticMeshCache&) = delete;
+        StaticMeshCache& operator=(const StaticMeshCache&) = delete;
+        StaticMeshCache(StaticMeshCache&&) = delete;
+        StaticMeshCache& operator=(StaticMeshCache&&) = delete;
+
+        // Drops resident buffers when a MeshComponent is patched or destroyed, disconnect before the registry goes away
+        void connect(entt::registry& registry);
+        void disconnect();
+
+        // Uploads on first use, nullopt when the geometry cannot be made resident
+        std::optional<Mesh> acquire(entt::entity entity, const MeshComponent& mesh);
+        void release(entt::entity entity);
+        void clear();
+
+        size_t getMeshCount() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+        size_t getResidentBytes() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return resident_bytes_;
+        }
+    };
+}
@@ -0,0 +1,107 @@
+#include "TextLayoutCache.h"
+#include <algorithm>
+#include <functional>
+
+namespace cyanvne::runtime
+{
+    size_t TextLayoutCache::KeyHash::operator()(const KeyView& key) const
+    {
+        size_t hash = std::hash<std::string_view>{}(key.text);
+        const auto combine = [&hash](size_t value)
+        {
+            hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        };
+        combine(std::hash<uint32_t>{}(key.font));
+        combine(std::hash<float>{}(key.size));
+        combine(std::hash<float>{}(key.line_spacing));
+        combine(std::hash<float>{}(key.max_width));
+        return hash;
+    }
+
+    TextLayoutCache::TextLayoutCache(SdfTextRenderer& text_renderer, Config config)
+        : text_renderer_(text_renderer), config_(config)
+    {  }
+
+    void TextLayoutCache::beginFrame()
+    {
+        ++frame_;
+        trim();
+    }
+
+    const SdfTextRenderer::TextLayout* TextLayoutCache::find(platform::FontManager::FontId font, std::string_view utf8,
+                                                             const SdfTextRenderer::TextStyle& style)
+    {
+        auto it = index_.find(KeyView{ utf8, font, style.size, style.line_spacing, style.max_width });
+        if (it == index_.end())
+        {
+            return nullptr;
+        }
+
+        entries_.splice(entries_.begin(), entries_, it->second);
+        it->second->last_used_frame = frame_;
+        return &it->second->layout;
+    }
+
+    const SdfTextRenderer::TextLayout& TextLayoutCache::get(platform::FontManager::FontId font, std::string_view utf8,
+                                                            const SdfTextRenderer::TextStyle& style)
+    {
+        if (const SdfTextRenderer::TextLayout* layout = find(font, utf8, style))
+        {
+            ++hits_;
+            return *layout;
+        }
+
+        ++misses_;
+        Entry& entry = entries_.emplace_front();
+        entry.key = Key{ std::string(utf8), font, style.size, style.line_spacing, style.max_width };
+        entry.last_used_frame = frame_;
+        text_renderer_.layoutText(font, utf8, style, entry.layout);
+        index_.emplace(entry.key, entries_.begin());
+
+        trim();
+        return entry.layout;
+    }
+
+    float TextLayoutCache::estimateHeight(platform::FontManager::FontId font, std::string_view utf8,
+                                          const SdfTextRenderer::TextStyle& style)
+    {
+        auto it = index_.find(KeyView{ utf8, font, style.size, style.line_spacing, style.max_width });
+        if (it != index_.end())
+        {
+            return it->second->layout.extent.y;
+        }
+
+        // Wrapped lines are unknown until the text is shaped
+        const auto lines = static_cast<float>(std::count(utf8.begin(), utf8.end(), '\n') + 1);
+        return lines * text_renderer_.getLineAdvance(font, style);
+    }
+
+    void TextLayoutCache::trim()
+    {
+        while (entries_.size() > config_.max_layouts && entries_.back().last_used_frame < frame_)
+        {
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+        }
+    }
+
+    void TextLayoutCache::clear()
+    {
+        index_.clear();
+        entries_.clear();
+    }
+
+    void TextLayoutCache::forgetFont(platform::FontManager::FontId font)
+    {
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (it->key.font != font)
+            {
+                ++it;
+                continue;
+            }
+            index_.erase(it->key);
+            it = entries_.erase(it);
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Runtime/Renderer/SdfTextRenderer/SdfTextRenderer.h"
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Keeps shaped and line broken text so it is laid out once instead of every frame.
+     * Layouts are keyed by string, font, size, line spacing and wrap width, color and sort layer are
+     * picked at draw time. A typewriter reveal draws the same layout with a growing character count.
+     * Least recently used layouts are dropped beyond max_layouts, layouts returned in the current frame
+     * are kept even if that briefly exceeds the limit.
+     */
+    class TextLayoutCache
+    {
+    public:
+        struct Config
+        {
+            size_t max_layouts = 512;
+        };
+
+    private:
+        struct Key
+        {
+            std::string text;
+            platform::FontManager::FontId font;
+            float size;
+            float line_spacing;
+            float max_width;
+        };
+
+        struct KeyView
+        {
+            std::string_view text;
+            platform::FontManager::FontId font;
+            float size;
+            float line_spacing;
+            float max_width;
+        };
+
+        struct KeyHash
+        {
+            using is_transparent = void;
+            size_t operator()(const KeyView& key) const;
+            size_t operator()(const Key& key) const
+            {
+                return (*this)(KeyView{ key.text, key.font, key.size, key.line_spacing, key.max_width });
+            }
+        };
+
+        struct KeyEqual
+        {
+            using is_transparent = void;
+            static KeyView view(const Key& key)
+            {
+                return { key.text, key.font, key.size, key.line_spacing, key.max_width };
+            }
+            static const KeyView& view(const KeyView& key)
+            {
+                return key;
+            }
+            template <typename A, typename B>
+            bool operator()(const A& a, const B& b) const
+            {
+                const KeyView& lhs = view(a);
+                const KeyView& rhs = view(b);
+                return lhs.text == rhs.text && lhs.font == rhs.font && lhs.size == rhs.size &&
+                       lhs.line_spacing == rhs.line_spacing && lhs.max_width == rhs.max_width;
+            }
+        };
+
+        struct Entry
+        {
+            Key key;
+            SdfTextRenderer::TextLayout layout;
+            uint64_t last_used_frame = 0;
+        };
+
+        SdfTextRenderer& text_renderer_;
+        Config config_;
+        // Front is the most recently used, nodes never move so returned layouts stay put
+        std::list<Entry> entries_;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash, KeyEqual> index_;
+        uint64_t frame_ = 1;
+        uint64_t hits_ = 0;
+        uint64_t misses_ = 0;
+
+        void trim();
+
+    public:
+        // The text renderer must outlive the cache
+        explicit TextLayoutCache(SdfTextRenderer& text_renderer, Config config = Config());
+        ~TextLayoutCache() = default;
+
+        TextLayoutCache(const TextLayoutCache&) = delete;
+        TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+        TextLayoutCache(TextLayoutCache&&) = delete;
+        TextLayoutCache& operator=(TextLayoutCache&&) = delete;
+
+        // Layouts returned before this call may be dropped by later lookups
+        void beginFrame();
+
+        /**
+         * @brief Returns the layout of the text, shaping it on a miss.
+         * The reference stays valid until the end of the frame, or until clear() or forgetFont().
+         */
+        const SdfTextRenderer::TextLayout& get(platform::FontManager::FontId font, std::string_view utf8,
+                                               const SdfTextRenderer::TextStyle& style);
+
+        // The cached layout, or nullptr without shaping anything
+        const SdfTextRenderer::TextLayout* find(platform::FontManager::FontId font, std::string_view utf8,
+                                                const SdfTextRenderer::TextStyle& style);
+
+        /**
+         * @brief Height of the text, exact when it is cached and estimated from its explicit line breaks otherwise.
+         * Lets long lists such as a backlog place every entry while only calling get() for the ones in view.
+         */
+        float estimateHeight(platform::FontManager::FontId font, std::string_view utf8,
+                             const SdfTextRenderer::TextStyle& style);
+
+        void clear();
+        void forgetFont(platform::FontManager::FontId font);
+
+        size_t size() const
+        {
+            return entries_.size();
+        }
+        uint64_t getHitCount() const
+        {
+            return hits_;
+        }
+        uint64_t getMissCount() const
+        {
+            return misses_;
+        }
+    };
+}
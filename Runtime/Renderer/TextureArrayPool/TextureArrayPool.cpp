@@ -0,0 +1,257 @@
+#include "TextureArrayPool.h"
+#include "Resources/ResourceTypes/ResourceTypes.h"
+#include "Core/Logger/Logger.h"
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    TextureArrayPool::TextureArrayPool(Config config) : config_(config)
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        supported_ = caps != nullptr &&
+                     (caps->supported & BGFX_CAPS_TEXTURE_2D_ARRAY) != 0 &&
+                     (caps->supported & BGFX_CAPS_TEXTURE_BLIT) != 0;
+
+        if (caps != nullptr)
+        {
+            config_.layers_per_array = static_cast<uint16_t>(std::min<uint32_t>(config_.layers_per_array, caps->limits.maxTextureLayers));
+        }
+        config_.layers_per_array = std::max<uint16_t>(config_.layers_per_array, 1);
+
+        if (!supported_)
+        {
+            core::GlobalLogger::getCoreLogger()->info("TextureArrayPool: Texture arrays or blits are not supported, sprites will not use arrays.");
+            return;
+        }
+
+        destroy_listener_ = resources::TextureResource::addDestroyListener([this](uint64_t unique_id)
+        {
+            std::lock_guard<std::mutex> lock(destroyed_mutex_);
+            destroyed_.push_back(unique_id);
+        });
+    }
+
+    TextureArrayPool::~TextureArrayPool()
+    {
+        if (destroy_listener_ != 0)
+        {
+            resources::TextureResource::removeDestroyListener(destroy_listener_);
+        }
+
+        for (auto& array : arrays_)
+        {
+            if (bgfx::isValid(array.texture))
+            {
+                bgfx::destroy(array.texture);
+            }
+        }
+    }
+
+    void TextureArrayPool::beginFrame()
+    {
+        ++frame_;
+        pruneDestroyed();
+    }
+
+    void TextureArrayPool::pruneDestroyed()
+    {
+        std::vector<uint64_t> destroyed;
+        {
+            std::lock_guard<std::mutex> lock(destroyed_mutex_);
+            destroyed.swap(destroyed_);
+        }
+
+        for (uint64_t key : destroyed)
+        {
+            rejected_.erase(key);
+
+            auto it = entries_.find(key);
+            if (it == entries_.end())
+            {
+                continue;
+            }
+
+            Array& array = arrays_[it->second.array];
+            std::erase(array.keys, key);
+            array.free_layers.push_back(it->second.layer);
+            entries_.erase(it);
+
+            // An emptied array hands out its layers from the start again
+            if (array.keys.empty())
+            {
+                array.used_layers = 0;
+                array.free_layers.clear();
+            }
+        }
+    }
+
+    bool TextureArrayPool::hasFreeLayer(const Array& array) const
+    {
+        return !array.free_layers.empty() || array.used_layers < config_.layers_per_array;
+    }
+
+    uint64_t TextureArrayPool::groupKey(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format)
+    {
+        return static_cast<uint64_t>(width) << 32 | static_cast<uint64_t>(height) << 16 | static_cast<uint64_t>(format);
+    }
+
+    bool TextureArrayPool::isEligible(const resources::TextureResource& texture) const
+    {
+        // Blits cannot convert or scale, every layer of an array has the source's exact size and format
+        const bgfx::Caps* caps = bgfx::getCaps();
+        return texture.getNumLayers() == 1 &&
+               texture.getWidth() >= config_.min_size &&
+               texture.getHeight() >= config_.min_size &&
+               caps != nullptr &&
+               (caps->formats[texture.getFormat()] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0;
+    }
+
+    std::optional<TextureArrayPool::Slot> TextureArrayPool::acquire(const resources::TextureResource& texture)
+    {
+        if (!supported_)
+        {
+            return std::nullopt;
+        }
+
+        const uint64_t key = texture.getUniqueId();
+        if (auto it = entries_.find(key); it != entries_.end())
+        {
+            Array& array = arrays_[it->second.array];
+            array.last_used_frame = frame_;
+            return Slot{ array.texture, it->second.layer };
+        }
+
+        if (!texture.isUploaded())
+        {
+            return std::nullopt;
+        }
+        if (rejected_.contains(key) || !isEligible(texture))
+        {
+            rejected_.insert(key);
+            return std::nullopt;
+        }
+
+        std::optional<Entry> entry = insert(texture);
+        if (!entry)
+        {
+            return std::nullopt;
+        }
+        return Slot{ arrays_[entry->array].texture, entry->layer };
+    }
+
+    bool TextureArrayPool::createArray(Array& array, const resources::TextureResource& texture)
+    {
+        array.texture = bgfx::createTexture2D(texture.getWidth(), texture.getHeight(), false, config_.layers_per_array,
+                                              texture.getFormat(), BGFX_TEXTURE_BLIT_DST | BGFX_SAMPLER_NONE);
+        if (!bgfx::isValid(array.texture))
+        {
+            core::GlobalLogger::getCoreLogger()->warn("TextureArrayPool: Failed to create a {}x{} texture array.",
+                                                      texture.getWidth(), texture.getHeight());
+            return false;
+        }
+
+        array.group = groupKey(texture.getWidth(), texture.getHeight(), texture.getFormat());
+        array.used_layers = 0;
+        array.keys.clear();
+        array.free_layers.clear();
+        return true;
+    }
+
+    std::optional<TextureArrayPool::Entry> TextureArrayPool::insert(const resources::TextureResource& texture)
+    {
+        const uint64_t group = groupKey(texture.getWidth(), texture.getHeight(), texture.getFormat());
+
+        std::optional<uint16_t> array_index;
+        for (uint16_t i = 0; i < arrays_.size(); ++i)
+        {
+            if (arrays_[i].group == group && hasFreeLayer(arrays_[i]))
+            {
+                array_index = i;
+                break;
+            }
+        }
+
+        if (!array_index)
+        {
+            if (arrays_.size() < config_.max_arrays)
+            {
+                Array& array = arrays_.emplace_back();
+                if (!createArray(array, texture))
+                {
+                    arrays_.pop_back();
+                    return std::nullopt;
+                }
+                array_index = static_cast<uint16_t>(arrays_.size() - 1);
+            }
+            else
+            {
+                array_index = evictLeastRecentlyUsedArray();
+                if (!array_index || !createArray(arrays_[*array_index], texture))
+                {
+                    // Every array is in use this frame
+                    return std::nullopt;
+                }
+            }
+        }
+
+        Array& array = arrays_[*array_index];
+        uint16_t layer = 0;
+        if (!array.free_layers.empty())
+        {
+            layer = array.free_layers.back();
+            array.free_layers.pop_back();
+        }
+        else
+        {
+            layer = array.used_layers++;
+        }
+
+        bgfx::blit(config_.blit_view, array.texture, 0, 0, 0, layer, texture.texture_handle, 0, 0, 0, 0,
+                   texture.getWidth(), texture.getHeight(), 1);
+
+        const Entry entry{ *array_index, layer };
+        const uint64_t key = texture.getUniqueId();
+        entries_.emplace(key, entry);
+        array.keys.push_back(key);
+        array.last_used_frame = frame_;
+        return entry;
+    }
+
+    std::optional<uint16_t> TextureArrayPool::evictLeastRecentlyUsedArray()
+    {
+        std::optional<uint16_t> victim;
+        for (uint16_t i = 0; i < arrays_.size(); ++i)
+        {
+            if (arrays_[i].last_used_frame >= frame_)
+            {
+                continue;
+            }
+            if (!victim || arrays_[i].last_used_frame < arrays_[*victim].last_used_frame)
+            {
+                victim = i;
+            }
+        }
+
+        if (!victim)
+        {
+            return std::nullopt;
+        }
+
+        // The replacement may have another size, so the texture is recreated rather than reused
+        Array& array = arrays_[*victim];
+        for (uint64_t key : array.keys)
+        {
+            entries_.erase(key);
+        }
+        array.keys.clear();
+        array.free_layers.clear();
+        if (bgfx::isValid(array.texture))
+        {
+            bgfx::destroy(array.texture);
+        }
+        array.texture = BGFX_INVALID_HANDLE;
+        array.group = 0;
+        array.used_layers = 0;
+        return victim;
+    }
+}
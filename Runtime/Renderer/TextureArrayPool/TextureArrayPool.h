@@ -0,0 +1,118 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cyanvne::resources
+{
+    class TextureResource;
+}
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Groups same-size, same-format cached textures into 2D texture arrays.
+     * Sprites whose textures share an array only differ by layer, so they can share a batch.
+     * Unlike the DynamicAtlas there is no packing or padding, a texture always fills a whole layer,
+     * which suits large layered artwork such as character body, face and expression sets.
+     * Arrays are evicted whole in LRU order once the array limit is reached. Layers of destroyed textures are
+     * freed at the next beginFrame() and reused by later textures of the same size and format.
+     */
+    class TextureArrayPool
+    {
+    public:
+        struct Config
+        {
+            // Clamped to the renderer's maxTextureLayers
+            uint16_t layers_per_array = 16;
+            uint16_t max_arrays = 8;
+            // Smaller textures are left to the atlas or bound directly
+            uint16_t min_size = 128;
+            // New layers are copied in this view's blit pass. It must run before every view that samples
+            // the arrays, otherwise a view drawn earlier in the frame reads the layer before the copy
+            bgfx::ViewId blit_view = 0;
+        };
+
+        struct Slot
+        {
+            bgfx::TextureHandle texture;
+            uint16_t layer;
+        };
+
+    private:
+        struct Array
+        {
+            bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+            uint64_t group = 0;
+            uint16_t used_layers = 0;
+            uint64_t last_used_frame = 0;
+            std::vector<uint64_t> keys;
+            // Layers below used_layers whose texture was destroyed
+            std::vector<uint16_t> free_layers;
+        };
+
+        struct Entry
+        {
+            uint16_t array;
+            uint16_t layer;
+        };
+
+        Config config_;
+        std::vector<Array> arrays_;
+        std::unordered_map<uint64_t, Entry> entries_;
+        std::unordered_set<uint64_t> rejected_;
+        uint64_t frame_ = 1;
+        bool supported_ = false;
+
+        // Filled by the texture destroy listener, which may run on any thread
+        std::mutex destroyed_mutex_;
+        std::vector<uint64_t> destroyed_;
+        uint64_t destroy_listener_ = 0;
+
+        static uint64_t groupKey(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format);
+        // Only checks permanent properties, textures still uploading are retried later
+        bool isEligible(const resources::TextureResource& texture) const;
+        void pruneDestroyed();
+        bool hasFreeLayer(const Array& array) const;
+        std::optional<Entry> insert(const resources::TextureResource& texture);
+        std::optional<uint16_t> evictLeastRecentlyUsedArray();
+        bool createArray(Array& array, const resources::TextureResource& texture);
+
+    public:
+        explicit TextureArrayPool(Config config = Config());
+        ~TextureArrayPool();
+
+        TextureArrayPool(const TextureArrayPool&) = delete;
+        TextureArrayPool& operator=(const TextureArrayPool&) = delete;
+        TextureArrayPool(TextureArrayPool&&) = delete;
+        TextureArrayPool& operator=(TextureArrayPool&&) = delete;
+
+        // Arrays touched in the current frame are never evicted, layers of destroyed textures are freed here
+        void beginFrame();
+
+        /**
+         * @brief Looks up or copies a texture into a layer, the copy goes through Config::blit_view.
+         * @param texture An uploaded texture, one that is still loading is retried on later calls.
+         * @return The array and layer to sample, or nullopt if the texture should be bound directly.
+         */
+        std::optional<Slot> acquire(const resources::TextureResource& texture);
+
+        bool isSupported() const
+        {
+            return supported_;
+        }
+        size_t getArrayCount() const
+        {
+            return arrays_.size();
+        }
+        size_t getEntryCount() const
+        {
+            return entries_.size();
+        }
+    };
+}
@@ -0,0 +1,147 @@
+#include "SpatialIndex.h"
+#include "Runtime/Components/Components.h"
+#include <bgfx/bgfx.h>
+#include <algorithm>
+#include <limits>
+
+namespace cyanvne::runtime
+{
+    SpatialIndex::SpatialIndex(float cell_size) : grid_(cell_size)
+    {  }
+
+    SpatialIndex::~SpatialIndex()
+    {
+        disconnect();
+    }
+
+    void SpatialIndex::connect(entt::registry& registry)
+    {
+        disconnect();
+
+        registry_ = &registry;
+        registry_->on_destroy<MeshComponent>().connect<&SpatialIndex::onRemoved>(*this);
+        registry_->on_destroy<WorldTransformComponent>().connect<&SpatialIndex::onRemoved>(*this);
+    }
+
+    void SpatialIndex::disconnect()
+    {
+        if (registry_ == nullptr)
+        {
+            return;
+        }
+
+        registry_->on_destroy<MeshComponent>().disconnect<&SpatialIndex::onRemoved>(*this);
+        registry_->on_destroy<WorldTransformComponent>().disconnect<&SpatialIndex::onRemoved>(*this);
+        registry_ = nullptr;
+        grid_.clear();
+    }
+
+    void SpatialIndex::onRemoved(entt::registry& registry, entt::entity entity)
+    {
+        remove(entity);
+    }
+
+    void SpatialIndex::update(entt::entity entity, const glm::mat4& world_transform, const MeshComponent& mesh)
+    {
+        if (mesh.vertices.empty())
+        {
+            remove(entity);
+            return;
+        }
+
+        glm::vec2 local_min(std::numeric_limits<float>::max());
+        glm::vec2 local_max(std::numeric_limits<float>::lowest());
+        for (const auto& vertex : mesh.vertices)
+        {
+            local_min = glm::min(local_min, glm::vec2(vertex.x, vertex.y));
+            local_max = glm::max(local_max, glm::vec2(vertex.x, vertex.y));
+        }
+
+        // Box around the transformed local box, conservative under rotation
+        const glm::vec2 corners[4] = {
+                { local_min.x, local_min.y }, { local_max.x, local_min.y },
+                { local_max.x, local_max.y }, { local_min.x, local_max.y }
+        };
+        glm::vec2 world_min(std::numeric_limits<float>::max());
+        glm::vec2 world_max(std::numeric_limits<float>::lowest());
+        for (const auto& corner : corners)
+        {
+            const glm::vec2 world = glm::vec2(world_transform * glm::vec4(corner, 0.0f, 1.0f));
+            world_min = glm::min(world_min, world);
+            world_max = glm::max(world_max, world);
+        }
+
+        grid_.update(entt::to_integral(entity), { world_min.x, world_min.y, world_max.x, world_max.y });
+    }
+
+    void SpatialIndex::remove(entt::entity entity)
+    {
+        grid_.remove(entt::to_integral(entity));
+    }
+
+    void SpatialIndex::clear()
+    {
+        grid_.clear();
+    }
+
+    void SpatialIndex::query(const glm::vec4& rect, std::vector<entt::entity>& out)
+    {
+        scratch_.clear();
+        grid_.query({ rect.x, rect.y, rect.z, rect.w }, scratch_);
+
+        out.reserve(out.size() + scratch_.size());
+        if (registry_ == nullptr)
+        {
+            for (uint64_t id : scratch_)
+            {
+                out.push_back(static_cast<entt::entity>(static_cast<entt::id_type>(id)));
+            }
+            return;
+        }
+
+        // Position in the iteration of the mesh storage, entities without a mesh go last
+        const entt::sparse_set& meshes = registry_->storage<MeshComponent>();
+        order_scratch_.clear();
+        for (uint64_t id : scratch_)
+        {
+            const auto entity = static_cast<entt::entity>(static_cast<entt::id_type>(id));
+            const auto position = meshes.find(entity);
+            order_scratch_.emplace_back(position != meshes.end() ? static_cast<size_t>(position - meshes.begin()) : meshes.size(), entity);
+        }
+        std::sort(order_scratch_.begin(), order_scratch_.end());
+
+        for (const auto& [position, entity] : order_scratch_)
+        {
+            out.push_back(entity);
+        }
+    }
+
+    glm::vec4 SpatialIndex::computeViewRect(const glm::mat4& view_matrix, const glm::mat4& projection_matrix)
+    {
+        const bgfx::Caps* caps = bgfx::getCaps();
+        const float near_z = caps != nullptr && caps->homogeneousDepth ? -1.0f : 0.0f;
+        const glm::mat4 inverse_view_projection = glm::inverse(projection_matrix * view_matrix);
+
+        glm::vec2 world_min(std::numeric_limits<float>::max());
+        glm::vec2 world_max(std::numeric_limits<float>::lowest());
+        for (float z : { near_z, 1.0f })
+        {
+            for (float y : { -1.0f, 1.0f })
+            {
+                for (float x : { -1.0f, 1.0f })
+                {
+                    const glm::vec4 world = inverse_view_projection * glm::vec4(x, y, z, 1.0f);
+                    if (world.w <= std::numeric_limits<float>::epsilon())
+                    {
+                        // Degenerate projection, cull nothing
+                        return { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                                 std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+                    }
+                    world_min = glm::min(world_min, glm::vec2(world) / world.w);
+                    world_max = glm::max(world_max, glm::vec2(world) / world.w);
+                }
+            }
+        }
+        return { world_min.x, world_min.y, world_max.x, world_max.y };
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+#include "Platform/Algorithm/SpatialGrid/SpatialGrid.h"
+
+namespace cyanvne::runtime
+{
+    struct MeshComponent;
+
+    /**
+     * @brief World space 2D bounds of renderable entities, used by the render systems to skip off-screen meshes.
+     * Filled by TransformSystem and queried per camera. Entities drop out when their MeshComponent or
+     * WorldTransformComponent is removed from the connected registry.
+     */
+    class SpatialIndex
+    {
+    private:
+        platform::algorithm::spatialgrid::UniformGrid grid_;
+        entt::registry* registry_ = nullptr;
+        std::vector<uint64_t> scratch_;
+        std::vector<std::pair<size_t, entt::entity>> order_scratch_;
+
+        void onRemoved(entt::registry& registry, entt::entity entity);
+
+    public:
+        explicit SpatialIndex(float cell_size = 512.0f);
+        ~SpatialIndex();
+
+        SpatialIndex(const SpatialIndex&) = delete;
+        SpatialIndex& operator=(const SpatialIndex&) = delete;
+        SpatialIndex(SpatialIndex&&) = delete;
+        SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+        // Forgets entities whose mesh or world transform is destroyed, disconnect before the registry is destroyed
+        void connect(entt::registry& registry);
+        void disconnect();
+
+        // Recomputes the entity's bounds from its mesh and world transform
+        void update(entt::entity entity, const glm::mat4& world_transform, const MeshComponent& mesh);
+        void remove(entt::entity entity);
+        void clear();
+
+        /**
+         * @brief Appends the entities intersecting the rect.
+         * While connected they come in MeshComponent storage order, the order the render systems walk
+         * without an index, so culling never changes painter's order. Otherwise in ascending entity order.
+         * @param rect World space min x, min y, max x, max y
+         */
+        void query(const glm::vec4& rect, std::vector<entt::entity>& out);
+
+        // World space xy bounds of what the camera sees, as min x, min y, max x, max y
+        static glm::vec4 computeViewRect(const glm::mat4& view_matrix, const glm::mat4& projection_matrix);
+
+        size_t size() const
+        {
+            return grid_.size();
+        }
+    };
+}
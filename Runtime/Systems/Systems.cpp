@@ -3,6 +3,7 @@
 #include "Platform/Thread/UnifiedConcurrencyManager.h"
 #include "Core/Logger/Logger.h"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 
 namespace cyanvne::ecs::systems
 {
@@ -13,12 +14,229 @@ namespace cyanvne::ecs::systems
             entt::entity target_entity;
             std::string resource_alias;
             bool is_pinned;
+            bool is_streamed;
             std::optional<resources::PinnedResourceHandle> data_handle;
             std::optional<resources::ResourceHandle<resources::TextureResource>> resource_handle;
+            std::optional<resources::ResourceHandle<resources::StreamingTextureResource>> streaming_handle;
             std::exception_ptr exception;
         };
         using TextureLoadResultPtr = std::shared_ptr<TextureLoadResult>;
 
+        struct RegistryLifetime
+        {
+            entt::registry *registry;
+        };
+        using RegistryToken = std::shared_ptr<RegistryLifetime>;
+
+        // Deferred jobs hold the weak side, the token lives in the registry context and expires with the registry
+        std::weak_ptr<RegistryLifetime> registry_lifetime(entt::registry &registry)
+        {
+            if (const RegistryToken *token = registry.ctx().find<RegistryToken>())
+            {
+                return *token;
+            }
+            return registry.ctx().emplace<RegistryToken>(std::make_shared<RegistryLifetime>(RegistryLifetime{ &registry }));
+        }
+
+        // Configures the camera's view on the main thread, nullopt when the camera has neither a live target window nor an offscreen size
+        std::optional<runtime::ParallelRenderer::Pass> setup_camera_view(const runtime::CameraComponent &camera,
+                                                                         const runtime::WorldTransformComponent &camera_transform)
+        {
+            bgfx::ViewId view_id = static_cast<bgfx::ViewId>(camera.render_layer);
+
+            int32_t win_width, win_height;
+            if (auto window_ptr = camera.target_window.lock())
+            {
+                bgfx::setViewFrameBuffer(view_id, window_ptr->getFrameBufferHandle());
+                window_ptr->getWindowSize(&win_width, &win_height);
+            }
+            else if (camera.offscreen_size.x > 0 && camera.offscreen_size.y > 0)
+            {
+                win_width = static_cast<int32_t>(camera.offscreen_size.x);
+                win_height = static_cast<int32_t>(camera.offscreen_size.y);
+            }
+            else
+            {
+                return std::nullopt;
+            }
+
+            const uint16_t view_x = static_cast<uint16_t>(win_width * camera.viewport_rect.x);
+            const uint16_t view_y = static_cast<uint16_t>(win_height * camera.viewport_rect.y);
+            const uint16_t view_w = static_cast<uint16_t>(win_width * camera.viewport_rect.z);
+            const uint16_t view_h = static_cast<uint16_t>(win_height * camera.viewport_rect.w);
+            bgfx::setViewRect(view_id, view_x, view_y, view_w, view_h);
+
+            glm::mat4 view_mat = glm::inverse(camera_transform.transform);
+            bgfx::setViewTransform(view_id, glm::value_ptr(view_mat), glm::value_ptr(camera.projection_matrix));
+
+            bgfx::setViewClear(view_id, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
+            bgfx::touch(view_id);
+
+            return runtime::ParallelRenderer::Pass{ view_id, view_mat, camera.culling_mask,
+                                                    runtime::SpatialIndex::computeViewRect(view_mat, camera.projection_matrix),
+                                                    view_w, view_h };
+        }
+
+        struct LayerMember
+        {
+            entt::entity entity;
+            const runtime::WorldTransformComponent* world_transform;
+            const runtime::MeshComponent* mesh;
+            const runtime::MaterialComponent* material;
+        };
+
+        bgfx::TextureHandle material_texture(const runtime::MaterialComponent& material)
+        {
+            if (const auto* pinned = std::get_if<runtime::PinnedTexture>(&material.resource_handle))
+            {
+                return pinned->texture_handle;
+            }
+            const auto* streamed = std::get_if<resources::ResourceHandle<resources::StreamingTextureResource>>(&material.resource_handle);
+            if (streamed != nullptr && *streamed)
+            {
+                return (*streamed)->texture_handle;
+            }
+            const auto* handle = std::get_if<resources::ResourceHandle<resources::TextureResource>>(&material.resource_handle);
+            if (handle != nullptr && *handle)
+            {
+                return (*handle)->texture_handle;
+            }
+            return BGFX_INVALID_HANDLE;
+        }
+
+        // Everything a cached camera's image depends on. Geometry enters through the mesh version, and the texture
+        // handle changes with every refined level of a streamed texture, so neither is hashed byte by byte
+        uint64_t layer_signature(const runtime::ParallelRenderer::Pass& pass, const runtime::CameraComponent& camera,
+                                 const std::vector<LayerMember>& members, const runtime::LayerCache& layer_cache)
+        {
+            runtime::LayerCache::Signature signature;
+            signature.add(pass.view_matrix);
+            signature.add(camera.projection_matrix);
+            signature.add(camera.culling_mask);
+
+            for (const LayerMember& member : members)
+            {
+                signature.add(member.entity);
+                signature.add(member.world_transform->transform);
+                signature.add(member.mesh->sort_layer);
+                signature.add(layer_cache.getMeshVersion(member.entity));
+
+                const runtime::MaterialComponent& material = *member.material;
+                signature.addBytes(material.texture_atlas_alias.data(), material.texture_atlas_alias.size());
+                signature.add(material.color);
+                signature.add(material.is_opaque);
+                signature.add(material.resource_handle.index());
+                signature.add(material_texture(material).idx);
+            }
+            return signature.value();
+        }
+
+        // The loaded meshes a camera draws, in the order RenderSystem submits them
+        void collect_layer_members(entt::registry &registry, const runtime::CameraComponent &camera,
+                                   const runtime::ParallelRenderer::Pass &pass, runtime::SpatialIndex *spatial_index,
+                                   std::vector<entt::entity> &visible, std::vector<LayerMember> &members)
+        {
+            members.clear();
+            const auto collect_entity = [&](entt::entity entity, const runtime::WorldTransformComponent &world_transform,
+                                            const runtime::MeshComponent &mesh, const runtime::MaterialComponent &material)
+            {
+                if ((camera.culling_mask & mesh.layer_mask) == 0)
+                {
+                    return;
+                }
+
+                if (material.load_state == runtime::MaterialComponent::LoadState::Loaded)
+                {
+                    members.push_back({ entity, &world_transform, &mesh, &material });
+                }
+            };
+
+            if (spatial_index != nullptr)
+            {
+                visible.clear();
+                spatial_index->query(pass.view_rect, visible);
+                for (auto entity : visible)
+                {
+                    auto [world_transform, mesh, material] =
+                            registry.try_get<runtime::WorldTransformComponent, runtime::MeshComponent, runtime::MaterialComponent>(entity);
+                    if (world_transform != nullptr && mesh != nullptr && material != nullptr)
+                    {
+                        collect_entity(entity, *world_transform, *mesh, *material);
+                    }
+                }
+            }
+            else
+            {
+                // Led by the mesh storage, the order SpatialIndex::query() reproduces
+                for (auto [entity, mesh] : registry.view<runtime::MeshComponent>().each())
+                {
+                    auto [world_transform, material] = registry.try_get<runtime::WorldTransformComponent, runtime::MaterialComponent>(entity);
+                    if (world_transform != nullptr && material != nullptr)
+                    {
+                        collect_entity(entity, *world_transform, mesh, *material);
+                    }
+                }
+            }
+        }
+
+        // Points the cache's view at the target, the transparent clear lets the composite blend it over whatever lies below
+        void setup_layer_view(const runtime::LayerCache::Target &target, const runtime::ParallelRenderer::Pass &pass,
+                              const runtime::CameraComponent &camera)
+        {
+            bgfx::setViewFrameBuffer(target.view_id, target.frame_buffer);
+            bgfx::setViewRect(target.view_id, 0, 0, pass.width, pass.height);
+            bgfx::setViewTransform(target.view_id, glm::value_ptr(pass.view_matrix), glm::value_ptr(camera.projection_matrix));
+            bgfx::setViewClear(target.view_id, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x00000000, 1.0f, 0);
+            bgfx::touch(target.view_id);
+        }
+
+        // Queues the next level of a streamed material, each finished level queues the one after it.
+        // Jobs run inside upload_scheduler.processFrame(), so the scheduler is alive whenever one executes
+        void enqueue_streaming_level(std::weak_ptr<RegistryLifetime> lifetime, resources::TextureUploadScheduler &upload_scheduler,
+                                     entt::entity target, const std::string &alias, uint64_t estimated_bytes, bool urgent)
+        {
+            upload_scheduler.enqueue(estimated_bytes,
+                    [lifetime, &upload_scheduler, target, alias]() -> uint64_t
+                    {
+                        const RegistryToken owner = lifetime.lock();
+                        if (!owner || !owner->registry->valid(target))
+                            return 0;
+                        entt::registry &registry = *owner->registry;
+                        auto* material = registry.try_get<runtime::MaterialComponent>(target);
+                        if (!material || material->load_state == runtime::MaterialComponent::LoadState::Failed)
+                            return 0;
+                        auto* texture = std::get_if<resources::ResourceHandle<resources::StreamingTextureResource>>(
+                                &material->resource_handle);
+                        if (!texture)
+                            return 0;
+
+                        try
+                        {
+                            const uint64_t bytes = (*texture)->uploadNextLevel();
+                            if ((*texture)->hasResidentLevel())
+                            {
+                                material->load_state = runtime::MaterialComponent::LoadState::Loaded;
+                            }
+                            if (!(*texture)->isFullyResident())
+                            {
+                                // Refinements queue behind the first levels of everything else
+                                enqueue_streaming_level(lifetime, upload_scheduler, target, alias,
+                                                        (*texture)->getNextLevelBytes(), false);
+                            }
+                            return bytes;
+                        } catch (const std::exception &e)
+                        {
+                            if (!(*texture)->hasResidentLevel())
+                            {
+                                material->load_state = runtime::MaterialComponent::LoadState::Failed;
+                            }
+                            core::GlobalLogger::getCoreLogger()->error("Failed to stream texture '{}': {}",
+                                                                       alias, e.what());
+                        }
+                        return 0;
+                    }, urgent);
+        }
+
         glm::mat4 calculate_local_transform(const runtime::TransformComponent &transform)
         {
             glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(transform.position, 0.0f));
@@ -27,31 +245,107 @@ namespace cyanvne::ecs::systems
             return local;
         }
 
-        void update_children_transforms(entt::registry &registry, entt::entity parent, const glm::mat4 &parent_transform)
+        // Per registry scratch of the TransformSystem fallback, a TransformTracker carries its own
+        struct TransformScratch
         {
-            auto hierarchy_view = registry.view<runtime::HierarchyComponent>();
-            if (!hierarchy_view.contains(parent))
-                return;
+            std::vector<entt::entity> chain;
+            // Per entity index, equal to generation once the entity was resolved or found detached in this pass
+            std::vector<uint32_t> resolved;
+            std::vector<uint32_t> detached;
+            uint32_t generation = 0;
+        };
 
-            auto current_child = hierarchy_view.get<runtime::HierarchyComponent>(parent).first_child;
-            while (current_child != entt::null && registry.valid(current_child))
+        TransformScratch &transform_scratch(entt::registry &registry)
+        {
+            if (TransformScratch *scratch = registry.ctx().find<TransformScratch>())
             {
-                if (auto *transform = registry.try_get<runtime::TransformComponent>(current_child))
+                return *scratch;
+            }
+            return registry.ctx().emplace<TransformScratch>();
+        }
+
+        // Recomputes every world transform without a tracker. Each entity walks up to its nearest root or resolved
+        // ancestor and the chain is resolved top down, so every node is computed once. Nodes below an entity without
+        // a TransformComponent, or in a cycle, keep their last world transform
+        void update_all_transforms(entt::registry &registry, TransformScratch &scratch)
+        {
+            auto &transforms = registry.storage<runtime::TransformComponent>();
+            auto &world_storage = registry.storage<runtime::WorldTransformComponent>();
+            const auto &hierarchies = registry.storage<runtime::HierarchyComponent>();
+
+            if (++scratch.generation == 0)
+            {
+                std::fill(scratch.resolved.begin(), scratch.resolved.end(), 0);
+                std::fill(scratch.detached.begin(), scratch.detached.end(), 0);
+                scratch.generation = 1;
+            }
+            const uint32_t generation = scratch.generation;
+
+            for (auto [entity, transform] : transforms.each())
+            {
+                scratch.chain.clear();
+                glm::mat4 world(1.0f);
+                bool detached = false;
+
+                entt::entity current = entity;
+                while (true)
                 {
-                    auto &world_transform = registry.get_or_emplace<runtime::WorldTransformComponent>(current_child);
-                    world_transform.transform = parent_transform * calculate_local_transform(*transform);
+                    const auto index = static_cast<size_t>(entt::to_entity(current));
+                    if (index >= scratch.resolved.size())
+                    {
+                        scratch.resolved.resize(index + 1, 0);
+                        scratch.detached.resize(index + 1, 0);
+                    }
 
-                    update_children_transforms(registry, current_child, world_transform.transform);
+                    if (scratch.resolved[index] == generation)
+                    {
+                        world = world_storage.get(current).transform;
+                        break;
+                    }
+                    if (scratch.detached[index] == generation || !transforms.contains(current) ||
+                        scratch.chain.size() > transforms.size())
+                    {
+                        detached = true;
+                        break;
+                    }
+
+                    scratch.chain.push_back(current);
+                    const entt::entity parent = hierarchies.contains(current) ? hierarchies.get(current).parent : entt::null;
+                    if (!registry.valid(parent))
+                    {
+                        break;
+                    }
+                    current = parent;
                 }
 
-                current_child = hierarchy_view.get<runtime::HierarchyComponent>(current_child).next_sibling;
+                for (auto it = scratch.chain.rbegin(); it != scratch.chain.rend(); ++it)
+                {
+                    const auto index = static_cast<size_t>(entt::to_entity(*it));
+                    if (detached)
+                    {
+                        scratch.detached[index] = generation;
+                        continue;
+                    }
+
+                    world = world * calculate_local_transform(transforms.get(*it));
+                    if (world_storage.contains(*it))
+                    {
+                        world_storage.get(*it).transform = world;
+                    }
+                    else
+                    {
+                        registry.emplace<runtime::WorldTransformComponent>(*it, world);
+                    }
+                    scratch.resolved[index] = generation;
+                }
             }
         }
     }
 
     void ResourceLoadingSystem(entt::registry &registry,
                                const std::shared_ptr<resources::UnifiedCacheManager> &cache_manager,
-                               platform::concurrency::UnifiedConcurrencyManager &concurrency_manager)
+                               platform::concurrency::UnifiedConcurrencyManager &concurrency_manager,
+                               resources::TextureUploadScheduler &upload_scheduler)
     {
         auto view = registry.view<runtime::MaterialComponent>();
         for (auto entity: view)
@@ -62,19 +356,25 @@ namespace cyanvne::ecs::systems
                 material.load_state = runtime::MaterialComponent::LoadState::Loading;
                 auto alias = material.texture_atlas_alias;
                 auto is_pinned = material.is_pinned;
+                auto is_streamed = material.is_streamed;
 
                 concurrency_manager.submit_worker_and_continue_on_main(
-                        [cache_manager, entity, alias, is_pinned]() -> TextureLoadResultPtr
+                        [cache_manager, entity, alias, is_pinned, is_streamed]() -> TextureLoadResultPtr
                         {
                             auto result = std::make_shared<TextureLoadResult>();
                             result->target_entity = entity;
                             result->resource_alias = alias;
                             result->is_pinned = is_pinned;
+                            result->is_streamed = is_streamed;
                             try
                             {
                                 if (is_pinned)
                                 {
                                     result->data_handle = cache_manager->getUncachedBuffer(alias);
+                                } else if (is_streamed)
+                                {
+                                    // Decoding and downsampling happen here, on the worker
+                                    result->streaming_handle = cache_manager->get<resources::StreamingTextureResource>(alias);
                                 } else
                                 {
                                     result->resource_handle = cache_manager->get<resources::TextureResource>(alias);
@@ -85,10 +385,13 @@ namespace cyanvne::ecs::systems
                             }
                             return result;
                         },
-                        [&registry](std::optional<TextureLoadResultPtr> result_ptr_opt, const std::exception_ptr &)
+                        // The scheduler belongs to the GameStateManager and outlives the states, the registry may not
+                        [lifetime = registry_lifetime(registry), &upload_scheduler](std::optional<TextureLoadResultPtr> result_ptr_opt, const std::exception_ptr &)
                         {
-                            if (!result_ptr_opt || !*result_ptr_opt)
+                            const RegistryToken owner = lifetime.lock();
+                            if (!owner || !result_ptr_opt || !*result_ptr_opt)
                                 return;
+                            entt::registry &registry = *owner->registry;
                             auto &result = **result_ptr_opt;
 
                             if (!registry.valid(result.target_entity))
@@ -123,13 +426,70 @@ namespace cyanvne::ecs::systems
                                 {
                                     material.load_state = runtime::MaterialComponent::LoadState::Failed;
                                 }
+                            } else if (result.is_streamed)
+                            {
+                                if (result.streaming_handle)
+                                {
+                                    auto& handle = material.resource_handle.emplace<resources::ResourceHandle<resources::StreamingTextureResource>>(
+                                            std::move(*result.streaming_handle));
+                                    material.load_state = handle->hasResidentLevel()
+                                                          ? runtime::MaterialComponent::LoadState::Loaded
+                                                          : runtime::MaterialComponent::LoadState::Uploading;
+                                    if (!handle->isFullyResident())
+                                    {
+                                        // The smallest level jumps the queue, time to first pixel matters most
+                                        enqueue_streaming_level(lifetime, upload_scheduler, result.target_entity,
+                                                                result.resource_alias, handle->getNextLevelBytes(),
+                                                                !handle->hasResidentLevel());
+                                    }
+                                } else
+                                {
+                                    material.load_state = runtime::MaterialComponent::LoadState::Failed;
+                                }
                             } else
                             {
                                 if (result.resource_handle)
                                 {
-                                    material.resource_handle.emplace<resources::ResourceHandle<resources::TextureResource>>(
+                                    auto& handle = material.resource_handle.emplace<resources::ResourceHandle<resources::TextureResource>>(
                                             std::move(*result.resource_handle));
-                                    material.load_state = runtime::MaterialComponent::LoadState::Loaded;
+                                    if (handle->isUploaded())
+                                    {
+                                        material.load_state = runtime::MaterialComponent::LoadState::Loaded;
+                                        return;
+                                    }
+
+                                    material.load_state = runtime::MaterialComponent::LoadState::Uploading;
+                                    const entt::entity target = result.target_entity;
+                                    const std::string alias = result.resource_alias;
+                                    upload_scheduler.enqueue(handle->getPendingUploadBytes(),
+                                            [lifetime, target, alias]() -> uint64_t
+                                            {
+                                                // The registry, the entity or its material may be gone by the time our slot comes up
+                                                const RegistryToken owner = lifetime.lock();
+                                                if (!owner || !owner->registry->valid(target))
+                                                    return 0;
+                                                entt::registry &registry = *owner->registry;
+                                                auto* material = registry.try_get<runtime::MaterialComponent>(target);
+                                                if (!material || material->load_state != runtime::MaterialComponent::LoadState::Uploading)
+                                                    return 0;
+                                                auto* texture = std::get_if<resources::ResourceHandle<resources::TextureResource>>(
+                                                        &material->resource_handle);
+                                                if (!texture)
+                                                    return 0;
+
+                                                try
+                                                {
+                                                    const uint64_t bytes = (*texture)->upload();
+                                                    material->load_state = runtime::MaterialComponent::LoadState::Loaded;
+                                                    return bytes;
+                                                } catch (const std::exception &e)
+                                                {
+                                                    material->load_state = runtime::MaterialComponent::LoadState::Failed;
+                                                    core::GlobalLogger::getCoreLogger()->error("Failed to upload texture '{}': {}",
+                                                                                               alias, e.what());
+                                                }
+                                                return 0;
+                                            });
                                 } else
                                 {
                                     material.load_state = runtime::MaterialComponent::LoadState::Failed;
@@ -141,86 +501,224 @@ namespace cyanvne::ecs::systems
         }
     }
 
-    void TransformSystem(entt::registry &registry)
+    void TransformSystem(entt::registry &registry, runtime::SpatialIndex *spatial_index, runtime::TransformTracker *tracker)
     {
-        auto view = registry.view<runtime::TransformComponent>();
-        for (auto entity: view)
+        if (tracker == nullptr || !tracker->isConnected(registry))
         {
-            bool is_root = true;
-            if (auto *hierarchy = registry.try_get<runtime::HierarchyComponent>(entity))
+            update_all_transforms(registry, transform_scratch(registry));
+
+            if (spatial_index != nullptr)
             {
-                if (registry.valid(hierarchy->parent))
+                auto bounds_view = registry.view<runtime::WorldTransformComponent, runtime::MeshComponent>();
+                for (auto entity : bounds_view)
                 {
-                    is_root = false;
+                    spatial_index->update(entity, bounds_view.get<runtime::WorldTransformComponent>(entity).transform,
+                                          bounds_view.get<runtime::MeshComponent>(entity));
                 }
             }
+            return;
+        }
 
-            if (is_root)
+        if (!tracker->prepare())
+        {
+            return;
+        }
+
+        // Slots are the packed order of the transform storage, parents first, so a parent's flag and matrix are final
+        // before its children are reached. The world storage holds the same entities in the same order from the offset on.
+        // Only moved nodes and their descendants are recomputed, stationary ones keep last frame's matrices
+        const std::vector<entt::entity> &entities = tracker->getEntities();
+        const std::vector<uint32_t> &parents = tracker->getParents();
+        std::vector<uint8_t> &changed = tracker->getChanged();
+        std::vector<glm::mat4> &world_transforms = tracker->getWorldTransforms();
+        auto &transforms = registry.storage<runtime::TransformComponent>();
+        auto &world_storage = registry.storage<runtime::WorldTransformComponent>();
+        const auto &meshes = registry.storage<runtime::MeshComponent>();
+
+        // Reverse iterators walk the packed arrays front to back
+        auto transform_it = transforms.rbegin();
+        auto world_it = world_storage.rbegin() + static_cast<std::ptrdiff_t>(tracker->getWorldOffset());
+        for (uint32_t slot = 0; slot < entities.size(); ++slot, ++transform_it, ++world_it)
+        {
+            const uint32_t parent = parents[slot];
+            if (parent == runtime::TransformTracker::DETACHED ||
+                (changed[slot] == 0 && (parent == runtime::TransformTracker::NO_PARENT || changed[parent] == 0)))
             {
-                auto &transform = view.get<runtime::TransformComponent>(entity);
-                auto &world_transform = registry.get_or_emplace<runtime::WorldTransformComponent>(entity);
+                continue;
+            }
 
-                world_transform.transform = calculate_local_transform(transform);
+            world_transforms[slot] = parent == runtime::TransformTracker::NO_PARENT
+                                         ? calculate_local_transform(*transform_it)
+                                         : world_transforms[parent] * calculate_local_transform(*transform_it);
+            world_it->transform = world_transforms[slot];
+            changed[slot] = 1;
 
-                update_children_transforms(registry, entity, world_transform.transform);
+            if (spatial_index != nullptr && meshes.contains(entities[slot]))
+            {
+                spatial_index->update(entities[slot], world_transforms[slot], meshes.get(entities[slot]));
+            }
+        }
+
+        if (spatial_index != nullptr)
+        {
+            for (entt::entity entity : tracker->getBounds())
+            {
+                if (!meshes.contains(entity))
+                {
+                    continue;
+                }
+
+                // Moved entities were refreshed above, the rest read their matrix without a component lookup where possible
+                if (const uint32_t slot = tracker->slotOf(entity); slot != runtime::TransformTracker::NO_PARENT)
+                {
+                    if (changed[slot] == 0)
+                    {
+                        spatial_index->update(entity, world_transforms[slot], meshes.get(entity));
+                    }
+                }
+                else if (world_storage.contains(entity))
+                {
+                    spatial_index->update(entity, world_storage.get(entity).transform, meshes.get(entity));
+                }
             }
         }
     }
 
-    void RenderSystem(entt::registry &registry, runtime::MeshBatchRenderer &renderer)
+    void RenderSystem(entt::registry &registry, runtime::MeshBatchRenderer &renderer, runtime::SpatialIndex *spatial_index,
+                      runtime::LayerCache *layer_cache)
     {
+        // Signatures rely on the mesh versions, an unconnected cache would miss geometry edits
+        if (layer_cache != nullptr && !layer_cache->isConnected(registry))
+        {
+            layer_cache = nullptr;
+        }
+
+        renderer.beginFrame();
+        std::vector<entt::entity> visible;
+        std::vector<LayerMember> members;
+
         auto camera_view = registry.view<runtime::CameraComponent, runtime::WorldTransformComponent>();
         for (auto camera_entity : camera_view)
         {
             auto& camera = camera_view.get<runtime::CameraComponent>(camera_entity);
             auto& camera_transform = camera_view.get<runtime::WorldTransformComponent>(camera_entity);
 
-            if (camera.target_window.expired())
+            const auto pass = setup_camera_view(camera, camera_transform);
+            if (!pass)
             {
                 continue;
             }
-            auto window_ptr = camera.target_window.lock();
-
-            bgfx::ViewId view_id = static_cast<bgfx::ViewId>(camera.render_layer);
-            bgfx::setViewFrameBuffer(view_id, window_ptr->getFrameBufferHandle());
-
-            int32_t win_width, win_height;
-            window_ptr->getWindowSize(&win_width, &win_height);
-
-            const uint16_t view_x = static_cast<uint16_t>(win_width * camera.viewport_rect.x);
-            const uint16_t view_y = static_cast<uint16_t>(win_height * camera.viewport_rect.y);
-            const uint16_t view_w = static_cast<uint16_t>(win_width * camera.viewport_rect.z);
-            const uint16_t view_h = static_cast<uint16_t>(win_height * camera.viewport_rect.w);
-            bgfx::setViewRect(view_id, view_x, view_y, view_w, view_h);
 
-            glm::mat4 view_mat = glm::inverse(camera_transform.transform);
-            bgfx::setViewTransform(view_id, glm::value_ptr(view_mat), glm::value_ptr(camera.projection_matrix));
-
-            bgfx::setViewClear(view_id, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
-            bgfx::touch(view_id);
+            collect_layer_members(registry, camera, *pass, spatial_index, visible, members);
 
-            renderer.begin(view_id);
-
-            auto render_view = registry.view<runtime::WorldTransformComponent, runtime::MeshComponent, runtime::MaterialComponent>();
-            for (auto entity: render_view)
+            std::optional<runtime::LayerCache::Target> target;
+            if (camera.is_cached && layer_cache != nullptr)
             {
-                auto& mesh = render_view.get<runtime::MeshComponent>(entity);
+                target = layer_cache->acquire(camera_entity, pass->width, pass->height,
+                                              layer_signature(*pass, camera, members, *layer_cache));
+            }
 
-                if ((camera.culling_mask & mesh.layer_mask) == 0)
+            if (!target)
+            {
+                renderer.begin(pass->view_id, pass->view_matrix);
+                for (const LayerMember& member : members)
                 {
-                    continue;
+                    renderer.submit(member.world_transform->transform, *member.mesh, *member.material, member.entity);
                 }
+                renderer.end();
+                continue;
+            }
 
-                auto& world_transform = render_view.get<runtime::WorldTransformComponent>(entity);
-                auto& material = render_view.get<runtime::MaterialComponent>(entity);
+            if (target->needs_redraw)
+            {
+                setup_layer_view(*target, *pass, camera);
 
-                if (material.load_state == runtime::MaterialComponent::LoadState::Loaded)
+                renderer.setPremultipliedOutput(true);
+                renderer.begin(target->view_id, pass->view_matrix);
+                for (const LayerMember& member : members)
                 {
-                    renderer.submit(world_transform.transform, mesh, material);
+                    renderer.submit(member.world_transform->transform, *member.mesh, *member.material, member.entity);
                 }
+                renderer.end();
+                renderer.setPremultipliedOutput(false);
             }
 
+            const glm::mat4 identity(1.0f);
+            bgfx::setViewTransform(pass->view_id, glm::value_ptr(identity), glm::value_ptr(identity));
+            renderer.begin(pass->view_id);
+            renderer.submitFullscreenQuad(target->texture, true);
             renderer.end();
         }
+
+        if (layer_cache != nullptr)
+        {
+            layer_cache->collect();
+        }
+    }
+
+    void ParallelRenderSystem(entt::registry &registry, runtime::ParallelRenderer &renderer,
+                              platform::concurrency::UnifiedConcurrencyManager &concurrency_manager,
+                              runtime::SpatialIndex *spatial_index, runtime::LayerCache *layer_cache)
+    {
+        if (layer_cache != nullptr && !layer_cache->isConnected(registry))
+        {
+            layer_cache = nullptr;
+        }
+
+        std::vector<runtime::ParallelRenderer::Pass> passes;
+        std::vector<std::pair<bgfx::ViewId, bgfx::TextureHandle>> composites;
+        std::vector<entt::entity> visible;
+        std::vector<LayerMember> members;
+
+        auto camera_view = registry.view<runtime::CameraComponent, runtime::WorldTransformComponent>();
+        for (auto camera_entity : camera_view)
+        {
+            const auto& camera = camera_view.get<runtime::CameraComponent>(camera_entity);
+            const auto pass = setup_camera_view(camera, camera_view.get<runtime::WorldTransformComponent>(camera_entity));
+            if (!pass)
+            {
+                continue;
+            }
+
+            std::optional<runtime::LayerCache::Target> target;
+            if (camera.is_cached && layer_cache != nullptr)
+            {
+                // The signature needs the members on the main thread, the workers collect them again only on a redraw
+                collect_layer_members(registry, camera, *pass, spatial_index, visible, members);
+                target = layer_cache->acquire(camera_entity, pass->width, pass->height,
+                                              layer_signature(*pass, camera, members, *layer_cache));
+            }
+
+            if (!target)
+            {
+                passes.push_back(*pass);
+                continue;
+            }
+
+            if (target->needs_redraw)
+            {
+                setup_layer_view(*target, *pass, camera);
+
+                runtime::ParallelRenderer::Pass layer_pass = *pass;
+                layer_pass.view_id = target->view_id;
+                layer_pass.premultiplied_output = true;
+                passes.push_back(layer_pass);
+            }
+            composites.emplace_back(pass->view_id, target->texture);
+        }
+
+        renderer.render(registry, passes, concurrency_manager, spatial_index);
+
+        const glm::mat4 identity(1.0f);
+        for (const auto& [view_id, texture] : composites)
+        {
+            bgfx::setViewTransform(view_id, glm::value_ptr(identity), glm::value_ptr(identity));
+            renderer.composite(view_id, texture);
+        }
+
+        if (layer_cache != nullptr)
+        {
+            layer_cache->collect();
+        }
     }
 }
\ No newline at end of file
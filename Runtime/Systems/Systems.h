@@ -3,16 +3,37 @@
 #define M_PI       3.14159265358979323846
 #include "Runtime/Components/Components.h"
 #include "Resources/UnifiedCacheManager/UnifiedCacheManager.h"
+#include "Resources/TextureUploadScheduler/TextureUploadScheduler.h"
+#include "Runtime/Renderer/ParallelRenderer/ParallelRenderer.h"
+#include "Runtime/Renderer/LayerCache/LayerCache.h"
+#include "Runtime/TransformTracker/TransformTracker.h"
 #include <entt/entt.hpp>
 #include <SDL3/SDL.h>
 
 namespace cyanvne::ecs::systems
 {
-    void TransformSystem(entt::registry& registry);
+    // Refreshes the bounds in spatial_index when one is given, pass the same index to the render systems.
+    // With a tracker connected to registry the world transforms are computed in one pass over the hierarchy ordered
+    // storages, only for entities that moved since the last run and their descendants. Without one every
+    // world transform is rebuilt, each node once, walking up to its nearest resolved ancestor
+    void TransformSystem(entt::registry& registry, runtime::SpatialIndex* spatial_index = nullptr,
+                         runtime::TransformTracker* tracker = nullptr);
 
-    void RenderSystem(entt::registry& registry, runtime::MeshBatchRenderer& renderer);
+    // With a spatial_index each camera only visits the entities intersecting its view.
+    // With a layer_cache connected to registry, cameras flagged is_cached are composited from their cached target
+    void RenderSystem(entt::registry& registry, runtime::MeshBatchRenderer& renderer,
+                      runtime::SpatialIndex* spatial_index = nullptr,
+                      runtime::LayerCache* layer_cache = nullptr);
+
+    // Same output as RenderSystem, with draw submission spread over the concurrency manager's workers.
+    // Layer signatures and composites stay on the main thread, only layer redraws go to the workers
+    void ParallelRenderSystem(entt::registry& registry, runtime::ParallelRenderer& renderer,
+                              platform::concurrency::UnifiedConcurrencyManager& concurrency_manager,
+                              runtime::SpatialIndex* spatial_index = nullptr,
+                              runtime::LayerCache* layer_cache = nullptr);
 
     void ResourceLoadingSystem(entt::registry& registry,
                                const std::shared_ptr<resources::UnifiedCacheManager>& cache_manager,
-                               platform::concurrency::UnifiedConcurrencyManager& concurrency_manager);
+                               platform::concurrency::UnifiedConcurrencyManager& concurrency_manager,
+                               resources::TextureUploadScheduler& upload_scheduler);
 }
\ No newline at end of file
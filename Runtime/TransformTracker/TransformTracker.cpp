@@ -0,0 +1,359 @@
+#include "TransformTracker.h"
+#include "Runtime/Components/Components.h"
+#include <algorithm>
+
+namespace cyanvne::runtime
+{
+    TransformTracker::~TransformTracker()
+    {
+        disconnect();
+    }
+
+    void TransformTracker::connect(entt::registry& registry)
+    {
+        disconnect();
+
+        registry_ = &registry;
+        registry_->on_construct<TransformComponent>().connect<&TransformTracker::onTransformAdded>(*this);
+        registry_->on_update<TransformComponent>().connect<&TransformTracker::onTransformChanged>(*this);
+        registry_->on_destroy<TransformComponent>().connect<&TransformTracker::onTransformRemoved>(*this);
+        registry_->on_destroy<WorldTransformComponent>().connect<&TransformTracker::onWorldTransformRemoved>(*this);
+        registry_->on_construct<HierarchyComponent>().connect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_update<HierarchyComponent>().connect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_destroy<HierarchyComponent>().connect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_construct<MeshComponent>().connect<&TransformTracker::onMeshChanged>(*this);
+        registry_->on_update<MeshComponent>().connect<&TransformTracker::onMeshChanged>(*this);
+        order_dirty_ = true;
+        markAllDirty();
+    }
+
+    void TransformTracker::disconnect()
+    {
+        if (registry_ == nullptr)
+        {
+            return;
+        }
+
+        registry_->on_construct<TransformComponent>().disconnect<&TransformTracker::onTransformAdded>(*this);
+        registry_->on_update<TransformComponent>().disconnect<&TransformTracker::onTransformChanged>(*this);
+        registry_->on_destroy<TransformComponent>().disconnect<&TransformTracker::onTransformRemoved>(*this);
+        registry_->on_destroy<WorldTransformComponent>().disconnect<&TransformTracker::onWorldTransformRemoved>(*this);
+        registry_->on_construct<HierarchyComponent>().disconnect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_update<HierarchyComponent>().disconnect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_destroy<HierarchyComponent>().disconnect<&TransformTracker::onHierarchyChanged>(*this);
+        registry_->on_construct<MeshComponent>().disconnect<&TransformTracker::onMeshChanged>(*this);
+        registry_->on_update<MeshComponent>().disconnect<&TransformTracker::onMeshChanged>(*this);
+        registry_ = nullptr;
+
+        entities_.clear();
+        parents_.clear();
+        changed_.clear();
+        world_transforms_.clear();
+        slots_.clear();
+        depths_.clear();
+        bounds_.clear();
+        hierarchy_dirty_.clear();
+        order_dirty_ = true;
+        markAllDirty();
+    }
+
+    void TransformTracker::onTransformChanged(entt::registry& registry, entt::entity entity)
+    {
+        markDirty(entity);
+    }
+
+    void TransformTracker::onTransformAdded(entt::registry& registry, entt::entity entity)
+    {
+        // The storage appends it, prepare() turns it into a new slot
+        structure_dirty_ = true;
+    }
+
+    void TransformTracker::onTransformRemoved(entt::registry& registry, entt::entity entity)
+    {
+        // The storage moves its last transform into the hole, the slots no longer follow the hierarchy
+        order_dirty_ = true;
+        markAllDirty();
+    }
+
+    void TransformTracker::onWorldTransformRemoved(entt::registry& registry, entt::entity entity)
+    {
+        world_order_dirty_ = true;
+        structure_dirty_ = true;
+    }
+
+    void TransformTracker::onHierarchyChanged(entt::registry& registry, entt::entity entity)
+    {
+        // Links are often edited in several steps, the parent is only read once they are done
+        if (!order_dirty_)
+        {
+            hierarchy_dirty_.insert(entity);
+        }
+        structure_dirty_ = true;
+    }
+
+    void TransformTracker::onMeshChanged(entt::registry& registry, entt::entity entity)
+    {
+        if (!all_dirty_)
+        {
+            bounds_dirty_.insert(entity);
+        }
+    }
+
+    void TransformTracker::markDirty(entt::entity entity)
+    {
+        if (!all_dirty_)
+        {
+            dirty_.insert(entity);
+        }
+    }
+
+    void TransformTracker::markAllDirty()
+    {
+        all_dirty_ = true;
+        dirty_.clear();
+        bounds_dirty_.clear();
+    }
+
+    uint32_t TransformTracker::slotOf(entt::entity entity) const
+    {
+        const auto index = static_cast<size_t>(entt::to_entity(entity));
+        if (index >= slots_.size())
+        {
+            return NO_PARENT;
+        }
+
+        const uint32_t slot = slots_[index];
+        return slot < entities_.size() && entities_[slot] == entity ? slot : NO_PARENT;
+    }
+
+    bool TransformTracker::applyStructureChanges()
+    {
+        entt::registry& registry = *registry_;
+        const auto& transforms = registry.storage<TransformComponent>();
+        const auto& hierarchies = registry.storage<HierarchyComponent>();
+        if (transforms.size() < entities_.size())
+        {
+            return false;
+        }
+
+        // Without removals the existing slots keep their packed index and the new transforms follow them
+        const size_t first_new = entities_.size();
+        for (size_t slot = first_new; slot < transforms.size(); ++slot)
+        {
+            const entt::entity entity = transforms.data()[slot];
+            // Older children were DETACHED until now, only a full re-sort attaches their subtrees
+            entt::entity child = hierarchies.contains(entity) ? hierarchies.get(entity).first_child : entt::null;
+            for (size_t visited = 0; registry.valid(child) && visited < transforms.size(); ++visited)
+            {
+                if (slotOf(child) < first_new)
+                {
+                    return false;
+                }
+                child = hierarchies.contains(child) ? hierarchies.get(child).next_sibling : entt::null;
+            }
+
+            const auto index = static_cast<size_t>(entt::to_entity(entity));
+            if (index >= slots_.size())
+            {
+                slots_.resize(index + 1, NO_PARENT);
+            }
+            slots_[index] = static_cast<uint32_t>(slot);
+            entities_.push_back(entity);
+            hierarchy_dirty_.insert(entity);
+        }
+
+        parents_.resize(entities_.size(), NO_PARENT);
+        changed_.resize(entities_.size());
+        world_transforms_.resize(entities_.size(), glm::mat4(1.0f));
+
+        for (entt::entity entity : hierarchy_dirty_)
+        {
+            const uint32_t slot = slotOf(entity);
+            if (slot == NO_PARENT)
+            {
+                continue;
+            }
+
+            uint32_t parent = NO_PARENT;
+            if (hierarchies.contains(entity) && registry.valid(hierarchies.get(entity).parent))
+            {
+                // A later parent needs the re-sort, one without a transform or a detached one detaches the whole subtree
+                parent = slotOf(hierarchies.get(entity).parent);
+                if (parent >= slot || parents_[parent] == DETACHED)
+                {
+                    return false;
+                }
+            }
+
+            if (slot < first_new && parents_[slot] == DETACHED)
+            {
+                return false;
+            }
+            if (slot >= first_new || parents_[slot] != parent)
+            {
+                parents_[slot] = parent;
+                markDirty(entity);
+            }
+        }
+
+        // New slots are computed even when a full recompute is already pending
+        for (size_t slot = first_new; slot < entities_.size(); ++slot)
+        {
+            changed_[slot] = 1;
+        }
+
+        syncWorldTransforms(world_order_dirty_ ? 0 : first_new);
+        return true;
+    }
+
+    void TransformTracker::syncWorldTransforms(size_t first_slot)
+    {
+        entt::registry& registry = *registry_;
+        auto& world_storage = registry.storage<WorldTransformComponent>();
+
+        for (size_t slot = first_slot; slot < entities_.size(); ++slot)
+        {
+            if (!world_storage.contains(entities_[slot]))
+            {
+                registry.emplace<WorldTransformComponent>(entities_[slot]);
+                changed_[slot] = 1;
+            }
+        }
+
+        // World transforms are only appended for the new slots in the usual case, checking those is enough
+        const size_t offset = world_storage.size() - entities_.size();
+        bool aligned = !world_order_dirty_ && offset == world_offset_;
+        for (size_t slot = first_slot; aligned && slot < entities_.size(); ++slot)
+        {
+            aligned = world_storage.data()[offset + slot] == entities_[slot];
+        }
+
+        if (!aligned)
+        {
+            // Moves the shared entities to the end of the world storage, in the packed order of the transforms
+            registry.sort<WorldTransformComponent, TransformComponent>();
+        }
+        world_offset_ = offset;
+        world_order_dirty_ = false;
+    }
+
+    void TransformTracker::rebuildOrder()
+    {
+        entt::registry& registry = *registry_;
+        auto& transforms = registry.storage<TransformComponent>();
+
+        // Depth walks only run here, a cycle stops after visiting every transform once
+        const size_t max_depth = transforms.size();
+        for (auto [entity, transform] : transforms.each())
+        {
+            uint32_t depth = 0;
+            const auto* hierarchy = registry.try_get<HierarchyComponent>(entity);
+            while (hierarchy != nullptr && registry.valid(hierarchy->parent) && depth < max_depth)
+            {
+                ++depth;
+                hierarchy = registry.try_get<HierarchyComponent>(hierarchy->parent);
+            }
+
+            const auto index = static_cast<size_t>(entt::to_entity(entity));
+            if (index >= depths_.size())
+            {
+                depths_.resize(index + 1, 0);
+            }
+            depths_[index] = depth;
+        }
+
+        // Iteration runs from the back of the packed array, deepest first leaves the parents at the front
+        registry.sort<TransformComponent>([this](const entt::entity lhs, const entt::entity rhs)
+        {
+            return depths_[static_cast<size_t>(entt::to_entity(lhs))] > depths_[static_cast<size_t>(entt::to_entity(rhs))];
+        });
+
+        entities_.assign(transforms.data(), transforms.data() + transforms.size());
+        for (uint32_t slot = 0; slot < entities_.size(); ++slot)
+        {
+            const auto index = static_cast<size_t>(entt::to_entity(entities_[slot]));
+            if (index >= slots_.size())
+            {
+                slots_.resize(index + 1, NO_PARENT);
+            }
+            slots_[index] = slot;
+        }
+
+        parents_.resize(entities_.size());
+        for (uint32_t slot = 0; slot < entities_.size(); ++slot)
+        {
+            const auto* hierarchy = registry.try_get<HierarchyComponent>(entities_[slot]);
+            if (hierarchy == nullptr || !registry.valid(hierarchy->parent))
+            {
+                parents_[slot] = NO_PARENT;
+                continue;
+            }
+
+            // Parents sort before their children, anything else is a cycle or a parent without a transform
+            const uint32_t parent = slotOf(hierarchy->parent);
+            parents_[slot] = parent < slot && parents_[parent] != DETACHED ? parent : DETACHED;
+        }
+
+        changed_.resize(entities_.size());
+        world_transforms_.resize(entities_.size(), glm::mat4(1.0f));
+        hierarchy_dirty_.clear();
+        order_dirty_ = false;
+
+        // Every transform gets a world transform, so both storages can share one order
+        world_order_dirty_ = true;
+        syncWorldTransforms(0);
+        markAllDirty();
+    }
+
+    bool TransformTracker::prepare()
+    {
+        bounds_.clear();
+        if (registry_ == nullptr || !hasChanges())
+        {
+            return false;
+        }
+
+        std::fill(changed_.begin(), changed_.end(), 0);
+        if (!order_dirty_ && structure_dirty_ && !applyStructureChanges())
+        {
+            order_dirty_ = true;
+        }
+        if (order_dirty_)
+        {
+            rebuildOrder();
+        }
+        // World transforms added to entities without a transform push the shared block back, only the sizes are compared
+        syncWorldTransforms(entities_.size());
+        hierarchy_dirty_.clear();
+        structure_dirty_ = false;
+
+        // New slots and slots that got a world transform back are already flagged
+        if (all_dirty_)
+        {
+            std::fill(changed_.begin(), changed_.end(), 1);
+        }
+        else
+        {
+            for (entt::entity entity : dirty_)
+            {
+                if (const uint32_t slot = slotOf(entity); slot != NO_PARENT)
+                {
+                    changed_[slot] = 1;
+                }
+            }
+
+            for (entt::entity entity : bounds_dirty_)
+            {
+                if (registry_->valid(entity))
+                {
+                    bounds_.push_back(entity);
+                }
+            }
+        }
+
+        dirty_.clear();
+        bounds_dirty_.clear();
+        all_dirty_ = false;
+        return true;
+    }
+}
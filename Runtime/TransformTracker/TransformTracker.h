@@ -0,0 +1,142 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+namespace cyanvne::runtime
+{
+    /**
+     * @brief Records which entities moved since the last TransformSystem run and keeps the transform storages in hierarchy order.
+     * A TransformComponent that is patched or replaced marks its entity dirty. Components edited in place
+     * through get<>() are not seen, call markDirty() after such edits.
+     * Emplacing, patching or replacing a MeshComponent only marks the entity's bounds for the SpatialIndex.
+     * Slots follow the packed order of the TransformComponent storage, parents before children, and the
+     * WorldTransformComponent storage holds the same entities in the same order at its end, so the world
+     * transforms can be computed in one pass over both arrays.
+     * New transforms are appended as new slots and hierarchy edits only update the parent slot, as long as every
+     * parent keeps a lower slot than its children. Removing a TransformComponent, parenting a node to a later one
+     * or to an entity without a transform re-sorts the storage by depth and recomputes everything.
+     * Do not sort the TransformComponent storage elsewhere while connected.
+     */
+    class TransformTracker
+    {
+    public:
+        // Parent slot of a root
+        static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+        // Parent slot of a node below an entity without a TransformComponent, it keeps its last world transform
+        static constexpr uint32_t DETACHED = NO_PARENT - 1;
+
+    private:
+        entt::registry* registry_ = nullptr;
+        std::unordered_set<entt::entity> dirty_;
+        std::unordered_set<entt::entity> bounds_dirty_;
+        // Entities whose HierarchyComponent was added, edited or removed, their parent slot is checked by prepare()
+        std::unordered_set<entt::entity> hierarchy_dirty_;
+        bool all_dirty_ = true;
+        bool order_dirty_ = true;
+        bool world_order_dirty_ = true;
+        bool structure_dirty_ = true;
+        // Packed index of slot 0 in the WorldTransformComponent storage
+        size_t world_offset_ = 0;
+
+        // One slot per TransformComponent, in packed storage order
+        std::vector<entt::entity> entities_;
+        std::vector<uint32_t> parents_;
+        std::vector<uint8_t> changed_;
+        std::vector<glm::mat4> world_transforms_;
+        // Indexed by entt::to_entity()
+        std::vector<uint32_t> slots_;
+        std::vector<uint32_t> depths_;
+
+        // Scratch of TransformSystem, kept here so every registry gets its own
+        std::vector<entt::entity> bounds_;
+
+        void onTransformChanged(entt::registry& registry, entt::entity entity);
+        void onTransformAdded(entt::registry& registry, entt::entity entity);
+        void onTransformRemoved(entt::registry& registry, entt::entity entity);
+        void onWorldTransformRemoved(entt::registry& registry, entt::entity entity);
+        void onHierarchyChanged(entt::registry& registry, entt::entity entity);
+        void onMeshChanged(entt::registry& registry, entt::entity entity);
+
+        // Appends the new transforms and applies the hierarchy edits, false when they need a full re-sort
+        bool applyStructureChanges();
+        void rebuildOrder();
+        // Gives the slots from first_slot a world transform and lines the world storage up with the slots
+        void syncWorldTransforms(size_t first_slot);
+
+    public:
+        TransformTracker() = default;
+        ~TransformTracker();
+
+        TransformTracker(const TransformTracker&) = delete;
+        TransformTracker& operator=(const TransformTracker&) = delete;
+        TransformTracker(TransformTracker&&) = delete;
+        TransformTracker& operator=(TransformTracker&&) = delete;
+
+        // Listens to transform, hierarchy and mesh signals, the registry has to stay alive until disconnect()
+        void connect(entt::registry& registry);
+        void disconnect();
+
+        bool isConnected(const entt::registry& registry) const
+        {
+            return registry_ == &registry;
+        }
+
+        void markDirty(entt::entity entity);
+        void markAllDirty();
+
+        bool hasChanges() const
+        {
+            return all_dirty_ || order_dirty_ || structure_dirty_ || !dirty_.empty() || !bounds_dirty_.empty();
+        }
+
+        /**
+         * @brief Updates the slots if the structure changed and flags the slots of the dirty entities, called by TransformSystem.
+         * Afterwards getChanged() holds 1 for every slot whose own transform changed, descendants are left to the caller,
+         * and getBounds() the entities whose mesh changed, their bounds need a refresh even if they did not move.
+         * @return false when nothing changed since the last call
+         */
+        bool prepare();
+
+        // Slot of entity, NO_PARENT when it has no TransformComponent
+        uint32_t slotOf(entt::entity entity) const;
+
+        // Entity of every slot, slot i is packed index i of the TransformComponent storage
+        const std::vector<entt::entity>& getEntities() const
+        {
+            return entities_;
+        }
+
+        // Parent slot of every slot, always lower than the slot itself, or NO_PARENT / DETACHED
+        const std::vector<uint32_t>& getParents() const
+        {
+            return parents_;
+        }
+
+        // Slot i is packed index getWorldOffset() + i of the WorldTransformComponent storage
+        size_t getWorldOffset() const
+        {
+            return world_offset_;
+        }
+
+        std::vector<uint8_t>& getChanged()
+        {
+            return changed_;
+        }
+
+        // Last computed world transform per slot, read by the children without a storage lookup
+        std::vector<glm::mat4>& getWorldTransforms()
+        {
+            return world_transforms_;
+        }
+
+        const std::vector<entt::entity>& getBounds() const
+        {
+            return bounds_;
+        }
+    };
+}
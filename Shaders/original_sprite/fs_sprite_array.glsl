@@ -0,0 +1,18 @@
+$input v_texcoord0, v_color0, v_texlayer
+
+#include <bgfx_shader.sh>
+
+#if BGFX_SHADER_LANGUAGE_HLSL || BGFX_SHADER_LANGUAGE_SPIRV || BGFX_SHADER_LANGUAGE_METAL || BGFX_SHADER_LANGUAGE_GLSL >= 130
+SAMPLER2DARRAY(s_texColor, 0);
+#define SAMPLE_SPRITE(_uv, _layer) texture2DArray(s_texColor, vec3(_uv, _layer))
+#else
+// Profiles without array textures, MeshBatchRenderer never binds this program there
+SAMPLER2D(s_texColor, 0);
+#define SAMPLE_SPRITE(_uv, _layer) texture2D(s_texColor, _uv)
+#endif
+
+void main()
+{
+    vec4 texColor = SAMPLE_SPRITE(v_texcoord0, floor(v_texlayer + 0.5));
+    gl_FragColor = texColor * v_color0;
+}
@@ -0,0 +1,15 @@
+$input v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_texColor, 0);
+
+void main()
+{
+    // The red channel holds a signed distance field with the glyph edge at 128 / 255.
+    // The smoothing width follows the screen space rate of change, so edges stay about one pixel wide at any scale
+    float distance = texture2D(s_texColor, v_texcoord0).r;
+    float width = max(fwidth(distance) * 0.7, 0.001);
+    float alpha = smoothstep(128.0 / 255.0 - width, 128.0 / 255.0 + width, distance);
+    gl_FragColor = vec4(v_color0.rgb, v_color0.a * alpha);
+}
@@ -0,0 +1,18 @@
+$input a_position, a_texcoord0, a_color0
+$output v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+// xyz: batch origin, w: world units per quantization step
+uniform vec4 u_compactOrigin;
+
+// a_position is a normalized int16, so one step is 1 / 32767
+#define COMPACT_RANGE 32767.0
+
+void main()
+{
+    vec3 position = u_compactOrigin.xyz + a_position.xyz * (u_compactOrigin.w * COMPACT_RANGE);
+    gl_Position = mul(u_proj, mul(u_view, mul(u_model[0], vec4(position, 1.0))));
+    v_texcoord0 = a_texcoord0;
+    v_color0 = a_color0;
+}
@@ -0,0 +1,17 @@
+$input a_position, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+// a_position is a corner of the unit quad, everything else comes from the instance:
+// i_data0 = 2x2 affine (x axis, y axis), i_data1 = translation xyz + texture layer,
+// i_data2 = UV rect (x, y, w, h), i_data3 = color
+void main()
+{
+    vec2 corner = a_position.xy;
+    vec3 world = vec3(i_data0.xy * corner.x + i_data0.zw * corner.y, 0.0) + i_data1.xyz;
+
+    gl_Position = mul(u_viewProj, vec4(world, 1.0));
+    v_texcoord0 = i_data2.xy + i_data2.zw * a_texcoord0;
+    v_color0 = i_data3;
+}
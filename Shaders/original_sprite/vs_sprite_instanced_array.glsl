@@ -0,0 +1,16 @@
+$input a_position, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_texcoord0, v_color0, v_texlayer
+
+#include <bgfx_shader.sh>
+
+// Same instance layout as vs_sprite_instanced, i_data1.w selects the texture array layer
+void main()
+{
+    vec2 corner = a_position.xy;
+    vec3 world = vec3(i_data0.xy * corner.x + i_data0.zw * corner.y, 0.0) + i_data1.xyz;
+
+    gl_Position = mul(u_viewProj, vec4(world, 1.0));
+    v_texcoord0 = i_data2.xy + i_data2.zw * a_texcoord0;
+    v_color0 = i_data3;
+    v_texlayer = i_data1.w;
+}
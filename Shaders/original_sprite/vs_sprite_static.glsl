@@ -0,0 +1,14 @@
+$input a_position, a_texcoord0, a_color0
+$output v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+// Material color of the draw, resident buffers keep the authored vertex colors
+uniform vec4 u_tint;
+
+void main()
+{
+    gl_Position = mul(u_proj, mul(u_view, mul(u_model[0], vec4(a_position, 1.0))));
+    v_texcoord0 = a_texcoord0;
+    v_color0 = a_color0 * u_tint;
+}